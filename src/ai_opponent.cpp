@@ -0,0 +1,197 @@
+#include "ai_opponent.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace
+{
+// Pause before each of the computer's picks, so a player can follow them.
+constexpr float kThinkSeconds = 0.55F;
+
+// Search time per position, and the slice after which the search thread
+// publishes what it has and looks for a newer position.
+constexpr std::chrono::milliseconds kSearchBudget{5};
+constexpr std::chrono::microseconds kSearchSlice{1000};
+
+// Positions are packed as pairs << 20 | known singles; a board holds fewer
+// than 2^20 pairs. 0 means none, and the all-ones value stops the thread.
+constexpr unsigned int kKnownBits = 20U;
+constexpr std::uint64_t kKnownMask = (std::uint64_t{1} << kKnownBits) - 1U;
+constexpr std::uint64_t kStopRequest = ~std::uint64_t{0};
+
+constexpr std::uint64_t kOpenWithKnown = 1U << 1U;
+constexpr std::uint64_t kSecondPickKnown = 1U << 0U;
+} // namespace
+
+AiOpponent::AiOpponent(memory::BeliefSettings settings, std::uint32_t seed) :
+    belief_(settings),
+    random_(seed),
+    thread_([this] { searchLoop(); })
+{
+}
+
+AiOpponent::~AiOpponent()
+{
+    request_.store(kStopRequest, std::memory_order_release);
+    request_.notify_one();
+    thread_.join();
+}
+
+void AiOpponent::reset(const memory::BoardState& board)
+{
+    belief_.reset(board);
+    thinkRemaining_ = kThinkSeconds;
+    plannedSecond_ = -1;
+    turnPolicy_ = memory::SolverPolicy{};
+    post();
+}
+
+void AiOpponent::observe(const memory::BoardState& board, int index)
+{
+    belief_.observe(board, index);
+}
+
+int AiOpponent::update(const memory::BoardState& board, bool ourTurn, float deltaSeconds)
+{
+    if (board.won || board.pairPhase != memory::PairPhase::Idle)
+    {
+        return -1;
+    }
+    if (board.firstSelected < 0)
+    {
+        post();
+    }
+    if (!ourTurn)
+    {
+        thinkRemaining_ = kThinkSeconds;
+        return -1;
+    }
+
+    thinkRemaining_ -= deltaSeconds;
+    if (thinkRemaining_ > 0.0F)
+    {
+        return -1;
+    }
+    thinkRemaining_ = kThinkSeconds;
+    return board.firstSelected < 0 ? chooseFirst(board) : chooseSecond(board);
+}
+
+int AiOpponent::chooseFirst(const memory::BoardState& board)
+{
+    turnPolicy_ = answer();
+
+    // A fully remembered pair is always worth taking, if the memory holds.
+    plannedSecond_ = -1;
+    int first = -1;
+    int second = -1;
+    while (belief_.knownPair(first, second))
+    {
+        if (belief_.recall(first, random_) && belief_.recall(second, random_))
+        {
+            plannedSecond_ = second;
+            return first;
+        }
+    }
+
+    if (turnPolicy_.openWithKnown)
+    {
+        turnPolicy_.secondPickKnown = false;
+        const int single = belief_.freshestSingle(board);
+        if (single >= 0 && belief_.recall(single, random_))
+        {
+            return single;
+        }
+    }
+    return belief_.randomUnknown(board, random_);
+}
+
+int AiOpponent::chooseSecond(const memory::BoardState& board)
+{
+    if (plannedSecond_ >= 0 && memory::canPick(board, plannedSecond_))
+    {
+        return std::exchange(plannedSecond_, -1);
+    }
+    plannedSecond_ = -1;
+
+    const int partner = belief_.knownPartner(board.firstSelected);
+    if (partner >= 0 && memory::canPick(board, partner) && belief_.recall(partner, random_))
+    {
+        return partner;
+    }
+
+    if (turnPolicy_.secondPickKnown)
+    {
+        // Spends the turn on a card already known rather than revealing a new one.
+        const int single = belief_.freshestSingle(board);
+        if (single >= 0)
+        {
+            return single;
+        }
+    }
+    return belief_.randomUnknown(board, random_);
+}
+
+void AiOpponent::post()
+{
+    const std::uint64_t pairs = static_cast<std::uint64_t>(belief_.unknownPairs());
+    const std::uint64_t known = static_cast<std::uint64_t>(belief_.knownSingles());
+    const std::uint64_t position = pairs == 0U ? 0U : (pairs << kKnownBits) | known;
+    if (position != posted_)
+    {
+        posted_ = position;
+        request_.store(position, std::memory_order_release);
+        request_.notify_one();
+    }
+}
+
+memory::SolverPolicy AiOpponent::answer() const
+{
+    const std::uint64_t answer = answer_.load(std::memory_order_acquire);
+    memory::SolverPolicy policy;
+    if (posted_ != 0U && (answer >> 2U) == posted_)
+    {
+        policy.openWithKnown = (answer & kOpenWithKnown) != 0U;
+        policy.secondPickKnown = (answer & kSecondPickKnown) != 0U;
+    }
+    return policy;
+}
+
+void AiOpponent::searchLoop()
+{
+    using Clock = memory::OpponentSearch::Clock;
+
+    std::uint64_t searched = 0;
+    for (;;)
+    {
+        request_.wait(searched, std::memory_order_acquire);
+        const std::uint64_t position = request_.load(std::memory_order_acquire);
+        if (position == kStopRequest)
+        {
+            return;
+        }
+        searched = position;
+        if (position == 0U)
+        {
+            continue;
+        }
+
+        const int pairs = static_cast<int>(position >> kKnownBits);
+        const int known = static_cast<int>(position & kKnownMask);
+        const Clock::time_point budgetEnd = Clock::now() + kSearchBudget;
+        bool exact = false;
+        while (!exact && request_.load(std::memory_order_relaxed) == position)
+        {
+            const Clock::time_point now = Clock::now();
+            if (now >= budgetEnd)
+            {
+                break;
+            }
+            exact = search_.search(pairs, known, std::min<Clock::time_point>(now + kSearchSlice, budgetEnd));
+            const memory::SolverPolicy& policy = search_.policy();
+            answer_.store((position << 2U) | (policy.openWithKnown ? kOpenWithKnown : 0U) |
+                              (policy.secondPickKnown ? kSecondPickKnown : 0U),
+                          std::memory_order_release);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/belief_state.hpp"
+#include "core/memory_rules.hpp"
+#include "core/opponent_search.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+
+// The computer seat of a versus game. The simulation thread keeps its memory
+// of the board and decides each pick; an OpponentSearch on a thread of its
+// own ranks the choices. Each position is searched for a few milliseconds
+// in short slices, starting as soon as the position arises (so usually
+// during the other seat's turn) and picking up a new position between
+// slices. The simulation thread never waits on it: a pick made before an
+// answer arrives plays the greedy policy.
+class AiOpponent
+{
+public:
+    AiOpponent(memory::BeliefSettings settings, std::uint32_t seed);
+    ~AiOpponent();
+
+    AiOpponent(const AiOpponent&) = delete;
+    AiOpponent& operator=(const AiOpponent&) = delete;
+
+    void reset(const memory::BoardState& board);
+
+    // Called after every accepted pick, by either seat.
+    void observe(const memory::BoardState& board, int index);
+
+    // Called every tick. Keeps the search on the current position and, on
+    // the computer's turn, returns the slot to pick once it has taken its
+    // time to "think"; -1 otherwise.
+    int update(const memory::BoardState& board, bool ourTurn, float deltaSeconds);
+
+private:
+    int chooseFirst(const memory::BoardState& board);
+    int chooseSecond(const memory::BoardState& board);
+    void post();
+    memory::SolverPolicy answer() const;
+    void searchLoop();
+
+    // Simulation thread.
+    memory::BeliefState belief_;
+    std::mt19937 random_;
+    float thinkRemaining_ = 0.0F;
+    int plannedSecond_ = -1;
+    memory::SolverPolicy turnPolicy_; // chosen with the first pick, followed by the second
+    std::uint64_t posted_ = 0;
+
+    // Search thread, apart from the two mailboxes: the position to search,
+    // and the best policy found so far tagged with the position it is for.
+    memory::OpponentSearch search_;
+    std::atomic<std::uint64_t> request_{0};
+    std::atomic<std::uint64_t> answer_{0};
+    std::thread thread_;
+};
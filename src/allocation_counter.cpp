@@ -0,0 +1,73 @@
+#include "allocation_counter.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace
+{
+// Iterations that may still size buffers for the first time.
+constexpr std::uint64_t kWarmupIterations = 120;
+
+// Constant-initialised, so operator new can use it before any static init.
+thread_local std::uint64_t allocationCount = 0;
+
+void* allocate(std::size_t size)
+{
+    ++allocationCount;
+    if (void* memory = std::malloc(size == 0U ? 1U : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+std::uint64_t threadAllocationCount()
+{
+    return allocationCount;
+}
+
+void SteadyStateAllocationCheck::report(bool steady, std::uint64_t allocations)
+{
+    ++iterations_;
+    if (!steady || iterations_ <= kWarmupIterations || allocations == 0U)
+    {
+        return;
+    }
+
+    std::cerr << "Warning: " << loopName_ << " made " << allocations
+              << " heap allocations in a steady-state iteration\n";
+    assert(allocations == 0U && "steady-state iterations must not allocate");
+}
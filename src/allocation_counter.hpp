@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+// Heap allocations made so far by the calling thread, counted by the global
+// operator new that allocation_counter.cpp replaces.
+std::uint64_t threadAllocationCount();
+
+// Debug-build check that the steady-state iterations of a loop never reach
+// the allocator. Iterations the caller reports as unsteady (resizes, text
+// that changed, arriving assets) and the first few after startup are exempt;
+// release builds compile the check away.
+class SteadyStateAllocationCheck
+{
+public:
+    explicit SteadyStateAllocationCheck(const char* loopName) : loopName_(loopName) {}
+
+    void begin()
+    {
+#ifndef NDEBUG
+        start_ = threadAllocationCount();
+#endif
+    }
+
+    void end(bool steady)
+    {
+#ifndef NDEBUG
+        report(steady, threadAllocationCount() - start_);
+#else
+        (void)steady;
+#endif
+    }
+
+private:
+    void report(bool steady, std::uint64_t allocations);
+
+    const char* loopName_;
+    std::uint64_t start_ = 0;
+    std::uint64_t iterations_ = 0;
+};
@@ -0,0 +1,189 @@
+#include "assets/downloader.hpp"
+
+#ifdef MEMORY_ASSETS_HAVE_CURL
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#endif
+
+#ifndef MEMORY_ASSETS_HAVE_CURL
+bool downloadsAvailable()
+{
+    return false;
+}
+
+std::vector<DownloadResult> downloadAll(const std::vector<DownloadRequest>& requests, const DownloadOptions&)
+{
+    std::vector<DownloadResult> results(requests.size());
+    for (DownloadResult& result : results)
+    {
+        result.error = "built without libcurl";
+    }
+    return results;
+}
+#else
+namespace
+{
+constexpr const char* kUserAgent = "MemoryGameAssetFetcher/1.0";
+
+// One easy handle per concurrent transfer, reused for the next request once
+// its current one finishes.
+struct Transfer
+{
+    CURL* easy = nullptr;
+    std::size_t request = 0;
+    std::string body;
+    std::array<char, CURL_ERROR_SIZE> error{};
+};
+
+std::size_t appendBody(char* data, std::size_t size, std::size_t count, void* user)
+{
+    static_cast<Transfer*>(user)->body.append(data, size * count);
+    return size * count;
+}
+
+void start(CURLM* multi, Transfer& transfer, const DownloadRequest& request, std::size_t index, const DownloadOptions& options)
+{
+    transfer.request = index;
+    transfer.body.clear();
+    transfer.error[0] = '\0';
+    curl_easy_setopt(transfer.easy, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(transfer.easy, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(transfer.easy, CURLOPT_USERAGENT, kUserAgent);
+    curl_easy_setopt(transfer.easy, CURLOPT_TIMEOUT, options.timeoutSeconds);
+    curl_easy_setopt(transfer.easy, CURLOPT_ACCEPT_ENCODING, "");
+    curl_easy_setopt(transfer.easy, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+    // Wait for a connection that can multiplex rather than opening another.
+    curl_easy_setopt(transfer.easy, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(transfer.easy, CURLOPT_WRITEFUNCTION, appendBody);
+    curl_easy_setopt(transfer.easy, CURLOPT_WRITEDATA, &transfer);
+    curl_easy_setopt(transfer.easy, CURLOPT_ERRORBUFFER, transfer.error.data());
+    curl_easy_setopt(transfer.easy, CURLOPT_PRIVATE, &transfer);
+    curl_multi_add_handle(multi, transfer.easy);
+}
+
+DownloadResult finish(Transfer& transfer, CURLcode code, const DownloadRequest& request)
+{
+    DownloadResult result;
+    if (code != CURLE_OK)
+    {
+        result.error = transfer.error[0] != '\0' ? transfer.error.data() : curl_easy_strerror(code);
+        return result;
+    }
+
+    long status = 0;
+    char* contentType = nullptr;
+    curl_easy_getinfo(transfer.easy, CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_getinfo(transfer.easy, CURLINFO_CONTENT_TYPE, &contentType);
+    if (status != 200)
+    {
+        result.error = "HTTP status " + std::to_string(status);
+        return result;
+    }
+    if (contentType == nullptr || std::string_view(contentType).find("image") == std::string_view::npos)
+    {
+        result.error = "URL does not look like an image (Content-Type: " + std::string(contentType != nullptr ? contentType : "") + ")";
+        return result;
+    }
+
+    std::filesystem::path partial = request.destination;
+    partial += ".part";
+    {
+        std::ofstream stream(partial, std::ios::binary | std::ios::trunc);
+        stream.write(transfer.body.data(), static_cast<std::streamsize>(transfer.body.size()));
+        if (!stream)
+        {
+            result.error = "cannot write " + partial.string();
+            return result;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(partial, request.destination, error);
+    if (error)
+    {
+        result.error = "cannot write " + request.destination.string() + ": " + error.message();
+        return result;
+    }
+    result.ok = true;
+    result.bytes = transfer.body.size();
+    return result;
+}
+} // namespace
+
+bool downloadsAvailable()
+{
+    return true;
+}
+
+std::vector<DownloadResult> downloadAll(const std::vector<DownloadRequest>& requests, const DownloadOptions& options)
+{
+    std::vector<DownloadResult> results(requests.size());
+    if (requests.empty())
+    {
+        return results;
+    }
+
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    CURLM* multi = curl_multi_init();
+    const long connections = static_cast<long>(std::max(1U, options.connections));
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, connections);
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, connections);
+
+    std::vector<Transfer> transfers(std::min(requests.size(), static_cast<std::size_t>(connections)));
+    std::size_t next = 0;
+    std::size_t active = 0;
+    for (Transfer& transfer : transfers)
+    {
+        transfer.easy = curl_easy_init();
+        start(multi, transfer, requests[next], next, options);
+        ++next;
+        ++active;
+    }
+
+    while (active > 0U)
+    {
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &queued))
+        {
+            if (message->msg != CURLMSG_DONE)
+            {
+                continue;
+            }
+            Transfer* transfer = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &transfer);
+            const CURLcode code = message->data.result;
+            curl_multi_remove_handle(multi, transfer->easy);
+            results[transfer->request] = finish(*transfer, code, requests[transfer->request]);
+            --active;
+
+            if (next < requests.size())
+            {
+                start(multi, *transfer, requests[next], next, options);
+                ++next;
+                ++active;
+            }
+        }
+
+        if (active > 0U)
+        {
+            curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+        }
+    }
+
+    for (Transfer& transfer : transfers)
+    {
+        curl_easy_cleanup(transfer.easy);
+    }
+    curl_multi_cleanup(multi);
+    curl_global_cleanup();
+    return results;
+}
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct DownloadRequest
+{
+    std::string url;
+    std::filesystem::path destination;
+};
+
+struct DownloadResult
+{
+    bool ok = false;
+    std::size_t bytes = 0;
+    std::string error;
+};
+
+struct DownloadOptions
+{
+    unsigned int connections = 8;
+    long timeoutSeconds = 20;
+};
+
+// True when built with libcurl; otherwise downloadAll() fails every request.
+bool downloadsAvailable();
+
+// Fetches every request with at most `connections` transfers in flight, all
+// on one thread. Transfers share libcurl's connection cache, so requests to
+// the same host reuse warm connections (and multiplex over HTTP/2 where the
+// server allows). Only responses with an image content type are kept; each
+// goes to a temporary file that is renamed over `destination` once complete.
+// Returns one result per request, in request order.
+std::vector<DownloadResult> downloadAll(const std::vector<DownloadRequest>& requests, const DownloadOptions& options);
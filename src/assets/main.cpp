@@ -0,0 +1,440 @@
+#include "assets/downloader.hpp"
+#include "core/asset_pack.hpp"
+#include "core/card_manifest.hpp"
+#include "core/pixel_art.hpp"
+#include "pack/pack_contents.hpp"
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr const char* kCacheName = ".memory_assets_cache";
+constexpr std::string_view kCacheHeader = "memory_assets 1";
+constexpr std::array<std::string_view, 4> kSourceExtensions{{".png", ".jpg", ".jpeg", ".webp"}};
+
+struct Options
+{
+    fs::path root = ".";
+    memory::PixelArtSettings art;
+    unsigned int threads = 0; // 0: one per hardware thread
+    DownloadOptions download;
+    bool fetch = true;
+    bool force = false;
+    std::optional<fs::path> packPath;
+};
+
+void printUsage()
+{
+    std::cout <<
+        "Downloads the card art listed in assets/manifest/sources.json into\n"
+        "assets/source, then turns every card in assets/manifest/cards.json into\n"
+        "pixel art under assets/processed, one card per core.\n"
+        "\n"
+        "Usage:\n"
+        "  memory_assets [--root DIR] [--height PX] [--pixel-height PX] [--colors N]\n"
+        "                [--threads N] [--connections N] [--timeout SECONDS]\n"
+        "                [--no-download] [--force] [--pack FILE]\n"
+        "\n"
+        "Sources that already exist are not downloaded again, and a card whose\n"
+        "source and settings hash the same as last time is skipped without touching\n"
+        "its processed file. --force redoes both. --pack also writes the runtime pack\n"
+        "straight from the processed tiles, as memory_pack would.\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string_view argument = argv[index];
+        const bool hasValue = index + 1 < argc;
+
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage();
+            return false;
+        }
+        if (argument == "--root" && hasValue)
+        {
+            options.root = argv[++index];
+        }
+        else if (argument == "--height" && hasValue)
+        {
+            options.art.height = static_cast<unsigned int>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--pixel-height" && hasValue)
+        {
+            options.art.pixelHeight = static_cast<unsigned int>(std::stoul(argv[++index]));
+        }
+        else if ((argument == "--colors" || argument == "--quantize") && hasValue)
+        {
+            options.art.colors = static_cast<unsigned int>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--threads" && hasValue)
+        {
+            options.threads = static_cast<unsigned int>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--connections" && hasValue)
+        {
+            options.download.connections = static_cast<unsigned int>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--timeout" && hasValue)
+        {
+            options.download.timeoutSeconds = std::stol(argv[++index]);
+        }
+        else if (argument == "--no-download")
+        {
+            options.fetch = false;
+        }
+        else if (argument == "--force")
+        {
+            options.force = true;
+        }
+        else if (argument == "--pack" && hasValue)
+        {
+            options.packPath = fs::path(argv[++index]);
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option: " << argument << "\n";
+            printUsage();
+            return false;
+        }
+    }
+
+    if (!memory::isValidPixelArtSettings(options.art))
+    {
+        std::cerr << "Expected --height >= --pixel-height > 0 and --colors within 2..256\n";
+        return false;
+    }
+    return true;
+}
+
+std::optional<fs::path> findSource(const fs::path& directory, const std::string& slug)
+{
+    for (const std::string_view extension : kSourceExtensions)
+    {
+        fs::path candidate = directory / (slug + std::string(extension));
+        if (fs::exists(candidate))
+        {
+            return candidate;
+        }
+    }
+    return std::nullopt;
+}
+
+// Keeps the URL's image extension (anything else is saved as .jpg).
+fs::path sourcePath(const fs::path& directory, const std::string& slug, std::string_view url)
+{
+    std::string_view path = url.substr(0, url.find_first_of("?#"));
+    path = path.substr(path.find_last_of('/') + 1U);
+    std::string extension(fs::path(path).extension().string());
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (std::find(kSourceExtensions.begin(), kSourceExtensions.end(), extension) == kSourceExtensions.end())
+    {
+        extension = ".jpg";
+    }
+    return directory / (slug + extension);
+}
+
+// Returns false if any download failed.
+bool downloadSources(const Options& options, std::size_t& downloaded)
+{
+    const fs::path sourcesPath = options.root / "assets/manifest/sources.json";
+    std::string error;
+    const std::optional<std::vector<memory::SourceManifestEntry>> sources = memory::readSourceManifest(sourcesPath, error);
+    if (!sources)
+    {
+        std::cerr << "Warning: " << error << "; nothing downloaded.\n";
+        return true;
+    }
+
+    const fs::path directory = options.root / "assets/source";
+    fs::create_directories(directory);
+    std::vector<DownloadRequest> requests;
+    std::vector<const memory::SourceManifestEntry*> entries;
+    for (const memory::SourceManifestEntry& entry : *sources)
+    {
+        if (entry.url.empty() || (!options.force && findSource(directory, entry.slug)))
+        {
+            continue;
+        }
+        requests.push_back(DownloadRequest{entry.url, sourcePath(directory, entry.slug, entry.url)});
+        entries.push_back(&entry);
+    }
+    if (requests.empty())
+    {
+        return true;
+    }
+    if (!downloadsAvailable())
+    {
+        std::cerr << "Warning: built without libcurl, skipping " << requests.size() << " downloads.\n";
+        return true;
+    }
+
+    const std::vector<DownloadResult> results = downloadAll(requests, options.download);
+    bool ok = true;
+    for (std::size_t index = 0; index < results.size(); ++index)
+    {
+        if (results[index].ok)
+        {
+            std::cout << "Downloaded " << entries[index]->name << " -> " << requests[index].destination.string() << "\n";
+            ++downloaded;
+        }
+        else
+        {
+            std::cerr << "Failed " << entries[index]->slug << ": " << results[index].error << "\n";
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+std::map<std::string, std::uint64_t> readCache(const fs::path& path)
+{
+    std::map<std::string, std::uint64_t> cache;
+    std::ifstream stream(path);
+    std::string line;
+    if (!std::getline(stream, line) || line != kCacheHeader)
+    {
+        return cache;
+    }
+    std::string slug;
+    std::string hash;
+    while (stream >> slug >> hash)
+    {
+        cache[slug] = std::stoull(hash, nullptr, 16);
+    }
+    return cache;
+}
+
+bool writeCache(const fs::path& path, const std::map<std::string, std::uint64_t>& cache)
+{
+    std::ofstream stream(path, std::ios::trunc);
+    stream << kCacheHeader << "\n";
+    std::array<char, 17> hex{};
+    for (const auto& [slug, hash] : cache)
+    {
+        std::snprintf(hex.data(), hex.size(), "%016llx", static_cast<unsigned long long>(hash));
+        stream << slug << " " << hex.data() << "\n";
+    }
+    return static_cast<bool>(stream);
+}
+
+enum class Outcome
+{
+    Processed,
+    Unchanged,
+    MissingSource,
+    Failed
+};
+
+struct CardJob
+{
+    const memory::CardManifestEntry* card = nullptr;
+    std::optional<std::uint64_t> cachedHash;
+    Outcome outcome = Outcome::Failed;
+    std::uint64_t hash = 0;
+    std::string detail;
+    memory::RgbaImage tile; // kept for --pack; empty when unchanged
+};
+
+// Everything that decides a processed tile's pixels goes into its hash.
+std::uint64_t settingsHash(const memory::PixelArtSettings& settings)
+{
+    return memory::contentHash(
+        std::to_string(settings.height) + "/" + std::to_string(settings.pixelHeight) + "/" + std::to_string(settings.colors));
+}
+
+void processCard(const Options& options, std::uint64_t seed, CardJob& job)
+{
+    const std::optional<fs::path> source = findSource(options.root / "assets/source", job.card->slug);
+    if (!source)
+    {
+        job.outcome = Outcome::MissingSource;
+        return;
+    }
+
+    std::ifstream stream(*source, std::ios::binary);
+    const std::vector<std::uint8_t> bytes{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+    job.hash = memory::contentHash(bytes, seed);
+    const fs::path destination = options.root / job.card->processed;
+    if (!options.force && job.cachedHash == job.hash && fs::exists(destination))
+    {
+        job.outcome = Outcome::Unchanged;
+        return;
+    }
+
+    sf::Image image;
+    if (!image.loadFromMemory(bytes.data(), bytes.size()))
+    {
+        job.detail = "cannot decode " + source->string();
+        return;
+    }
+    const sf::Vector2u size = image.getSize();
+    job.tile = memory::makePixelArt(image.getPixelsPtr(), size.x, size.y, options.art);
+    const sf::Image processed(sf::Vector2u(job.tile.width, job.tile.height), job.tile.pixels.data());
+    if (!processed.saveToFile(destination))
+    {
+        job.detail = "cannot write " + destination.string();
+        return;
+    }
+    job.outcome = Outcome::Processed;
+    job.detail = destination.string();
+}
+
+bool writePack(const Options& options, const fs::path& manifestPath, const std::vector<CardJob>& jobs)
+{
+    memory::AssetPackWriter writer;
+    addPackManifest(writer, manifestPath);
+    std::size_t imageCount = 0;
+    if (addPackImageFile(writer, "card_back", options.root / "assets/processed/card_back.png"))
+    {
+        ++imageCount;
+    }
+    for (const CardJob& job : jobs)
+    {
+        if (!job.tile.pixels.empty())
+        {
+            addPackImage(writer, job.card->slug, job.tile.width, job.tile.height, job.tile.pixels);
+            ++imageCount;
+        }
+        else if (addPackImageFile(writer, job.card->slug, options.root / job.card->processed))
+        {
+            ++imageCount;
+        }
+    }
+    const bool fontPacked = addPackFont(writer, options.root);
+
+    std::string error;
+    if (!writer.write(*options.packPath, error))
+    {
+        std::cerr << "Error: " << error << "\n";
+        return false;
+    }
+    std::cout << "Wrote " << options.packPath->string() << ": " << imageCount << " images"
+              << (fontPacked ? ", 1 font" : ", no font") << "\n";
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        if (!parseOptions(argc, argv, options))
+        {
+            return 1;
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "Invalid option value: " << error.what() << "\n";
+        return 1;
+    }
+
+    std::size_t downloaded = 0;
+    bool ok = !options.fetch || downloadSources(options, downloaded);
+
+    const fs::path manifestPath = options.root / "assets/manifest/cards.json";
+    std::string error;
+    const std::optional<memory::CardManifest> manifest = memory::readCardManifest(manifestPath, error);
+    if (!manifest)
+    {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+
+    const fs::path processedDirectory = options.root / "assets/processed";
+    fs::create_directories(processedDirectory);
+    std::map<std::string, std::uint64_t> cache = readCache(processedDirectory / kCacheName);
+
+    std::vector<CardJob> jobs(manifest->cards.size());
+    for (std::size_t index = 0; index < jobs.size(); ++index)
+    {
+        jobs[index].card = &manifest->cards[index];
+        if (const auto cached = cache.find(jobs[index].card->slug); cached != cache.end())
+        {
+            jobs[index].cachedHash = cached->second;
+        }
+    }
+
+    // Decoding dominates, so cards are claimed one at a time from a shared
+    // counter; each job writes only its own slot.
+    const std::uint64_t seed = settingsHash(options.art);
+    unsigned int threadCount = options.threads > 0U ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned int>(std::clamp<std::size_t>(jobs.size(), 1U, threadCount));
+    std::atomic<std::size_t> next{0};
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(threadCount);
+        for (unsigned int worker = 0; worker < threadCount; ++worker)
+        {
+            workers.emplace_back([&]
+            {
+                for (std::size_t index = next.fetch_add(1U); index < jobs.size(); index = next.fetch_add(1U))
+                {
+                    processCard(options, seed, jobs[index]);
+                }
+            });
+        }
+    }
+
+    std::size_t processed = 0;
+    std::size_t unchanged = 0;
+    std::size_t failed = 0;
+    for (const CardJob& job : jobs)
+    {
+        switch (job.outcome)
+        {
+            case Outcome::Processed:
+                std::cout << "Processed " << job.card->name << " -> " << job.detail << "\n";
+                cache[job.card->slug] = job.hash;
+                ++processed;
+                break;
+            case Outcome::Unchanged:
+                ++unchanged;
+                break;
+            case Outcome::MissingSource:
+                std::cerr << "Missing source image for " << job.card->slug << " in " << (options.root / "assets/source").string() << "\n";
+                ++failed;
+                break;
+            case Outcome::Failed:
+                std::cerr << "Failed to process " << job.card->slug << ": " << job.detail << "\n";
+                ++failed;
+                break;
+        }
+    }
+    if (processed > 0U && !writeCache(processedDirectory / kCacheName, cache))
+    {
+        std::cerr << "Warning: cannot write " << (processedDirectory / kCacheName).string() << "\n";
+    }
+
+    if (options.packPath && !writePack(options, manifestPath, jobs))
+    {
+        ok = false;
+    }
+
+    std::cout << "\nDone. downloaded=" << downloaded << " processed=" << processed << " unchanged=" << unchanged
+              << " failed=" << failed << "\n";
+    return ok && failed == 0U ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+#include "async_image_loader.hpp"
+
+#include "core/texture_tiers.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+AsyncImageLoader::AsyncImageLoader(std::vector<ImageLoadRequest> requests, unsigned int workerCount) :
+    requests_(std::move(requests))
+{
+    if (workerCount == 0U)
+    {
+        workerCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    workerCount = std::min(workerCount, static_cast<unsigned int>(requests_.size()));
+
+    ready_.reserve(requests_.size());
+    workers_.reserve(workerCount);
+    for (unsigned int worker = 0; worker < workerCount; ++worker)
+    {
+        workers_.emplace_back([this](const std::stop_token& stopToken)
+        {
+            workerLoop(stopToken);
+        });
+    }
+}
+
+void AsyncImageLoader::poll(std::vector<ImageLoadResult>& out)
+{
+    const std::lock_guard lock(readyMutex_);
+    delivered_ += ready_.size();
+    std::move(ready_.begin(), ready_.end(), std::back_inserter(out));
+    ready_.clear();
+}
+
+bool AsyncImageLoader::finished() const
+{
+    return delivered_ >= requests_.size();
+}
+
+void AsyncImageLoader::workerLoop(const std::stop_token& stopToken)
+{
+    while (!stopToken.stop_requested())
+    {
+        const std::size_t index = nextRequest_.fetch_add(1U, std::memory_order_relaxed);
+        if (index >= requests_.size())
+        {
+            return;
+        }
+
+        const ImageLoadRequest& request = requests_[index];
+        ImageLoadResult result;
+        result.id = request.id;
+        result.path = request.path;
+
+        std::error_code error;
+        result.fileFound = std::filesystem::exists(request.path, error);
+        if (result.fileFound)
+        {
+            sf::Image image;
+            if (image.loadFromFile(request.path))
+            {
+                const sf::Vector2u size = image.getSize();
+                result.sourceHeight = size.y;
+                const unsigned int divisor = request.displayHeight > 0.0F
+                    ? memory::chooseTextureDivisor(size.y, request.displayHeight)
+                    : 1U;
+                if (divisor > 1U)
+                {
+                    const memory::RgbaImage tier = memory::downsampleRgba(image.getPixelsPtr(), size.x, size.y, divisor);
+                    image = sf::Image(sf::Vector2u(tier.width, tier.height), tier.pixels.data());
+                }
+                result.image = std::move(image);
+            }
+        }
+
+        const std::lock_guard lock(readyMutex_);
+        ready_.push_back(std::move(result));
+    }
+}
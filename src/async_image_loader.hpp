@@ -0,0 +1,61 @@
+#pragma once
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+// Decodes image files to sf::Image on a small worker pool. Only CPU-side
+// decoding happens off-thread; texture upload stays with the caller, which
+// collects finished images with poll() from its own (GL) thread.
+struct ImageLoadRequest
+{
+    int id = 0;
+    std::filesystem::path path;
+    // Height the image is drawn at; the decoded image is reduced to the
+    // matching memory::kTextureTierDivisors tier. 0 keeps the full size.
+    float displayHeight = 0.0F;
+};
+
+struct ImageLoadResult
+{
+    int id = 0;
+    std::filesystem::path path;
+    bool fileFound = false;
+    std::optional<sf::Image> image;
+    unsigned int sourceHeight = 0; // before any tier reduction
+};
+
+class AsyncImageLoader
+{
+public:
+    // `workerCount` of 0 uses one worker per hardware thread, capped by the request count.
+    explicit AsyncImageLoader(std::vector<ImageLoadRequest> requests, unsigned int workerCount = 0U);
+
+    AsyncImageLoader(const AsyncImageLoader&) = delete;
+    AsyncImageLoader& operator=(const AsyncImageLoader&) = delete;
+
+    // Moves every result finished since the last call into `out`. Never blocks on decoding.
+    void poll(std::vector<ImageLoadResult>& out);
+
+    // True once every request has been handed out through poll().
+    bool finished() const;
+
+private:
+    void workerLoop(const std::stop_token& stopToken);
+
+    std::vector<ImageLoadRequest> requests_;
+    std::atomic<std::size_t> nextRequest_{0};
+    std::mutex readyMutex_;
+    std::vector<ImageLoadResult> ready_;
+    std::size_t delivered_ = 0;
+
+    // Declared last so workers are stopped and joined before the queues they use go away.
+    std::vector<std::jthread> workers_;
+};
@@ -0,0 +1,547 @@
+#include "core/memory_players.hpp"
+#include "core/memory_rules.hpp"
+#include "core/pixel_art.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr int kMaxMovesPerGame = 100000;
+constexpr std::uint64_t kGamesPerChunk = 256;
+
+struct Options
+{
+    std::uint64_t games = 10000; // per board, reveal time and player
+    std::uint32_t seed = 1;
+    unsigned int threads = 0; // 0: one per hardware thread
+    std::vector<std::string> players{"random", "perfect", "bounded"};
+    std::vector<memory::BoardConfig> boards{memory::BoardConfig{}};
+    std::vector<float> reveals{memory::kRevealDurationSeconds};
+    int characters = 0; // 0: one character per pair
+    std::optional<fs::path> jsonPath;
+    std::optional<fs::path> csvPath;
+};
+
+struct Job
+{
+    memory::BoardConfig config;
+    std::string player;
+    std::uint64_t seedKey = 0; // configurationKey()
+};
+
+struct GameResult
+{
+    int moves = -1; // -1: not finished within kMaxMovesPerGame
+    float seconds = 0.0F;
+};
+
+// Every game owns one slot, so workers write results without sharing any;
+// only the finished count is combined, with an atomic add.
+struct JobResults
+{
+    std::vector<GameResult> games;
+    std::atomic<std::uint64_t> finished{0};
+};
+
+struct Chunk
+{
+    std::size_t job = 0;
+    std::uint64_t begin = 0;
+    std::uint64_t end = 0;
+};
+
+// A contiguous run of chunks. The owner and thieves both claim chunks with
+// the same fetch_add, so a chunk is handed out exactly once without locks.
+struct alignas(64) WorkQueue
+{
+    std::atomic<std::size_t> next{0};
+    std::size_t end = 0;
+};
+
+struct Distribution
+{
+    double mean = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    double p10 = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+void printUsage()
+{
+    std::cout <<
+        "Parallel Monte Carlo difficulty benchmark.\n"
+        "\n"
+        "Usage:\n"
+        "  memory_bench [--games N] [--seed S] [--threads N] [--players P,...]\n"
+        "               [--boards COLUMNSxROWS,...] [--reveal SECONDS,...] [--characters N]\n"
+        "               [--json FILE] [--csv FILE]\n"
+        "\n"
+        "Plays N games for every board, reveal time and player (random, perfect,\n"
+        "bounded, bounded:N) across all cores. Game g of a configuration always\n"
+        "uses the same seed, so results do not depend on the thread count or on\n"
+        "which other players, boards and reveal times are in the run.\n";
+}
+
+std::vector<std::string> splitList(std::string_view value)
+{
+    std::vector<std::string> items;
+    std::istringstream stream{std::string(value)};
+    std::string token;
+    while (std::getline(stream, token, ','))
+    {
+        if (!token.empty())
+        {
+            items.push_back(token);
+        }
+    }
+    return items;
+}
+
+bool parseBoards(std::string_view value, std::vector<memory::BoardConfig>& boards)
+{
+    boards.clear();
+    for (const std::string& item : splitList(value))
+    {
+        memory::BoardConfig config;
+        if (!memory::parseBoardSize(item, config.columns, config.rows))
+        {
+            return false;
+        }
+        boards.push_back(config);
+    }
+    return !boards.empty();
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string_view argument = argv[index];
+        const bool hasValue = index + 1 < argc;
+
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage();
+            return false;
+        }
+        if (argument == "--games" && hasValue)
+        {
+            options.games = std::stoull(argv[++index]);
+        }
+        else if (argument == "--seed" && hasValue)
+        {
+            options.seed = static_cast<std::uint32_t>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--threads" && hasValue)
+        {
+            options.threads = static_cast<unsigned int>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--players" && hasValue)
+        {
+            options.players = splitList(argv[++index]);
+        }
+        else if (argument == "--boards" && hasValue)
+        {
+            if (!parseBoards(argv[++index], options.boards))
+            {
+                std::cerr << "Expected --boards COLUMNSxROWS[,...], got: " << argv[index] << "\n";
+                return false;
+            }
+        }
+        else if (argument == "--reveal" && hasValue)
+        {
+            options.reveals.clear();
+            for (const std::string& item : splitList(argv[++index]))
+            {
+                options.reveals.push_back(std::stof(item));
+            }
+        }
+        else if (argument == "--characters" && hasValue)
+        {
+            if (!memory::parsePositiveInt(argv[++index], options.characters))
+            {
+                std::cerr << "Expected --characters N, got: " << argv[index] << "\n";
+                return false;
+            }
+        }
+        else if (argument == "--json" && hasValue)
+        {
+            options.jsonPath = fs::path(argv[++index]);
+        }
+        else if (argument == "--csv" && hasValue)
+        {
+            options.csvPath = fs::path(argv[++index]);
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option: " << argument << "\n";
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Hashes what a configuration plays, so its games do not depend on where it
+// sits in the job list.
+std::uint64_t configurationKey(const memory::BoardConfig& config, std::string_view player)
+{
+    const std::array<std::uint32_t, 4> fields{
+        static_cast<std::uint32_t>(config.columns),
+        static_cast<std::uint32_t>(config.rows),
+        static_cast<std::uint32_t>(config.characterCount),
+        std::bit_cast<std::uint32_t>(config.revealSeconds)};
+    std::array<std::uint8_t, fields.size() * 4U> bytes{};
+    for (std::size_t index = 0; index < bytes.size(); ++index)
+    {
+        bytes[index] = static_cast<std::uint8_t>(fields[index / 4U] >> (8U * (index % 4U)));
+    }
+    return memory::contentHash(bytes, memory::contentHash(player));
+}
+
+void runChunk(const Chunk& chunk, const Job& job, std::uint32_t seed, memory::BoardState& board, memory::Player& player, std::mt19937& random, JobResults& results)
+{
+    std::uint64_t finished = 0;
+    board.config = job.config;
+    for (std::uint64_t game = chunk.begin; game < chunk.end; ++game)
+    {
+        std::seed_seq gameSeed{
+            seed,
+            static_cast<std::uint32_t>(job.seedKey),
+            static_cast<std::uint32_t>(job.seedKey >> 32U),
+            static_cast<std::uint32_t>(game),
+            static_cast<std::uint32_t>(game >> 32U)};
+        random.seed(gameSeed);
+
+        GameResult& result = results.games[game];
+        if (memory::playGame(board, player, random, kMaxMovesPerGame))
+        {
+            result = GameResult{board.moves, board.elapsedSeconds};
+            finished += 1U;
+        }
+    }
+    results.finished.fetch_add(finished, std::memory_order_relaxed);
+}
+
+void workerLoop(
+    std::size_t self,
+    std::vector<WorkQueue>& queues,
+    const std::vector<Chunk>& chunks,
+    const std::vector<Job>& jobs,
+    std::uint32_t seed,
+    std::vector<JobResults>& results)
+{
+    // Per-thread state; players are built once per job and reused across games.
+    memory::BoardState board;
+    std::mt19937 random;
+    std::vector<std::unique_ptr<memory::Player>> players(jobs.size());
+
+    // Own queue first, then steal from the others in turn.
+    for (std::size_t offset = 0; offset < queues.size(); ++offset)
+    {
+        WorkQueue& queue = queues[(self + offset) % queues.size()];
+        for (;;)
+        {
+            const std::size_t index = queue.next.fetch_add(1U, std::memory_order_relaxed);
+            if (index >= queue.end)
+            {
+                break;
+            }
+
+            const Chunk& chunk = chunks[index];
+            std::unique_ptr<memory::Player>& player = players[chunk.job];
+            if (!player)
+            {
+                player = memory::makePlayer(jobs[chunk.job].player);
+            }
+            runChunk(chunk, jobs[chunk.job], seed, board, *player, random, results[chunk.job]);
+        }
+    }
+}
+
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    const std::size_t rank = std::min(
+        sorted.size() - 1U,
+        static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1U) + 0.5));
+    return sorted[rank];
+}
+
+Distribution describe(std::vector<double>& values)
+{
+    Distribution distribution;
+    if (values.empty())
+    {
+        return distribution;
+    }
+
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (const double value : values)
+    {
+        sum += value;
+    }
+    distribution.mean = sum / static_cast<double>(values.size());
+    double squares = 0.0;
+    for (const double value : values)
+    {
+        squares += (value - distribution.mean) * (value - distribution.mean);
+    }
+    distribution.stddev = std::sqrt(squares / static_cast<double>(values.size()));
+    distribution.min = values.front();
+    distribution.p10 = percentile(values, 0.10);
+    distribution.p50 = percentile(values, 0.50);
+    distribution.p90 = percentile(values, 0.90);
+    distribution.p99 = percentile(values, 0.99);
+    distribution.max = values.back();
+    return distribution;
+}
+
+struct JobSummary
+{
+    std::uint64_t finished = 0;
+    Distribution moves;
+    Distribution seconds;
+    std::vector<std::uint64_t> moveHistogram; // games per move count
+};
+
+JobSummary summarize(const JobResults& results)
+{
+    JobSummary summary;
+    summary.finished = results.finished.load(std::memory_order_relaxed);
+
+    std::vector<double> moves;
+    std::vector<double> seconds;
+    moves.reserve(static_cast<std::size_t>(summary.finished));
+    seconds.reserve(static_cast<std::size_t>(summary.finished));
+    for (const GameResult& game : results.games)
+    {
+        if (game.moves < 0)
+        {
+            continue;
+        }
+        moves.push_back(static_cast<double>(game.moves));
+        seconds.push_back(static_cast<double>(game.seconds));
+        if (static_cast<std::size_t>(game.moves) >= summary.moveHistogram.size())
+        {
+            summary.moveHistogram.resize(static_cast<std::size_t>(game.moves) + 1U, 0U);
+        }
+        summary.moveHistogram[static_cast<std::size_t>(game.moves)] += 1U;
+    }
+    summary.moves = describe(moves);
+    summary.seconds = describe(seconds);
+    return summary;
+}
+
+void writeDistributionJson(std::ostream& stream, const Distribution& distribution)
+{
+    stream << "{\"mean\": " << distribution.mean << ", \"stddev\": " << distribution.stddev
+           << ", \"min\": " << distribution.min << ", \"p10\": " << distribution.p10
+           << ", \"p50\": " << distribution.p50 << ", \"p90\": " << distribution.p90
+           << ", \"p99\": " << distribution.p99 << ", \"max\": " << distribution.max << "}";
+}
+
+bool writeJson(const fs::path& path, const Options& options, const std::vector<Job>& jobs, const std::vector<JobSummary>& summaries)
+{
+    std::ofstream stream(path, std::ios::trunc);
+    if (!stream)
+    {
+        return false;
+    }
+
+    stream << std::setprecision(8);
+    stream << "{\n  \"seed\": " << options.seed << ",\n  \"games\": " << options.games << ",\n  \"results\": [\n";
+    for (std::size_t index = 0; index < jobs.size(); ++index)
+    {
+        const Job& job = jobs[index];
+        const JobSummary& summary = summaries[index];
+        stream << "    {\"player\": \"" << job.player << "\", \"columns\": " << job.config.columns
+               << ", \"rows\": " << job.config.rows << ", \"characters\": " << job.config.characterCount
+               << ", \"reveal_seconds\": " << job.config.revealSeconds << ", \"finished\": " << summary.finished
+               << ",\n     \"moves\": ";
+        writeDistributionJson(stream, summary.moves);
+        stream << ",\n     \"seconds\": ";
+        writeDistributionJson(stream, summary.seconds);
+        stream << ",\n     \"move_histogram\": [";
+        for (std::size_t moves = 0; moves < summary.moveHistogram.size(); ++moves)
+        {
+            stream << (moves == 0U ? "" : ", ") << summary.moveHistogram[moves];
+        }
+        stream << "]}" << (index + 1U < jobs.size() ? "," : "") << "\n";
+    }
+    stream << "  ]\n}\n";
+    return static_cast<bool>(stream);
+}
+
+bool writeCsv(const fs::path& path, const std::vector<Job>& jobs, const std::vector<JobSummary>& summaries)
+{
+    std::ofstream stream(path, std::ios::trunc);
+    if (!stream)
+    {
+        return false;
+    }
+
+    stream << std::setprecision(8);
+    stream << "player,columns,rows,characters,reveal_seconds,finished";
+    for (const char* metric : {"moves", "seconds"})
+    {
+        for (const char* field : {"mean", "stddev", "min", "p10", "p50", "p90", "p99", "max"})
+        {
+            stream << ',' << metric << '_' << field;
+        }
+    }
+    stream << '\n';
+
+    for (std::size_t index = 0; index < jobs.size(); ++index)
+    {
+        const Job& job = jobs[index];
+        const JobSummary& summary = summaries[index];
+        stream << job.player << ',' << job.config.columns << ',' << job.config.rows << ',' << job.config.characterCount
+               << ',' << job.config.revealSeconds << ',' << summary.finished;
+        for (const Distribution* distribution : {&summary.moves, &summary.seconds})
+        {
+            stream << ',' << distribution->mean << ',' << distribution->stddev << ',' << distribution->min
+                   << ',' << distribution->p10 << ',' << distribution->p50 << ',' << distribution->p90
+                   << ',' << distribution->p99 << ',' << distribution->max;
+        }
+        stream << '\n';
+    }
+    return static_cast<bool>(stream);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        if (!parseOptions(argc, argv, options))
+        {
+            return 1;
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "Invalid option value: " << error.what() << "\n";
+        return 1;
+    }
+
+    std::vector<Job> jobs;
+    for (memory::BoardConfig config : options.boards)
+    {
+        config.characterCount = options.characters > 0 ? options.characters : config.pairCount();
+        for (const float reveal : options.reveals)
+        {
+            config.revealSeconds = reveal;
+            if (!memory::isValidConfig(config))
+            {
+                std::cerr << "Invalid board: " << config.columns << "x" << config.rows << " with a " << reveal
+                          << " s reveal (needs an even card count, at most " << memory::kMaxBoardSide << " per side)\n";
+                return 1;
+            }
+            for (const std::string& player : options.players)
+            {
+                if (!memory::makePlayer(player))
+                {
+                    std::cerr << "Unknown player: " << player << "\n";
+                    return 1;
+                }
+                jobs.push_back(Job{config, player, configurationKey(config, player)});
+            }
+        }
+    }
+
+    std::vector<JobResults> results(jobs.size());
+    std::vector<Chunk> chunks;
+    for (std::size_t job = 0; job < jobs.size(); ++job)
+    {
+        results[job].games.assign(static_cast<std::size_t>(options.games), GameResult{});
+        for (std::uint64_t begin = 0; begin < options.games; begin += kGamesPerChunk)
+        {
+            chunks.push_back(Chunk{job, begin, std::min(options.games, begin + kGamesPerChunk)});
+        }
+    }
+
+    unsigned int threadCount = options.threads > 0U ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned int>(std::clamp<std::size_t>(chunks.size(), 1U, threadCount));
+
+    // Chunks are dealt out as equal contiguous runs; uneven players (a random
+    // player's game costs ~10x a perfect one's) are evened out by stealing.
+    std::vector<WorkQueue> queues(threadCount);
+    for (std::size_t worker = 0; worker < threadCount; ++worker)
+    {
+        queues[worker].next.store(chunks.size() * worker / threadCount, std::memory_order_relaxed);
+        queues[worker].end = chunks.size() * (worker + 1U) / threadCount;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(threadCount);
+        for (std::size_t worker = 0; worker < threadCount; ++worker)
+        {
+            workers.emplace_back([&, worker] { workerLoop(worker, queues, chunks, jobs, options.seed, results); });
+        }
+    }
+    const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    std::vector<JobSummary> summaries;
+    summaries.reserve(jobs.size());
+    std::uint64_t finished = 0;
+    std::cout << std::fixed << std::setprecision(2);
+    for (std::size_t index = 0; index < jobs.size(); ++index)
+    {
+        summaries.push_back(summarize(results[index]));
+        const Job& job = jobs[index];
+        const JobSummary& summary = summaries.back();
+        finished += summary.finished;
+        std::cout << job.config.columns << "x" << job.config.rows << " reveal " << job.config.revealSeconds << " s, "
+                  << job.player << ": " << summary.finished << " / " << options.games << " finished\n"
+                  << "  moves   mean " << summary.moves.mean << "  p10 " << summary.moves.p10 << "  p50 " << summary.moves.p50
+                  << "  p90 " << summary.moves.p90 << "  p99 " << summary.moves.p99 << "\n"
+                  << "  time    mean " << summary.seconds.mean << "  p10 " << summary.seconds.p10 << "  p50 " << summary.seconds.p50
+                  << "  p90 " << summary.seconds.p90 << "  p99 " << summary.seconds.p99 << " s\n";
+    }
+
+    const std::uint64_t totalGames = options.games * jobs.size();
+    std::cout << "throughput: " << static_cast<double>(totalGames) / std::max(wall.count(), 1.0e-9) << " games/s on "
+              << threadCount << " threads (" << wall.count() << " s wall)\n";
+
+    if (options.jsonPath && !writeJson(*options.jsonPath, options, jobs, summaries))
+    {
+        std::cerr << "Warning: failed to write " << options.jsonPath->string() << "\n";
+    }
+    if (options.csvPath && !writeCsv(*options.csvPath, jobs, summaries))
+    {
+        std::cerr << "Warning: failed to write " << options.csvPath->string() << "\n";
+    }
+    return finished == totalGames ? 0 : 2;
+}
@@ -0,0 +1,149 @@
+#include "board_layout.hpp"
+
+#include "core/json.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <sstream>
+#include <string_view>
+
+namespace
+{
+struct LayoutKey
+{
+    std::string_view name;
+    float LayoutConfig::*field;
+    float minimum;
+    float maximum;
+};
+
+constexpr std::array<LayoutKey, 14> kLayoutKeys{{
+    {"hudHeight", &LayoutConfig::hudHeight, 0.05F, 0.5F},
+    {"outerPadding", &LayoutConfig::outerPadding, 0.0F, 200.0F},
+    {"cardGap", &LayoutConfig::cardGap, 0.0F, 100.0F},
+    {"maxCardGap", &LayoutConfig::maxCardGap, 0.0F, 0.5F},
+    {"buttonWidth", &LayoutConfig::buttonWidth, 40.0F, 600.0F},
+    {"buttonHeight", &LayoutConfig::buttonHeight, 20.0F, 200.0F},
+    {"buttonMargin", &LayoutConfig::buttonMargin, 0.0F, 400.0F},
+    {"buttonTop", &LayoutConfig::buttonTop, 0.0F, 200.0F},
+    {"outlineThickness", &LayoutConfig::outlineThickness, 0.0F, 20.0F},
+    {"titleSize", &LayoutConfig::titleSize, 8.0F, 200.0F},
+    {"statsSize", &LayoutConfig::statsSize, 8.0F, 200.0F},
+    {"buttonTextSize", &LayoutConfig::buttonTextSize, 8.0F, 200.0F},
+    {"cardLabelSize", &LayoutConfig::cardLabelSize, 4.0F, 200.0F},
+    {"overlaySize", &LayoutConfig::overlaySize, 8.0F, 300.0F},
+}};
+} // namespace
+
+std::optional<LayoutConfig> readLayoutConfig(const std::filesystem::path& path, std::string& error)
+{
+    const std::optional<memory::json::Value> document = memory::json::parseFile(path.string(), error);
+    if (!document)
+    {
+        return std::nullopt;
+    }
+    if (!document->isObject())
+    {
+        error = path.string() + ": expected an object";
+        return std::nullopt;
+    }
+
+    LayoutConfig config;
+    for (const LayoutKey& key : kLayoutKeys)
+    {
+        const memory::json::Value* value = document->find(key.name);
+        if (value == nullptr)
+        {
+            continue;
+        }
+        const double number = value->isNumber() ? std::get<double>(value->data) : -1.0;
+        if (number < key.minimum || number > key.maximum)
+        {
+            std::ostringstream message;
+            message << path.string() << ": \"" << key.name << "\" must be a number from " << key.minimum << " to " << key.maximum;
+            error = message.str();
+            return std::nullopt;
+        }
+        config.*key.field = static_cast<float>(number);
+    }
+    return config;
+}
+
+Layout computeLayout(sf::Vector2f windowSize, int columns, int rows)
+{
+    return computeLayout(windowSize, sf::FloatRect(sf::Vector2f(0.0F, 0.0F), windowSize), columns, rows);
+}
+
+Layout computeLayout(sf::Vector2f windowSize, const sf::FloatRect& area, int columns, int rows, const LayoutConfig& config)
+{
+    Layout layout;
+    const float width = area.size.x;
+    const float height = area.size.y;
+
+    layout.scale = std::min(width / kVirtualWidth, height / kVirtualHeight);
+    if (layout.scale <= 0.0F)
+    {
+        layout.scale = 1.0F;
+    }
+
+    const sf::Vector2f playSize{kVirtualWidth * layout.scale, kVirtualHeight * layout.scale};
+    const sf::Vector2f playPos{
+        area.position.x + (width - playSize.x) * 0.5F,
+        area.position.y + (height - playSize.y) * 0.5F,
+    };
+
+    layout.windowSize = windowSize;
+    layout.playArea = sf::FloatRect(playPos, playSize);
+
+    const float hudHeight = playSize.y * config.hudHeight;
+    layout.hudArea = sf::FloatRect(playPos, sf::Vector2f(playSize.x, hudHeight));
+
+    const float outerPad = config.outerPadding * layout.scale;
+    const float gridY = layout.hudArea.position.y + layout.hudArea.size.y + outerPad;
+    const float gridHeight = (layout.playArea.position.y + layout.playArea.size.y) - gridY - outerPad;
+    layout.gridArea = sf::FloatRect(
+        sf::Vector2f(layout.playArea.position.x + outerPad, gridY),
+        sf::Vector2f(layout.playArea.size.x - outerPad * 2.0F, gridHeight));
+
+    // Large boards shrink the gap with the cards so it never dominates the pitch.
+    const float cellLimit = std::min(
+        layout.gridArea.size.x / static_cast<float>(columns),
+        layout.gridArea.size.y / static_cast<float>(rows));
+    const float gap = std::min(config.cardGap * layout.scale, cellLimit * config.maxCardGap);
+    const float maxWidthFromGrid = (layout.gridArea.size.x - gap * static_cast<float>(columns - 1)) / static_cast<float>(columns);
+    const float maxHeightFromGrid = (layout.gridArea.size.y - gap * static_cast<float>(rows - 1)) / static_cast<float>(rows);
+
+    float cardWidth = maxWidthFromGrid;
+    float cardHeight = cardWidth / kCardAspectRatio;
+    if (cardHeight > maxHeightFromGrid)
+    {
+        cardHeight = maxHeightFromGrid;
+        cardWidth = cardHeight * kCardAspectRatio;
+    }
+
+    const float totalGridWidth = cardWidth * static_cast<float>(columns) + gap * static_cast<float>(columns - 1);
+    const float totalGridHeight = cardHeight * static_cast<float>(rows) + gap * static_cast<float>(rows - 1);
+    const float startX = layout.gridArea.position.x + (layout.gridArea.size.x - totalGridWidth) * 0.5F;
+    const float startY = layout.gridArea.position.y + (layout.gridArea.size.y - totalGridHeight) * 0.5F;
+
+    layout.cardSize = sf::Vector2f(cardWidth, cardHeight);
+    layout.gridOrigin = sf::Vector2f(startX, startY);
+    layout.cardPitch = sf::Vector2f(cardWidth + gap, cardHeight + gap);
+    layout.columns = static_cast<std::size_t>(columns);
+
+    const sf::Vector2f buttonSize{config.buttonWidth * layout.scale, config.buttonHeight * layout.scale};
+    const sf::Vector2f buttonPos{
+        layout.hudArea.position.x + layout.hudArea.size.x - buttonSize.x - config.buttonMargin * layout.scale,
+        layout.hudArea.position.y + config.buttonTop * layout.scale,
+    };
+    layout.newGameButton = sf::FloatRect(buttonPos, buttonSize);
+
+    layout.outlineThickness = std::max(1.0F, config.outlineThickness * layout.scale);
+    layout.titleSize = static_cast<unsigned int>(std::max(20.0F, std::round(config.titleSize * layout.scale)));
+    layout.statsSize = static_cast<unsigned int>(std::max(14.0F, std::round(config.statsSize * layout.scale)));
+    layout.buttonSize = static_cast<unsigned int>(std::max(14.0F, std::round(config.buttonTextSize * layout.scale)));
+    layout.cardLabelSize = static_cast<unsigned int>(std::max(8.0F, std::round(std::min(config.cardLabelSize * layout.scale, cardHeight * 0.3F))));
+    layout.overlaySize = static_cast<unsigned int>(std::max(22.0F, std::round(config.overlaySize * layout.scale)));
+    return layout;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+constexpr float kVirtualWidth = 1920.0F;
+constexpr float kVirtualHeight = 1080.0F;
+constexpr float kCardAspectRatio = 3.0F / 4.0F; // width / height
+
+// Tunable proportions, in virtual (1920x1080) pixels unless noted. Read from
+// assets/layout.json when present; missing keys keep these defaults.
+struct LayoutConfig
+{
+    float hudHeight = 0.18F;    // fraction of the play area's height
+    float outerPadding = 26.0F; // around the grid
+    float cardGap = 14.0F;
+    float maxCardGap = 0.1F; // fraction of a grid cell, so large boards keep small gaps
+    float buttonWidth = 230.0F;
+    float buttonHeight = 70.0F;
+    float buttonMargin = 24.0F; // from the HUD's right edge
+    float buttonTop = 26.0F;
+    float outlineThickness = 2.0F;
+    float titleSize = 48.0F;
+    float statsSize = 30.0F;
+    float buttonTextSize = 28.0F;
+    float cardLabelSize = 24.0F;
+    float overlaySize = 56.0F;
+};
+
+// Returns std::nullopt with `error` filled when the file cannot be read or
+// holds an out-of-range value.
+std::optional<LayoutConfig> readLayoutConfig(const std::filesystem::path& path, std::string& error);
+
+struct Layout
+{
+    float scale = 1.0F;
+    float outlineThickness = 2.0F;
+    sf::FloatRect playArea{{0.0F, 0.0F}, {kVirtualWidth, kVirtualHeight}};
+    sf::FloatRect hudArea{{0.0F, 0.0F}, {kVirtualWidth, 180.0F}};
+    sf::FloatRect gridArea{{0.0F, 180.0F}, {kVirtualWidth, kVirtualHeight - 180.0F}};
+    sf::FloatRect newGameButton{{0.0F, 0.0F}, {220.0F, 70.0F}};
+    // Cards form a row-major grid, so their bounds are derived from its
+    // origin and pitch instead of being stored per slot.
+    sf::Vector2f cardSize{0.0F, 0.0F};
+    sf::Vector2f gridOrigin{0.0F, 0.0F};
+    sf::Vector2f cardPitch{0.0F, 0.0F};
+    std::size_t columns = 1U;
+    unsigned int titleSize = 42U;
+    unsigned int statsSize = 30U;
+    unsigned int buttonSize = 28U;
+    unsigned int cardLabelSize = 24U;
+    unsigned int overlaySize = 52U;
+    sf::Vector2f windowSize{0.0F, 0.0F};
+
+    sf::FloatRect cardBounds(std::size_t index) const
+    {
+        const sf::Vector2f cell(static_cast<float>(index % columns), static_cast<float>(index / columns));
+        return sf::FloatRect(
+            sf::Vector2f(gridOrigin.x + cell.x * cardPitch.x, gridOrigin.y + cell.y * cardPitch.y),
+            cardSize);
+    }
+};
+
+// Letterboxes the virtual play area into a window of `windowSize` pixels and
+// fits a `columns` x `rows` grid of cards below the HUD.
+Layout computeLayout(sf::Vector2f windowSize, int columns, int rows);
+
+// The same within `area` of the window, e.g. one tile of a kiosk wall.
+Layout computeLayout(sf::Vector2f windowSize, const sf::FloatRect& area, int columns, int rows, const LayoutConfig& config = LayoutConfig{});
@@ -0,0 +1,90 @@
+#include "card_mesh.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+void writeQuad(sf::Vertex* out, sf::Vector2f center, sf::Vector2f halfSize, const sf::FloatRect& uv, sf::Color color)
+{
+    const float left = center.x - halfSize.x;
+    const float right = center.x + halfSize.x;
+    const float top = center.y - halfSize.y;
+    const float bottom = center.y + halfSize.y;
+
+    const float u0 = uv.position.x;
+    const float u1 = uv.position.x + uv.size.x;
+    const float v0 = uv.position.y;
+    const float v1 = uv.position.y + uv.size.y;
+
+    out[0] = sf::Vertex{{left, top}, color, {u0, v0}};
+    out[1] = sf::Vertex{{right, top}, color, {u1, v0}};
+    out[2] = sf::Vertex{{left, bottom}, color, {u0, v1}};
+    out[3] = sf::Vertex{{left, bottom}, color, {u0, v1}};
+    out[4] = sf::Vertex{{right, top}, color, {u1, v0}};
+    out[5] = sf::Vertex{{right, bottom}, color, {u1, v1}};
+}
+
+void writeRect(sf::Vertex* out, const sf::FloatRect& rect, float inflate, const sf::FloatRect& uv, sf::Color color)
+{
+    writeQuad(
+        out,
+        sf::Vector2f(rect.position.x + rect.size.x * 0.5F, rect.position.y + rect.size.y * 0.5F),
+        sf::Vector2f(rect.size.x * 0.5F + inflate, rect.size.y * 0.5F + inflate),
+        uv,
+        color);
+}
+
+void writeCardVertices(
+    const memory::Card& card,
+    const memory::CardPoseBatch& poses,
+    std::size_t lane,
+    const sf::FloatRect& bounds,
+    float outlineThickness,
+    bool hovered,
+    const CardArt& art,
+    sf::Vertex* vertices)
+{
+    if (card.state == memory::CardState::Removed)
+    {
+        // Collapse both quads so the slot stays in the buffer but rasterises nothing.
+        std::fill(vertices, vertices + kVerticesPerCard, sf::Vertex{});
+        return;
+    }
+
+    const sf::Vector2f scale{poses.scaleX[lane], poses.scaleY[lane]};
+    const std::uint8_t alpha = poses.alpha[lane];
+    const bool showFront = (poses.showFront & (std::uint32_t{1} << lane)) != 0U;
+
+    const sf::Vector2f center{
+        bounds.position.x + bounds.size.x * 0.5F,
+        bounds.position.y + bounds.size.y * 0.5F,
+    };
+    const sf::Vector2f halfSize{bounds.size.x * 0.5F, bounds.size.y * 0.5F};
+    const sf::Vector2f halfOutlined{halfSize.x + outlineThickness, halfSize.y + outlineThickness};
+
+    // The outline is a solid quad behind the body, scaled with it the same way
+    // sf::Shape scales its outline.
+    sf::Color outlineColor = showFront ? kCardOutlineFrontColor : kCardOutlineBackColor;
+    if (hovered && card.state == memory::CardState::FaceDown)
+    {
+        outlineColor = kCardOutlineHoverColor;
+    }
+    outlineColor.a = alpha;
+    writeQuad(
+        vertices,
+        center,
+        sf::Vector2f(halfOutlined.x * scale.x, halfOutlined.y * scale.y),
+        art.solidRegion,
+        outlineColor);
+
+    const sf::Vector2f bodyHalfSize{halfSize.x * scale.x, halfSize.y * scale.y};
+    const sf::FloatRect* region = showFront ? art.faceRegion : art.backRegion;
+    if (region != nullptr)
+    {
+        writeQuad(vertices + kVerticesPerQuad, center, bodyHalfSize, *region, sf::Color(255, 255, 255, alpha));
+        return;
+    }
+
+    sf::Color color = showFront ? art.faceFallback : kCardBackFallbackColor;
+    color.a = alpha;
+    writeQuad(vertices + kVerticesPerQuad, center, bodyHalfSize, art.solidRegion, color);
+}
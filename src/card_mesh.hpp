@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core/animation_kernels.hpp"
+#include "core/memory_rules.hpp"
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include <cstddef>
+
+constexpr std::size_t kVerticesPerQuad = 6U;
+constexpr std::size_t kVerticesPerCard = kVerticesPerQuad * 2U; // outline + body
+
+// Card colours shared by the CPU vertex path and the card shader.
+constexpr sf::Color kCardOutlineFrontColor(20, 22, 30);
+constexpr sf::Color kCardOutlineBackColor(175, 201, 238);
+constexpr sf::Color kCardOutlineHoverColor(245, 226, 121);
+constexpr sf::Color kCardBackFallbackColor(30, 49, 86);
+
+// Atlas regions one card samples. A missing back or face region draws that
+// side as a solid colour over `solidRegion` instead.
+struct CardArt
+{
+    sf::FloatRect solidRegion{{0.0F, 0.0F}, {0.0F, 0.0F}};
+    const sf::FloatRect* backRegion = nullptr;
+    const sf::FloatRect* faceRegion = nullptr;
+    sf::Color faceFallback;
+};
+
+// Writes a quad centred on `center` as two triangles into `out`, which must
+// have room for kVerticesPerQuad vertices.
+void writeQuad(sf::Vertex* out, sf::Vector2f center, sf::Vector2f halfSize, const sf::FloatRect& uv, sf::Color color);
+void writeRect(sf::Vertex* out, const sf::FloatRect& rect, float inflate, const sf::FloatRect& uv, sf::Color color);
+
+// Writes the outline and body quads of `card` (kVerticesPerCard vertices) at
+// the pose `poses` computed for `lane`.
+void writeCardVertices(
+    const memory::Card& card,
+    const memory::CardPoseBatch& poses,
+    std::size_t lane,
+    const sf::FloatRect& bounds,
+    float outlineThickness,
+    bool hovered,
+    const CardArt& art,
+    sf::Vertex* vertices);
@@ -0,0 +1,259 @@
+#include "core/animation_kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MEMORY_ANIMATION_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define MEMORY_ANIMATION_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace memory
+{
+namespace
+{
+constexpr float kMinScale = 0.02F;
+constexpr float kMatchShrink = 0.40F;
+
+std::uint32_t laneMask(std::size_t count)
+{
+    return count >= 32U ? ~std::uint32_t{0} : (std::uint32_t{1} << count) - 1U;
+}
+
+#if defined(MEMORY_ANIMATION_SSE2)
+constexpr std::size_t kLanes = 4;
+
+__m128 select(__m128 mask, __m128 whenSet, __m128 whenClear)
+{
+    return _mm_or_ps(_mm_and_ps(mask, whenSet), _mm_andnot_ps(mask, whenClear));
+}
+
+__m128 stateEquals(__m128i states, CardState state)
+{
+    return _mm_castsi128_ps(_mm_cmpeq_epi32(states, _mm_set1_epi32(static_cast<int>(state))));
+}
+
+__m128i loadStates(const CardState* states)
+{
+    return _mm_setr_epi32(
+        static_cast<int>(states[0]),
+        static_cast<int>(states[1]),
+        static_cast<int>(states[2]),
+        static_cast<int>(states[3]));
+}
+#elif defined(MEMORY_ANIMATION_NEON)
+constexpr std::size_t kLanes = 4;
+
+std::uint32_t moveMask(uint32x4_t mask)
+{
+    const uint32x4_t bits = {1U, 2U, 4U, 8U};
+    return vaddvq_u32(vandq_u32(mask, bits));
+}
+
+uint32x4_t stateEquals(uint32x4_t states, CardState state)
+{
+    return vceqq_u32(states, vdupq_n_u32(static_cast<std::uint32_t>(state)));
+}
+
+uint32x4_t loadStates(const CardState* states)
+{
+    const std::uint32_t lanes[4] = {
+        static_cast<std::uint32_t>(states[0]),
+        static_cast<std::uint32_t>(states[1]),
+        static_cast<std::uint32_t>(states[2]),
+        static_cast<std::uint32_t>(states[3])};
+    return vld1q_u32(lanes);
+}
+#endif
+
+bool isFlipping(CardState state)
+{
+    return state == CardState::FlippingToFront || state == CardState::FlippingToBack;
+}
+
+// One lane of computeCardPoses(); the vector paths mirror it operation for operation.
+void computePoseScalar(const CardPoseInput& input, std::size_t lane, CardPoseBatch& out)
+{
+    const CardState state = input.state[lane];
+    const float flip = input.flipProgress[lane];
+
+    const float t = state == CardState::Matched ? std::clamp(input.removeProgress[lane], 0.0F, 1.0F) : 0.0F;
+    const float vanishScale = 1.0F - kMatchShrink * t;
+    const float flipScale = isFlipping(state)
+        ? std::max(kMinScale, std::fabs(1.0F - std::clamp(flip, 0.0F, 1.0F) * 2.0F))
+        : 1.0F;
+
+    out.scaleX[lane] = std::max(kMinScale, flipScale * vanishScale);
+    out.scaleY[lane] = std::max(kMinScale, vanishScale);
+    out.alpha[lane] = static_cast<std::uint8_t>(static_cast<int>(255.0F * (1.0F - t) + 0.5F));
+
+    const bool showFront = state == CardState::FaceUp || state == CardState::Matched ||
+                           (state == CardState::FlippingToFront && flip >= 0.5F) ||
+                           (state == CardState::FlippingToBack && flip < 0.5F);
+    out.showFront |= showFront ? std::uint32_t{1} << lane : 0U;
+}
+} // namespace
+
+ProgressEvents advanceProgress(
+    std::array<float, kAnimationBatch>& progress,
+    const std::array<float, kAnimationBatch>& rate,
+    std::size_t count)
+{
+    count = std::min(count, kAnimationBatch);
+    ProgressEvents events;
+#if defined(MEMORY_ANIMATION_SSE2)
+    const __m128 half = _mm_set1_ps(0.5F);
+    const __m128 one = _mm_set1_ps(1.0F);
+    for (std::size_t lane = 0; lane < count; lane += kLanes)
+    {
+        const __m128 value = _mm_add_ps(_mm_loadu_ps(progress.data() + lane), _mm_loadu_ps(rate.data() + lane));
+        _mm_storeu_ps(progress.data() + lane, value);
+        events.reachedHalf |= static_cast<std::uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(value, half))) << lane;
+        events.finished |= static_cast<std::uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(value, one))) << lane;
+    }
+#elif defined(MEMORY_ANIMATION_NEON)
+    const float32x4_t half = vdupq_n_f32(0.5F);
+    const float32x4_t one = vdupq_n_f32(1.0F);
+    for (std::size_t lane = 0; lane < count; lane += kLanes)
+    {
+        const float32x4_t value = vaddq_f32(vld1q_f32(progress.data() + lane), vld1q_f32(rate.data() + lane));
+        vst1q_f32(progress.data() + lane, value);
+        events.reachedHalf |= moveMask(vcgeq_f32(value, half)) << lane;
+        events.finished |= moveMask(vcgeq_f32(value, one)) << lane;
+    }
+#else
+    events = advanceProgressReference(progress, rate, count);
+#endif
+    events.reachedHalf &= laneMask(count);
+    events.finished &= laneMask(count);
+    return events;
+}
+
+void computeCardPoses(const CardPoseInput& input, std::size_t count, CardPoseBatch& out)
+{
+    count = std::min(count, kAnimationBatch);
+    out.showFront = 0U;
+#if defined(MEMORY_ANIMATION_SSE2)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 half = _mm_set1_ps(0.5F);
+    const __m128 one = _mm_set1_ps(1.0F);
+    const __m128 two = _mm_set1_ps(2.0F);
+    const __m128 minScale = _mm_set1_ps(kMinScale);
+    const __m128 shrink = _mm_set1_ps(kMatchShrink);
+    const __m128 fullAlpha = _mm_set1_ps(255.0F);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    for (std::size_t lane = 0; lane < count; lane += kLanes)
+    {
+        const __m128i states = loadStates(input.state.data() + lane);
+        const __m128 flipToFront = stateEquals(states, CardState::FlippingToFront);
+        const __m128 flipToBack = stateEquals(states, CardState::FlippingToBack);
+        const __m128 matched = stateEquals(states, CardState::Matched);
+        const __m128 faceUp = stateEquals(states, CardState::FaceUp);
+
+        const __m128 flip = _mm_loadu_ps(input.flipProgress.data() + lane);
+        const __m128 remove = _mm_loadu_ps(input.removeProgress.data() + lane);
+
+        const __m128 t = _mm_and_ps(matched, _mm_min_ps(_mm_max_ps(remove, zero), one));
+        const __m128 vanishScale = _mm_sub_ps(one, _mm_mul_ps(shrink, t));
+        const __m128 clampedFlip = _mm_min_ps(_mm_max_ps(flip, zero), one);
+        const __m128 triangle = _mm_and_ps(absMask, _mm_sub_ps(one, _mm_mul_ps(clampedFlip, two)));
+        const __m128 flipScale = select(_mm_or_ps(flipToFront, flipToBack), _mm_max_ps(minScale, triangle), one);
+
+        _mm_storeu_ps(out.scaleX.data() + lane, _mm_max_ps(minScale, _mm_mul_ps(flipScale, vanishScale)));
+        _mm_storeu_ps(out.scaleY.data() + lane, _mm_max_ps(minScale, vanishScale));
+
+        const __m128i alpha = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(fullAlpha, _mm_sub_ps(one, t)), half));
+        const __m128i alpha16 = _mm_packs_epi32(alpha, alpha);
+        const int packed = _mm_cvtsi128_si32(_mm_packus_epi16(alpha16, alpha16));
+        std::copy_n(reinterpret_cast<const std::uint8_t*>(&packed), kLanes, out.alpha.data() + lane);
+
+        const __m128 front = _mm_or_ps(
+            _mm_or_ps(faceUp, matched),
+            _mm_or_ps(_mm_and_ps(flipToFront, _mm_cmpge_ps(flip, half)), _mm_and_ps(flipToBack, _mm_cmplt_ps(flip, half))));
+        out.showFront |= static_cast<std::uint32_t>(_mm_movemask_ps(front)) << lane;
+    }
+#elif defined(MEMORY_ANIMATION_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0F);
+    const float32x4_t half = vdupq_n_f32(0.5F);
+    const float32x4_t one = vdupq_n_f32(1.0F);
+    const float32x4_t two = vdupq_n_f32(2.0F);
+    const float32x4_t minScale = vdupq_n_f32(kMinScale);
+    const float32x4_t shrink = vdupq_n_f32(kMatchShrink);
+    const float32x4_t fullAlpha = vdupq_n_f32(255.0F);
+    for (std::size_t lane = 0; lane < count; lane += kLanes)
+    {
+        const uint32x4_t states = loadStates(input.state.data() + lane);
+        const uint32x4_t flipToFront = stateEquals(states, CardState::FlippingToFront);
+        const uint32x4_t flipToBack = stateEquals(states, CardState::FlippingToBack);
+        const uint32x4_t matched = stateEquals(states, CardState::Matched);
+        const uint32x4_t faceUp = stateEquals(states, CardState::FaceUp);
+
+        const float32x4_t flip = vld1q_f32(input.flipProgress.data() + lane);
+        const float32x4_t remove = vld1q_f32(input.removeProgress.data() + lane);
+
+        // vmulq/vsubq rather than fused forms, to round exactly like the scalar path.
+        const float32x4_t t = vbslq_f32(matched, vminq_f32(vmaxq_f32(remove, zero), one), zero);
+        const float32x4_t vanishScale = vsubq_f32(one, vmulq_f32(shrink, t));
+        const float32x4_t clampedFlip = vminq_f32(vmaxq_f32(flip, zero), one);
+        const float32x4_t triangle = vabsq_f32(vsubq_f32(one, vmulq_f32(clampedFlip, two)));
+        const float32x4_t flipScale = vbslq_f32(vorrq_u32(flipToFront, flipToBack), vmaxq_f32(minScale, triangle), one);
+
+        vst1q_f32(out.scaleX.data() + lane, vmaxq_f32(minScale, vmulq_f32(flipScale, vanishScale)));
+        vst1q_f32(out.scaleY.data() + lane, vmaxq_f32(minScale, vanishScale));
+
+        const uint32x4_t alpha = vcvtq_u32_f32(vaddq_f32(vmulq_f32(fullAlpha, vsubq_f32(one, t)), half));
+        const uint16x4_t alpha16 = vmovn_u32(alpha);
+        const uint8x8_t alpha8 = vmovn_u16(vcombine_u16(alpha16, alpha16));
+        vst1_lane_u32(reinterpret_cast<std::uint32_t*>(out.alpha.data() + lane), vreinterpret_u32_u8(alpha8), 0);
+
+        const uint32x4_t front = vorrq_u32(
+            vorrq_u32(faceUp, matched),
+            vorrq_u32(vandq_u32(flipToFront, vcgeq_f32(flip, half)), vandq_u32(flipToBack, vcltq_f32(flip, half))));
+        out.showFront |= moveMask(front) << lane;
+    }
+#else
+    computeCardPosesReference(input, count, out);
+#endif
+    out.showFront &= laneMask(count);
+}
+
+ProgressEvents advanceProgressReference(
+    std::array<float, kAnimationBatch>& progress,
+    const std::array<float, kAnimationBatch>& rate,
+    std::size_t count)
+{
+    count = std::min(count, kAnimationBatch);
+    ProgressEvents events;
+    for (std::size_t lane = 0; lane < count; ++lane)
+    {
+        progress[lane] += rate[lane];
+        events.reachedHalf |= progress[lane] >= 0.5F ? std::uint32_t{1} << lane : 0U;
+        events.finished |= progress[lane] >= 1.0F ? std::uint32_t{1} << lane : 0U;
+    }
+    return events;
+}
+
+void computeCardPosesReference(const CardPoseInput& input, std::size_t count, CardPoseBatch& out)
+{
+    count = std::min(count, kAnimationBatch);
+    out.showFront = 0U;
+    for (std::size_t lane = 0; lane < count; ++lane)
+    {
+        computePoseScalar(input, lane, out);
+    }
+}
+
+const char* animationKernelName()
+{
+#if defined(MEMORY_ANIMATION_SSE2)
+    return "sse2";
+#elif defined(MEMORY_ANIMATION_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+} // namespace memory
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "core/memory_rules.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Per-card animation math in fixed-size batches, shared by step() and the
+// renderer. Callers gather up to kAnimationBatch cards into lanes; the kernels
+// work four lanes at a time with SSE2 or NEON and fall back to a scalar loop
+// elsewhere. Every path gives bit-identical results to the scalar reference
+// below, so simulations stay deterministic across machines; the file is built
+// without FMA contraction so the compiler cannot fuse the scalar math, and
+// memory_game_benchmarks checks the match before it times anything.
+namespace memory
+{
+constexpr std::size_t kAnimationBatch = 16;
+
+struct ProgressEvents
+{
+    std::uint32_t reachedHalf = 0; // bit per lane: progress >= 0.5 after the advance
+    std::uint32_t finished = 0;    // bit per lane: progress >= 1
+};
+
+// progress[lane] += rate[lane] for the first `count` lanes.
+ProgressEvents advanceProgress(
+    std::array<float, kAnimationBatch>& progress,
+    const std::array<float, kAnimationBatch>& rate,
+    std::size_t count);
+
+struct CardPoseInput
+{
+    std::array<CardState, kAnimationBatch> state{};
+    std::array<float, kAnimationBatch> flipProgress{};
+    std::array<float, kAnimationBatch> removeProgress{};
+};
+
+// Drawn transform per lane: the flip squashes X, a match shrinks and fades the
+// card. Removed cards get a pose but are not meant to be drawn.
+struct CardPoseBatch
+{
+    std::array<float, kAnimationBatch> scaleX{};
+    std::array<float, kAnimationBatch> scaleY{};
+    std::array<std::uint8_t, kAnimationBatch> alpha{};
+    std::uint32_t showFront = 0; // bit per lane
+};
+
+void computeCardPoses(const CardPoseInput& input, std::size_t count, CardPoseBatch& out);
+
+// The scalar loops, built on every target. The kernels above must match them bit for bit.
+ProgressEvents advanceProgressReference(
+    std::array<float, kAnimationBatch>& progress,
+    const std::array<float, kAnimationBatch>& rate,
+    std::size_t count);
+void computeCardPosesReference(const CardPoseInput& input, std::size_t count, CardPoseBatch& out);
+
+// "sse2", "neon" or "scalar".
+const char* animationKernelName();
+} // namespace memory
@@ -0,0 +1,300 @@
+#include "core/asset_pack.hpp"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace memory
+{
+namespace
+{
+constexpr std::array<char, 4> kMagic{{'M', 'G', 'P', 'K'}};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 16;
+constexpr std::size_t kNameSize = 64;
+constexpr std::size_t kEntrySize = 32 + kNameSize;
+constexpr std::size_t kDataAlignment = 16;
+
+void putU32(std::string& out, std::uint32_t value)
+{
+    for (unsigned int shift = 0; shift < 32U; shift += 8U)
+    {
+        out.push_back(static_cast<char>((value >> shift) & 0xFFU));
+    }
+}
+
+void putU64(std::string& out, std::uint64_t value)
+{
+    for (unsigned int shift = 0; shift < 64U; shift += 8U)
+    {
+        out.push_back(static_cast<char>((value >> shift) & 0xFFU));
+    }
+}
+
+std::uint32_t getU32(const std::uint8_t* bytes)
+{
+    std::uint32_t value = 0;
+    for (unsigned int index = 0; index < 4U; ++index)
+    {
+        value |= static_cast<std::uint32_t>(bytes[index]) << (index * 8U);
+    }
+    return value;
+}
+
+std::uint64_t getU64(const std::uint8_t* bytes)
+{
+    std::uint64_t value = 0;
+    for (unsigned int index = 0; index < 8U; ++index)
+    {
+        value |= static_cast<std::uint64_t>(bytes[index]) << (index * 8U);
+    }
+    return value;
+}
+
+std::size_t alignUp(std::size_t value)
+{
+    return (value + kDataAlignment - 1U) & ~(kDataAlignment - 1U);
+}
+} // namespace
+
+void AssetPackWriter::addImage(std::string name, std::uint32_t width, std::uint32_t height, std::span<const std::uint8_t> rgba)
+{
+    entries_.push_back(PendingEntry{std::move(name), AssetKind::Image, width, height, {rgba.begin(), rgba.end()}});
+}
+
+void AssetPackWriter::addFont(std::string name, std::span<const std::uint8_t> bytes)
+{
+    entries_.push_back(PendingEntry{std::move(name), AssetKind::Font, 0U, 0U, {bytes.begin(), bytes.end()}});
+}
+
+void AssetPackWriter::addData(std::string name, std::span<const std::uint8_t> bytes)
+{
+    entries_.push_back(PendingEntry{std::move(name), AssetKind::Data, 0U, 0U, {bytes.begin(), bytes.end()}});
+}
+
+bool AssetPackWriter::write(const std::filesystem::path& path, std::string& error) const
+{
+    std::string bytes(kMagic.begin(), kMagic.end());
+    putU32(bytes, kVersion);
+    putU32(bytes, static_cast<std::uint32_t>(entries_.size()));
+    putU32(bytes, 0U);
+
+    std::size_t offset = alignUp(kHeaderSize + entries_.size() * kEntrySize);
+    for (const PendingEntry& entry : entries_)
+    {
+        if (entry.name.size() >= kNameSize)
+        {
+            error = "asset name too long: " + entry.name;
+            return false;
+        }
+
+        putU32(bytes, static_cast<std::uint32_t>(entry.kind));
+        putU32(bytes, entry.width);
+        putU32(bytes, entry.height);
+        putU32(bytes, 0U);
+        putU64(bytes, offset);
+        putU64(bytes, entry.bytes.size());
+        std::array<char, kNameSize> name{};
+        std::memcpy(name.data(), entry.name.data(), entry.name.size());
+        bytes.append(name.data(), name.size());
+        offset = alignUp(offset + entry.bytes.size());
+    }
+
+    for (const PendingEntry& entry : entries_)
+    {
+        bytes.resize(alignUp(bytes.size()), '\0');
+        bytes.append(reinterpret_cast<const char*>(entry.bytes.data()), entry.bytes.size());
+    }
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream || !stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+    {
+        error = "cannot write " + path.string();
+        return false;
+    }
+    return true;
+}
+
+std::optional<AssetPack> AssetPack::open(const std::filesystem::path& path, std::string& error)
+{
+    AssetPack pack;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        error = "cannot open " + path.string();
+        return std::nullopt;
+    }
+    pack.fileHandle_ = file;
+
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(file, &fileSize);
+    pack.mappingSize_ = static_cast<std::size_t>(fileSize.QuadPart);
+    if (pack.mappingSize_ >= kHeaderSize)
+    {
+        pack.mappingHandle_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (pack.mappingHandle_ != nullptr)
+        {
+            pack.mapping_ = static_cast<const std::uint8_t*>(MapViewOfFile(pack.mappingHandle_, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        error = "cannot open " + path.string();
+        return std::nullopt;
+    }
+
+    struct stat status{};
+    if (::fstat(file, &status) == 0 && static_cast<std::size_t>(status.st_size) >= kHeaderSize)
+    {
+        pack.mappingSize_ = static_cast<std::size_t>(status.st_size);
+        void* mapped = ::mmap(nullptr, pack.mappingSize_, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapped != MAP_FAILED)
+        {
+            pack.mapping_ = static_cast<const std::uint8_t*>(mapped);
+        }
+    }
+    // The mapping keeps the file contents alive on its own.
+    ::close(file);
+#endif
+
+    if (pack.mapping_ == nullptr)
+    {
+        error = "cannot map " + path.string();
+        return std::nullopt;
+    }
+
+    const std::uint8_t* bytes = pack.mapping_;
+    if (std::memcmp(bytes, kMagic.data(), kMagic.size()) != 0 || getU32(bytes + 4) != kVersion)
+    {
+        error = "not an asset pack (or wrong version): " + path.string();
+        return std::nullopt;
+    }
+
+    const std::uint32_t entryCount = getU32(bytes + 8);
+    if (kHeaderSize + static_cast<std::size_t>(entryCount) * kEntrySize > pack.mappingSize_)
+    {
+        error = "truncated asset pack: " + path.string();
+        return std::nullopt;
+    }
+
+    pack.entries_.reserve(entryCount);
+    for (std::uint32_t index = 0; index < entryCount; ++index)
+    {
+        const std::uint8_t* record = bytes + kHeaderSize + static_cast<std::size_t>(index) * kEntrySize;
+        const std::uint64_t offset = getU64(record + 16);
+        const std::uint64_t size = getU64(record + 24);
+        if (offset > pack.mappingSize_ || size > pack.mappingSize_ - offset)
+        {
+            error = "asset pack entry out of range: " + path.string();
+            return std::nullopt;
+        }
+
+        const char* name = reinterpret_cast<const char*>(record + 32);
+        AssetPackEntry entry;
+        entry.name.assign(name, strnlen(name, kNameSize));
+        entry.kind = static_cast<AssetKind>(getU32(record));
+        entry.width = getU32(record + 4);
+        entry.height = getU32(record + 8);
+        entry.data = std::span<const std::uint8_t>(bytes + offset, static_cast<std::size_t>(size));
+
+        if (entry.kind == AssetKind::Image
+            && static_cast<std::uint64_t>(entry.width) * entry.height * 4U != size)
+        {
+            error = "asset pack image has the wrong size: " + entry.name;
+            return std::nullopt;
+        }
+        pack.entries_.push_back(std::move(entry));
+    }
+
+    return pack;
+}
+
+AssetPack::AssetPack(AssetPack&& other) noexcept :
+    mapping_(std::exchange(other.mapping_, nullptr)),
+    mappingSize_(std::exchange(other.mappingSize_, 0U)),
+#ifdef _WIN32
+    fileHandle_(std::exchange(other.fileHandle_, nullptr)),
+    mappingHandle_(std::exchange(other.mappingHandle_, nullptr)),
+#endif
+    entries_(std::move(other.entries_))
+{
+}
+
+AssetPack& AssetPack::operator=(AssetPack&& other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        mappingSize_ = std::exchange(other.mappingSize_, 0U);
+#ifdef _WIN32
+        fileHandle_ = std::exchange(other.fileHandle_, nullptr);
+        mappingHandle_ = std::exchange(other.mappingHandle_, nullptr);
+#endif
+        entries_ = std::move(other.entries_);
+    }
+    return *this;
+}
+
+AssetPack::~AssetPack()
+{
+    unmap();
+}
+
+void AssetPack::unmap()
+{
+#ifdef _WIN32
+    if (mapping_ != nullptr)
+    {
+        UnmapViewOfFile(mapping_);
+    }
+    if (mappingHandle_ != nullptr)
+    {
+        CloseHandle(mappingHandle_);
+    }
+    if (fileHandle_ != nullptr)
+    {
+        CloseHandle(fileHandle_);
+    }
+    fileHandle_ = nullptr;
+    mappingHandle_ = nullptr;
+#else
+    if (mapping_ != nullptr)
+    {
+        ::munmap(const_cast<std::uint8_t*>(mapping_), mappingSize_);
+    }
+#endif
+    mapping_ = nullptr;
+    mappingSize_ = 0U;
+    entries_.clear();
+}
+
+const AssetPackEntry* AssetPack::find(std::string_view name) const
+{
+    for (const AssetPackEntry& entry : entries_)
+    {
+        if (entry.name == name)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+} // namespace memory
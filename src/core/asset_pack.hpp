@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Single-file asset pack produced at build time by memory_pack.
+//
+// Layout (little-endian):
+//   header: "MGPK", u32 version, u32 entry count, u32 reserved
+//   entry:  u32 kind, u32 width, u32 height, u32 reserved, u64 offset, u64 size, char name[64]
+//   data:   each blob starts on a 16-byte boundary; images are tightly packed RGBA8
+namespace memory
+{
+enum class AssetKind : std::uint32_t
+{
+    Image = 1,
+    Font = 2,
+    Data = 3 // raw bytes, e.g. the card manifest
+};
+
+struct AssetPackEntry
+{
+    std::string name;
+    AssetKind kind = AssetKind::Image;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::span<const std::uint8_t> data;
+};
+
+class AssetPackWriter
+{
+public:
+    void addImage(std::string name, std::uint32_t width, std::uint32_t height, std::span<const std::uint8_t> rgba);
+    void addFont(std::string name, std::span<const std::uint8_t> bytes);
+    void addData(std::string name, std::span<const std::uint8_t> bytes);
+
+    // Returns false and fills `error` if the file cannot be written.
+    bool write(const std::filesystem::path& path, std::string& error) const;
+
+private:
+    struct PendingEntry
+    {
+        std::string name;
+        AssetKind kind;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::vector<std::uint8_t> bytes;
+    };
+
+    std::vector<PendingEntry> entries_;
+};
+
+// Read-only view of a memory-mapped pack. Entry data points straight into the
+// mapping, so entries stay valid for the lifetime of the pack.
+class AssetPack
+{
+public:
+    // Returns std::nullopt and fills `error` if the file is missing or malformed.
+    static std::optional<AssetPack> open(const std::filesystem::path& path, std::string& error);
+
+    AssetPack(AssetPack&& other) noexcept;
+    AssetPack& operator=(AssetPack&& other) noexcept;
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+    ~AssetPack();
+
+    const AssetPackEntry* find(std::string_view name) const;
+    const std::vector<AssetPackEntry>& entries() const { return entries_; }
+
+private:
+    AssetPack() = default;
+    void unmap();
+
+    const std::uint8_t* mapping_ = nullptr;
+    std::size_t mappingSize_ = 0;
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+    std::vector<AssetPackEntry> entries_;
+};
+} // namespace memory
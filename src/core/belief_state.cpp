@@ -0,0 +1,352 @@
+#include "core/belief_state.hpp"
+
+#include "core/seeded_random.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace memory
+{
+namespace
+{
+constexpr int kUnknownSampleTries = 8;
+
+void eraseAt(std::vector<std::int32_t>& list, std::vector<std::int32_t>& positionOf, std::int32_t value)
+{
+    const std::size_t position = static_cast<std::size_t>(positionOf[static_cast<std::size_t>(value)]);
+    const std::int32_t last = list.back();
+    list[position] = last;
+    positionOf[static_cast<std::size_t>(last)] = static_cast<std::int32_t>(position);
+    list.pop_back();
+    positionOf[static_cast<std::size_t>(value)] = -1;
+}
+
+void pushAt(std::vector<std::int32_t>& list, std::vector<std::int32_t>& positionOf, std::int32_t value)
+{
+    positionOf[static_cast<std::size_t>(value)] = static_cast<std::int32_t>(list.size());
+    list.push_back(value);
+}
+} // namespace
+
+bool parseOpponentLevel(std::string_view name, BeliefSettings& out)
+{
+    if (name == "easy")
+    {
+        out.decayPerPick = 0.15F;
+    }
+    else if (name == "normal")
+    {
+        out.decayPerPick = 0.05F;
+    }
+    else if (name == "hard")
+    {
+        out.decayPerPick = 0.0F;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+BeliefState::BeliefState(BeliefSettings settings) :
+    settings_(settings)
+{
+    if (settings_.decayPerPick >= 1.0F)
+    {
+        forgetAfter_ = 1U;
+    }
+    else if (settings_.decayPerPick > 0.0F && settings_.forgetBelow > 0.0F)
+    {
+        const double picks = std::log(static_cast<double>(settings_.forgetBelow)) /
+                             std::log(1.0 - static_cast<double>(settings_.decayPerPick));
+        forgetAfter_ = static_cast<std::uint64_t>(std::max(std::ceil(picks), 1.0));
+    }
+}
+
+void BeliefState::reset(const BoardState& board)
+{
+    const std::size_t cardCount = static_cast<std::size_t>(board.cardCount());
+    const std::size_t characterCount = static_cast<std::size_t>(board.config.characterCount);
+
+    clock_ = 0;
+    character_.assign(cardCount, -1);
+    seenAt_.assign(cardCount, 0U);
+    removed_.assign(cardCount, 0U);
+    older_.assign(cardCount, -1);
+    newer_.assign(cardCount, -1);
+    nextSame_.assign(cardCount, -1);
+    previousSame_.assign(cardCount, -1);
+    unknownAt_.resize(cardCount);
+    unknown_.resize(cardCount);
+    for (std::size_t index = 0; index < cardCount; ++index)
+    {
+        unknownAt_[index] = static_cast<std::int32_t>(index);
+        unknown_[index] = static_cast<std::int32_t>(index);
+    }
+    oldest_ = -1;
+    newest_ = -1;
+
+    countOf_.assign(characterCount, 0);
+    firstOf_.assign(characterCount, -1);
+    pairedAt_.assign(characterCount, -1);
+    paired_.clear();
+    paired_.reserve(characterCount);
+    remainingCards_ = board.cardCount();
+    knownPairs_ = 0;
+    knownSingles_ = 0;
+}
+
+void BeliefState::observe(const BoardState& board, int index)
+{
+    ++clock_;
+    while (oldest_ >= 0 && forgetAfter_ != 0U && clock_ - seenAt_[static_cast<std::size_t>(oldest_)] >= forgetAfter_)
+    {
+        forget(oldest_, false);
+    }
+
+    const int character = board.characterIndex[static_cast<std::size_t>(index)];
+    remember(index, character);
+
+    if (index == board.secondSelected && board.firstSelected >= 0 &&
+        board.characterIndex[static_cast<std::size_t>(board.firstSelected)] == character)
+    {
+        forget(board.firstSelected, true);
+        forget(index, true);
+    }
+}
+
+float BeliefState::strength(int index) const
+{
+    const std::size_t i = static_cast<std::size_t>(index);
+    if (character_[i] < 0)
+    {
+        return 0.0F;
+    }
+    const double age = static_cast<double>(clock_ - seenAt_[i]);
+    return static_cast<float>(std::pow(1.0 - static_cast<double>(settings_.decayPerPick), age));
+}
+
+bool BeliefState::recall(int index, std::mt19937& random)
+{
+    if (uniformUnit(random) < strength(index))
+    {
+        return true;
+    }
+    forget(index, false);
+    return false;
+}
+
+int BeliefState::unknownPairs() const
+{
+    return std::max(remainingCards_ / 2 - knownPairs_, 0);
+}
+
+int BeliefState::knownSingles() const
+{
+    return std::min(knownSingles_, unknownPairs());
+}
+
+bool BeliefState::knownPair(int& first, int& second) const
+{
+    if (paired_.empty())
+    {
+        return false;
+    }
+    first = firstOf_[static_cast<std::size_t>(paired_.back())];
+    second = nextSame_[static_cast<std::size_t>(first)];
+    return true;
+}
+
+int BeliefState::knownPartner(int index) const
+{
+    const int character = character_[static_cast<std::size_t>(index)];
+    if (character < 0)
+    {
+        return -1;
+    }
+    const int first = firstOf_[static_cast<std::size_t>(character)];
+    return first != index ? first : nextSame_[static_cast<std::size_t>(first)];
+}
+
+int BeliefState::freshestSingle(const BoardState& board) const
+{
+    if (knownSingles_ == 0)
+    {
+        return -1;
+    }
+    for (int index = newest_; index >= 0; index = older_[static_cast<std::size_t>(index)])
+    {
+        const int character = character_[static_cast<std::size_t>(index)];
+        if (countOf_[static_cast<std::size_t>(character)] % 2 == 1 && canPick(board, index))
+        {
+            return index;
+        }
+    }
+    return -1;
+}
+
+int BeliefState::randomUnknown(const BoardState& board, std::mt19937& random) const
+{
+    if (!unknown_.empty())
+    {
+        const auto unknownCount = static_cast<std::uint32_t>(unknown_.size());
+        for (int attempt = 0; attempt < kUnknownSampleTries; ++attempt)
+        {
+            const int index = unknown_[uniformBelow(random, unknownCount)];
+            if (canPick(board, index))
+            {
+                return index;
+            }
+        }
+    }
+
+    // Everything left is remembered (or the samples kept missing): any pickable card.
+    int chosen = -1;
+    int seen = 0;
+    for (int index = 0; index < board.cardCount(); ++index)
+    {
+        if (!canPick(board, index))
+        {
+            continue;
+        }
+        ++seen;
+        if (uniformBelow(random, static_cast<std::uint32_t>(seen)) == 0U)
+        {
+            chosen = index;
+        }
+    }
+    return chosen;
+}
+
+void BeliefState::remember(int index, int character)
+{
+    const std::size_t i = static_cast<std::size_t>(index);
+    if (character_[i] >= 0)
+    {
+        unlink(index, character_[i]);
+        count(character_[i], -1);
+    }
+    else if (unknownAt_[i] >= 0)
+    {
+        eraseAt(unknown_, unknownAt_, static_cast<std::int32_t>(index));
+    }
+    character_[i] = character;
+    seenAt_[i] = clock_;
+    link(index, character);
+    count(character, 1);
+}
+
+void BeliefState::forget(int index, bool removed)
+{
+    const std::size_t i = static_cast<std::size_t>(index);
+    const int character = character_[i];
+    if (character >= 0)
+    {
+        unlink(index, character);
+        character_[i] = -1;
+        count(character, -1);
+    }
+
+    if (removed_[i] != 0U)
+    {
+        return;
+    }
+    if (removed)
+    {
+        removed_[i] = 1U;
+        remainingCards_ -= 1;
+        if (unknownAt_[i] >= 0)
+        {
+            eraseAt(unknown_, unknownAt_, static_cast<std::int32_t>(index));
+        }
+    }
+    else if (unknownAt_[i] < 0)
+    {
+        pushAt(unknown_, unknownAt_, static_cast<std::int32_t>(index));
+    }
+}
+
+// Adds `index` as the newest sighting and to the front of its character's slots.
+void BeliefState::link(int index, int character)
+{
+    const std::size_t i = static_cast<std::size_t>(index);
+    older_[i] = newest_;
+    newer_[i] = -1;
+    if (newest_ >= 0)
+    {
+        newer_[static_cast<std::size_t>(newest_)] = index;
+    }
+    else
+    {
+        oldest_ = index;
+    }
+    newest_ = index;
+
+    std::int32_t& first = firstOf_[static_cast<std::size_t>(character)];
+    previousSame_[i] = -1;
+    nextSame_[i] = first;
+    if (first >= 0)
+    {
+        previousSame_[static_cast<std::size_t>(first)] = index;
+    }
+    first = index;
+}
+
+void BeliefState::unlink(int index, int character)
+{
+    const std::size_t i = static_cast<std::size_t>(index);
+    const std::int32_t older = older_[i];
+    const std::int32_t newer = newer_[i];
+    if (older >= 0)
+    {
+        newer_[static_cast<std::size_t>(older)] = newer;
+    }
+    else
+    {
+        oldest_ = newer;
+    }
+    if (newer >= 0)
+    {
+        older_[static_cast<std::size_t>(newer)] = older;
+    }
+    else
+    {
+        newest_ = older;
+    }
+
+    const std::int32_t previous = previousSame_[i];
+    const std::int32_t next = nextSame_[i];
+    if (previous >= 0)
+    {
+        nextSame_[static_cast<std::size_t>(previous)] = next;
+    }
+    else
+    {
+        firstOf_[static_cast<std::size_t>(character)] = next;
+    }
+    if (next >= 0)
+    {
+        previousSame_[static_cast<std::size_t>(next)] = previous;
+    }
+}
+
+void BeliefState::count(int character, int delta)
+{
+    const std::size_t c = static_cast<std::size_t>(character);
+    const int before = countOf_[c];
+    const int after = before + delta;
+    countOf_[c] = after;
+    knownPairs_ += after / 2 - before / 2;
+    knownSingles_ += after % 2 - before % 2;
+
+    if (before < 2 && after >= 2)
+    {
+        pushAt(paired_, pairedAt_, static_cast<std::int32_t>(character));
+    }
+    else if (before >= 2 && after < 2)
+    {
+        eraseAt(paired_, pairedAt_, static_cast<std::int32_t>(character));
+    }
+}
+} // namespace memory
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "core/memory_rules.hpp"
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// What a computer opponent remembers of the board: the character it saw at
+// each slot and how long ago. A memory fades by `decayPerPick` with every
+// card either seat turns over and is dropped once weaker than `forgetBelow`;
+// acting on one succeeds with its current strength. Updates are O(1) and
+// allocate nothing after reset(), so boards of any size cost the same per pick.
+namespace memory
+{
+struct BeliefSettings
+{
+    float decayPerPick = 0.05F;
+    float forgetBelow = 0.05F;
+};
+
+// "easy", "normal" or "hard" (which never forgets); false when unknown.
+bool parseOpponentLevel(std::string_view name, BeliefSettings& out);
+
+class BeliefState
+{
+public:
+    explicit BeliefState(BeliefSettings settings = BeliefSettings{});
+
+    const BeliefSettings& settings() const { return settings_; }
+
+    void reset(const BoardState& board);
+
+    // Called after every accepted pick, by either seat, with the slot turned.
+    // The second card of a matching pair removes both from memory for good.
+    void observe(const BoardState& board, int index);
+
+    // The remembered character at `index`, or -1.
+    int remembered(int index) const { return character_[static_cast<std::size_t>(index)]; }
+    float strength(int index) const;
+
+    // Rolls whether the memory of `index` holds up right now; a memory that
+    // fails is forgotten.
+    bool recall(int index, std::mt19937& random);
+
+    // The position as the search sees it: pairs left once every fully
+    // remembered pair is taken, and remembered cards whose partner is not.
+    int unknownPairs() const;
+    int knownSingles() const;
+
+    // Two remembered face-down slots showing the same character; false when none.
+    bool knownPair(int& first, int& second) const;
+    // A remembered face-down partner for `index`, or -1.
+    int knownPartner(int index) const;
+    // The most recently seen remembered card whose partner is not remembered, or -1.
+    int freshestSingle(const BoardState& board) const;
+    // A face-down card it remembers nothing about, or any pickable card when
+    // it remembers them all; -1 when nothing is pickable.
+    int randomUnknown(const BoardState& board, std::mt19937& random) const;
+
+private:
+    void remember(int index, int character);
+    void forget(int index, bool removed);
+    void count(int character, int delta);
+    void link(int index, int character);
+    void unlink(int index, int character);
+
+    BeliefSettings settings_;
+    std::uint64_t forgetAfter_ = 0; // picks until a memory drops below forgetBelow; 0 = never
+    std::uint64_t clock_ = 0;
+
+    // Per slot. Remembered slots are threaded on two lists: oldest to
+    // newest sighting, and all slots remembered showing the same character.
+    std::vector<std::int32_t> character_; // -1 when not remembered
+    std::vector<std::uint64_t> seenAt_;
+    std::vector<std::uint8_t> removed_;   // matched and gone
+    std::vector<std::int32_t> older_;
+    std::vector<std::int32_t> newer_;
+    std::vector<std::int32_t> nextSame_;
+    std::vector<std::int32_t> previousSame_;
+    std::vector<std::int32_t> unknownAt_; // position in unknown_, or -1
+    std::int32_t oldest_ = -1;
+    std::int32_t newest_ = -1;
+
+    // Per character.
+    std::vector<std::int32_t> countOf_; // remembered face-down slots
+    std::vector<std::int32_t> firstOf_; // head of its same-character list
+    std::vector<std::int32_t> pairedAt_; // position in paired_, or -1
+
+    std::vector<std::int32_t> unknown_; // face-down slots not remembered
+    std::vector<std::int32_t> paired_;  // characters with two or more remembered slots
+    int remainingCards_ = 0;
+    int knownPairs_ = 0;
+    int knownSingles_ = 0;
+};
+} // namespace memory
@@ -0,0 +1,226 @@
+#include "core/bitboard.hpp"
+
+#include "core/optimal_solver.hpp"
+#include "core/seeded_random.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace memory
+{
+namespace
+{
+std::uint64_t bitOf(int slot)
+{
+    return std::uint64_t{1} << static_cast<unsigned int>(slot);
+}
+
+int nthSetBit(std::uint64_t mask, std::uint64_t n)
+{
+    for (; n > 0U; --n)
+    {
+        mask &= mask - 1U;
+    }
+    return std::countr_zero(mask);
+}
+
+int pickUniform(std::uint64_t candidates, std::mt19937& random)
+{
+    return nthSetBit(candidates, uniformBelow(random, static_cast<std::uint32_t>(std::popcount(candidates))));
+}
+
+// Face-down cards whose partner is also known and face down, i.e. pairs that
+// can be cleared without risk; returns 0 when there are none.
+std::uint64_t lowestKnownPair(const BitboardDeal& deal, std::uint64_t known)
+{
+    // Same choice as PerfectMemoryPlayer: the pair whose second card has the lowest slot.
+    std::uint64_t best = 0U;
+    int bestSecond = kBitboardMaxCards;
+    for (std::uint64_t pending = known; pending != 0U; pending &= pending - 1U)
+    {
+        const std::uint64_t pair = deal.pairMask[deal.character[static_cast<std::size_t>(std::countr_zero(pending))]];
+        if ((pair & known) == pair)
+        {
+            const int second = 63 - std::countl_zero(pair);
+            if (second < bestSecond)
+            {
+                bestSecond = second;
+                best = pair;
+            }
+        }
+    }
+    return best;
+}
+
+int choosePerfect(const BitboardDeal& deal, const BitboardState& state, std::mt19937& random)
+{
+    const std::uint64_t known = state.faceDown & state.revealed;
+    if (state.firstPick >= 0)
+    {
+        const std::uint64_t partner = deal.pairMask[deal.character[static_cast<std::size_t>(state.firstPick)]] & known;
+        if (partner != 0U)
+        {
+            return std::countr_zero(partner);
+        }
+    }
+    else if (const std::uint64_t pair = lowestKnownPair(deal, known); pair != 0U)
+    {
+        return std::countr_zero(pair);
+    }
+
+    const std::uint64_t unseen = state.faceDown & ~state.revealed;
+    return pickUniform(unseen != 0U ? unseen : state.faceDown, random);
+}
+
+int knownSingles(const BitboardDeal& deal, std::uint64_t known)
+{
+    int singles = 0;
+    for (std::uint64_t pending = known; pending != 0U; pending &= pending - 1U)
+    {
+        const std::uint64_t pair = deal.pairMask[deal.character[static_cast<std::size_t>(std::countr_zero(pending))]];
+        singles += (pair & known) != pair ? 1 : 0;
+    }
+    return singles;
+}
+} // namespace
+
+BitboardDeal dealBitboard(int pairCount, std::mt19937& random)
+{
+    BitboardDeal deal;
+    deal.cardCount = std::clamp(pairCount * 2, 0, kBitboardMaxCards);
+    deal.allCards = deal.cardCount == kBitboardMaxCards ? ~std::uint64_t{0} : bitOf(deal.cardCount) - 1U;
+
+    std::array<std::int32_t, kBitboardMaxCards> characters{};
+    for (int slot = 0; slot < deal.cardCount; ++slot)
+    {
+        characters[static_cast<std::size_t>(slot)] = slot / 2;
+    }
+    shuffleRange(characters.begin(), characters.begin() + deal.cardCount, random);
+
+    for (int slot = 0; slot < deal.cardCount; ++slot)
+    {
+        const auto character = static_cast<std::uint8_t>(characters[static_cast<std::size_t>(slot)]);
+        deal.character[static_cast<std::size_t>(slot)] = character;
+        deal.pairMask[character] |= bitOf(slot);
+    }
+    return deal;
+}
+
+BitboardState initialState(const BitboardDeal& deal)
+{
+    BitboardState state;
+    state.faceDown = deal.allCards;
+    return state;
+}
+
+PickResult applyPick(const BitboardDeal& deal, BitboardState& state, int slot)
+{
+    if (slot < 0 || slot >= deal.cardCount || (state.faceDown & bitOf(slot)) == 0U)
+    {
+        return PickResult::Rejected;
+    }
+
+    const std::uint64_t bit = bitOf(slot);
+    state.revealed |= bit;
+    state.faceDown &= ~bit;
+    if (state.firstPick < 0)
+    {
+        state.firstPick = static_cast<std::int8_t>(slot);
+        return PickResult::FirstCard;
+    }
+
+    const std::uint64_t pair = bit | bitOf(state.firstPick);
+    const bool match = deal.character[static_cast<std::size_t>(slot)] == deal.character[static_cast<std::size_t>(state.firstPick)];
+    const std::uint64_t matchMask = std::uint64_t{0} - static_cast<std::uint64_t>(match);
+    state.removed |= pair & matchMask;
+    state.faceDown |= pair & ~matchMask;
+    state.matchedPairs = static_cast<std::uint8_t>(state.matchedPairs + (match ? 1U : 0U));
+    state.moves = static_cast<std::uint16_t>(state.moves + 1U);
+    state.firstPick = -1;
+    return PickResult::SecondCard;
+}
+
+std::uint64_t hashState(const BitboardState& state)
+{
+    // splitmix64 finaliser over the three masks and the packed counters.
+    const auto mix = [](std::uint64_t value)
+    {
+        value ^= value >> 30U;
+        value *= 0xBF58476D1CE4E5B9ULL;
+        value ^= value >> 27U;
+        value *= 0x94D049BB133111EBULL;
+        value ^= value >> 31U;
+        return value;
+    };
+
+    const std::uint64_t counters = static_cast<std::uint64_t>(state.moves)
+                                   | (static_cast<std::uint64_t>(state.matchedPairs) << 16U)
+                                   | (static_cast<std::uint64_t>(static_cast<std::uint8_t>(state.firstPick)) << 24U);
+    std::uint64_t hash = mix(state.faceDown + 0x9E3779B97F4A7C15ULL);
+    hash = mix(hash ^ state.revealed);
+    hash = mix(hash ^ state.removed);
+    return mix(hash ^ counters);
+}
+
+bool playBitboardGame(
+    const BitboardDeal& deal,
+    BitboardState& state,
+    BitboardPlayer player,
+    std::mt19937& random,
+    int maxMoves,
+    const OptimalSolver* solver)
+{
+    const int pairCount = deal.cardCount / 2;
+    if (player == BitboardPlayer::Optimal && (solver == nullptr || solver->maxPairs() < pairCount))
+    {
+        return false;
+    }
+
+    state = initialState(deal);
+    SolverPolicy policy;
+    bool openedUnseen = false;
+    while (!isWon(deal, state))
+    {
+        if (state.moves >= maxMoves || state.faceDown == 0U)
+        {
+            return false;
+        }
+
+        int slot = -1;
+        if (player == BitboardPlayer::Random)
+        {
+            slot = pickUniform(state.faceDown, random);
+        }
+        else if (player == BitboardPlayer::PerfectMemory)
+        {
+            slot = choosePerfect(deal, state, random);
+        }
+        else
+        {
+            const std::uint64_t known = state.faceDown & state.revealed;
+            const std::uint64_t unseen = state.faceDown & ~state.revealed;
+            if (state.firstPick < 0)
+            {
+                const std::uint64_t pair = lowestKnownPair(deal, known);
+                const int pairsLeft = pairCount - state.matchedPairs;
+                policy = solver->policy(pairsLeft, knownSingles(deal, known));
+                openedUnseen = pair == 0U && (!policy.openWithKnown || known == 0U);
+                slot = pair != 0U ? std::countr_zero(pair) : pickUniform(openedUnseen ? unseen : known, random);
+            }
+            else
+            {
+                const std::uint64_t partner = deal.pairMask[deal.character[static_cast<std::size_t>(state.firstPick)]] & known;
+                const bool turnKnown = openedUnseen && policy.secondPickKnown && known != 0U;
+                slot = partner != 0U ? std::countr_zero(partner)
+                                     : pickUniform(turnKnown || unseen == 0U ? known : unseen, random);
+            }
+        }
+
+        if (applyPick(deal, state, slot) == PickResult::Rejected)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace memory
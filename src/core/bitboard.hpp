@@ -0,0 +1,86 @@
+#pragma once
+
+#include "core/memory_rules.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+// Decision-level game state for bulk simulation and search. A game splits
+// into an immutable deal and a 32-byte state that is trivially copyable,
+// comparable and hashable, so states can key transposition tables. There is
+// no animation: a second pick resolves the pair immediately.
+namespace memory
+{
+constexpr int kBitboardMaxCards = 64;
+
+struct BitboardDeal
+{
+    int cardCount = 0;
+    std::uint64_t allCards = 0;
+    // Character per slot, one byte each; pairMask holds both slots of a character.
+    std::array<std::uint8_t, kBitboardMaxCards> character{};
+    std::array<std::uint64_t, kBitboardMaxCards / 2> pairMask{};
+};
+
+struct BitboardState
+{
+    std::uint64_t faceDown = 0; // on the table and pickable
+    std::uint64_t revealed = 0; // turned over at least once
+    std::uint64_t removed = 0;
+    std::uint16_t moves = 0;
+    std::uint8_t matchedPairs = 0;
+    std::int8_t firstPick = -1; // slot turned over by the pending first pick
+
+    friend bool operator==(const BitboardState&, const BitboardState&) = default;
+};
+
+static_assert(sizeof(BitboardState) == 32, "BitboardState is meant to stay a 32-byte key");
+
+// Deals `pairCount` pairs (one character per pair) with the same shuffle as
+// resetBoard(), so a seed deals the same board in both representations.
+BitboardDeal dealBitboard(int pairCount, std::mt19937& random);
+
+BitboardState initialState(const BitboardDeal& deal);
+
+// The second pick of a pair counts a move and either removes both cards or
+// turns them back face down, without branching on the outcome.
+PickResult applyPick(const BitboardDeal& deal, BitboardState& state, int slot);
+
+inline bool isWon(const BitboardDeal& deal, const BitboardState& state)
+{
+    return state.removed == deal.allCards;
+}
+
+std::uint64_t hashState(const BitboardState& state);
+
+struct BitboardStateHash
+{
+    std::size_t operator()(const BitboardState& state) const
+    {
+        return static_cast<std::size_t>(hashState(state));
+    }
+};
+
+enum class BitboardPlayer
+{
+    Random,
+    PerfectMemory,
+    Optimal
+};
+
+class OptimalSolver;
+
+// Plays one game to the end; returns false if it did not finish within
+// `maxMoves`. Random and PerfectMemory draw from `random` exactly like
+// RandomPlayer and PerfectMemoryPlayer, so their move counts match playGame().
+// Optimal follows `solver`'s policy and requires it for pairCount pairs.
+bool playBitboardGame(
+    const BitboardDeal& deal,
+    BitboardState& state,
+    BitboardPlayer player,
+    std::mt19937& random,
+    int maxMoves,
+    const OptimalSolver* solver = nullptr);
+} // namespace memory
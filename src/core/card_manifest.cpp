@@ -0,0 +1,129 @@
+#include "core/card_manifest.hpp"
+
+#include "core/json.hpp"
+
+#include <fstream>
+#include <iterator>
+
+namespace memory
+{
+std::optional<CardManifest> parseCardManifest(std::string_view text, std::string& error)
+{
+    const std::optional<json::Value> document = json::parse(text, error);
+    if (!document)
+    {
+        return std::nullopt;
+    }
+
+    const json::Value* cards = document->find("cards");
+    if (cards == nullptr || !cards->isArray() || cards->asArray()->empty())
+    {
+        error = "expected a non-empty \"cards\" array";
+        return std::nullopt;
+    }
+
+    CardManifest manifest;
+    manifest.cards.reserve(cards->asArray()->size());
+    for (const json::Value& card : *cards->asArray())
+    {
+        CardManifestEntry entry{
+            card.stringOr("name", ""),
+            card.stringOr("slug", ""),
+            card.stringOr("processed", "")};
+        if (entry.slug.empty())
+        {
+            error = "card entry without a slug";
+            return std::nullopt;
+        }
+        if (entry.name.empty())
+        {
+            entry.name = entry.slug;
+        }
+        if (entry.processed.empty())
+        {
+            entry.processed = "assets/processed/" + entry.slug + ".png";
+        }
+        manifest.cards.push_back(std::move(entry));
+    }
+
+    if (const json::Value* board = document->find("board"))
+    {
+        manifest.board.columns = static_cast<int>(board->numberOr("columns", kDefaultColumns));
+        manifest.board.rows = static_cast<int>(board->numberOr("rows", kDefaultRows));
+    }
+    manifest.board.characterCount = static_cast<int>(manifest.cards.size());
+    if (!isValidConfig(manifest.board))
+    {
+        error = "invalid board size " + std::to_string(manifest.board.columns) + "x" + std::to_string(manifest.board.rows);
+        return std::nullopt;
+    }
+
+    return manifest;
+}
+
+std::optional<CardManifest> readCardManifest(const std::filesystem::path& path, std::string& error)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        error = "cannot open " + path.string();
+        return std::nullopt;
+    }
+
+    const std::string text{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+    std::optional<CardManifest> manifest = parseCardManifest(text, error);
+    if (!manifest)
+    {
+        error = path.string() + ": " + error;
+    }
+    return manifest;
+}
+
+std::optional<std::vector<SourceManifestEntry>> parseSourceManifest(std::string_view text, std::string& error)
+{
+    const std::optional<json::Value> document = json::parse(text, error);
+    if (!document)
+    {
+        return std::nullopt;
+    }
+
+    const json::Value* cards = document->find("cards");
+    if (cards == nullptr || !cards->isArray())
+    {
+        error = "expected a \"cards\" array";
+        return std::nullopt;
+    }
+
+    std::vector<SourceManifestEntry> sources;
+    sources.reserve(cards->asArray()->size());
+    for (const json::Value& card : *cards->asArray())
+    {
+        SourceManifestEntry entry{card.stringOr("name", ""), card.stringOr("slug", ""), card.stringOr("url", "")};
+        if (entry.slug.empty())
+        {
+            error = "source entry without a slug";
+            return std::nullopt;
+        }
+        sources.push_back(std::move(entry));
+    }
+    return sources;
+}
+
+std::optional<std::vector<SourceManifestEntry>> readSourceManifest(const std::filesystem::path& path, std::string& error)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        error = "cannot open " + path.string();
+        return std::nullopt;
+    }
+
+    const std::string text{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+    std::optional<std::vector<SourceManifestEntry>> sources = parseSourceManifest(text, error);
+    if (!sources)
+    {
+        error = path.string() + ": " + error;
+    }
+    return sources;
+}
+} // namespace memory
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core/memory_rules.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Readers for assets/manifest/cards.json (the deck and the board it is dealt
+// on) and assets/manifest/sources.json (where the original art comes from).
+namespace memory
+{
+struct CardManifestEntry
+{
+    std::string name;
+    std::string slug;
+    std::string processed; // path of the processed PNG, relative to the working directory
+};
+
+struct CardManifest
+{
+    std::vector<CardManifestEntry> cards;
+    // From the optional "board": {"columns": C, "rows": R} object; characterCount
+    // always matches cards.size().
+    BoardConfig board;
+};
+
+// Both return std::nullopt and fill `error` if the manifest is missing or malformed.
+std::optional<CardManifest> parseCardManifest(std::string_view text, std::string& error);
+std::optional<CardManifest> readCardManifest(const std::filesystem::path& path, std::string& error);
+
+// An entry of assets/manifest/sources.json: where a card's original image is
+// downloaded from. `url` may be empty for cards whose source is added by hand.
+struct SourceManifestEntry
+{
+    std::string name;
+    std::string slug;
+    std::string url;
+};
+
+std::optional<std::vector<SourceManifestEntry>> parseSourceManifest(std::string_view text, std::string& error);
+std::optional<std::vector<SourceManifestEntry>> readSourceManifest(const std::filesystem::path& path, std::string& error);
+} // namespace memory
@@ -0,0 +1,480 @@
+#pragma once
+
+#include "core/memory_rules.hpp"
+#include "core/seeded_random.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <random>
+#include <string_view>
+
+// Compile-time sized boards for the fixed cabinet formats (4x4, 6x6, 8x4).
+// Board<Columns, Rows> plays by exactly the same rules and timing as the
+// runtime BoardState, but keeps per-card flags in 64-bit masks and sizes every
+// array at compile time, so loops have constant bounds and pickable/seen sets
+// are single words. Each pair shows its own character (deck >= pair count).
+namespace memory
+{
+// Screen-space grid placement shared by the compile-time hit tests.
+struct GridGeometry
+{
+    float originX = 0.0F;
+    float originY = 0.0F;
+    float cardWidth = 0.0F;
+    float cardHeight = 0.0F;
+    float pitchX = 1.0F;
+    float pitchY = 1.0F;
+};
+
+template <int Columns, int Rows>
+class Board
+{
+public:
+    static constexpr int kColumns = Columns;
+    static constexpr int kRows = Rows;
+    static constexpr int kCardCount = Columns * Rows;
+    static constexpr int kPairCount = kCardCount / 2;
+
+    static_assert(kCardCount > 0 && kCardCount % 2 == 0, "boards need an even number of cards");
+    static_assert(kCardCount <= 64, "card masks are a single 64-bit word");
+
+    using Mask = std::uint64_t;
+    static constexpr Mask kAllCards = kCardCount == 64 ? ~Mask{0} : ((Mask{1} << kCardCount) - 1U);
+
+    struct Cell
+    {
+        std::uint8_t column;
+        std::uint8_t row;
+    };
+
+    // Slot -> grid cell, row-major.
+    static constexpr std::array<Cell, kCardCount> kLayout = []
+    {
+        std::array<Cell, kCardCount> cells{};
+        for (int slot = 0; slot < kCardCount; ++slot)
+        {
+            cells[static_cast<std::size_t>(slot)] = Cell{
+                static_cast<std::uint8_t>(slot % Columns),
+                static_cast<std::uint8_t>(slot / Columns)};
+        }
+        return cells;
+    }();
+
+    // Slot under (x, y), or -1 for points outside the grid or in a gap.
+    static int pick(const GridGeometry& grid, float x, float y)
+    {
+        const float localX = x - grid.originX;
+        const float localY = y - grid.originY;
+        if (localX < 0.0F || localY < 0.0F)
+        {
+            return -1;
+        }
+
+        const int column = static_cast<int>(localX / grid.pitchX);
+        const int row = static_cast<int>(localY / grid.pitchY);
+        if (column >= Columns || row >= Rows)
+        {
+            return -1;
+        }
+
+        const float cellX = localX - static_cast<float>(column) * grid.pitchX;
+        const float cellY = localY - static_cast<float>(row) * grid.pitchY;
+        return (cellX <= grid.cardWidth && cellY <= grid.cardHeight) ? row * Columns + column : -1;
+    }
+
+    void reset(std::mt19937& random)
+    {
+        for (int slot = 0; slot < kCardCount; ++slot)
+        {
+            character_[index(slot)] = slot / 2;
+        }
+        shuffleRange(character_.begin(), character_.end(), random);
+
+        state_.fill(CardState::FaceDown);
+        flipProgress_.fill(0.0F);
+        removeProgress_.fill(0.0F);
+        faceDown_ = kAllCards;
+        animating_ = 0U;
+        faceSwapped_ = 0U;
+
+        pairPhase_ = PairPhase::Idle;
+        firstSelected_ = -1;
+        secondSelected_ = -1;
+        revealRemaining_ = 0.0F;
+        moves_ = 0;
+        matchedPairs_ = 0;
+        elapsedSeconds_ = 0.0F;
+        timerRunning_ = false;
+        won_ = false;
+    }
+
+    // Face-down cards that a pick would accept right now.
+    Mask pickableMask() const
+    {
+        return (won_ || pairPhase_ != PairPhase::Idle) ? Mask{0} : faceDown_;
+    }
+
+    bool canPick(int slot) const
+    {
+        return slot >= 0 && slot < kCardCount && ((pickableMask() >> slot) & 1U) != 0U;
+    }
+
+    PickResult applyPick(int slot)
+    {
+        if (!canPick(slot))
+        {
+            return PickResult::Rejected;
+        }
+
+        timerRunning_ = true;
+        startFlip(slot, CardState::FlippingToFront);
+
+        if (firstSelected_ < 0)
+        {
+            firstSelected_ = slot;
+            return PickResult::FirstCard;
+        }
+
+        if (secondSelected_ < 0 && slot != firstSelected_)
+        {
+            secondSelected_ = slot;
+            moves_ += 1;
+            pairPhase_ = PairPhase::WaitingForSecondFlip;
+            return PickResult::SecondCard;
+        }
+
+        return PickResult::Rejected;
+    }
+
+    void step(float deltaSeconds)
+    {
+        if (timerRunning_ && !won_)
+        {
+            elapsedSeconds_ += deltaSeconds;
+        }
+
+        for (Mask pending = animating_; pending != 0U; pending &= pending - 1U)
+        {
+            const int slot = std::countr_zero(pending);
+            if (!advanceCard(slot, deltaSeconds))
+            {
+                animating_ &= ~bit(slot);
+            }
+        }
+
+        if (pairPhase_ == PairPhase::WaitingForSecondFlip)
+        {
+            if (selectedStableFaceUp())
+            {
+                revealRemaining_ = kRevealDurationSeconds;
+                pairPhase_ = PairPhase::RevealWindow;
+            }
+        }
+        else if (pairPhase_ == PairPhase::RevealWindow)
+        {
+            revealRemaining_ -= deltaSeconds;
+            if (revealRemaining_ <= 0.0F)
+            {
+                resolvePair();
+            }
+        }
+        else if (pairPhase_ == PairPhase::Resolving && selectedResolved())
+        {
+            if (selectedMatch())
+            {
+                matchedPairs_ += 1;
+                if (matchedPairs_ >= kPairCount)
+                {
+                    won_ = true;
+                    timerRunning_ = false;
+                }
+            }
+
+            firstSelected_ = -1;
+            secondSelected_ = -1;
+            pairPhase_ = PairPhase::Idle;
+        }
+    }
+
+    bool isAnimating() const
+    {
+        return pairPhase_ != PairPhase::Idle || animating_ != 0U;
+    }
+
+    float timeUntilNextTransition() const
+    {
+        float next = -1.0F;
+        const auto consider = [&next](float seconds)
+        {
+            seconds = std::max(seconds, 0.0F);
+            next = (next < 0.0F) ? seconds : std::min(next, seconds);
+        };
+
+        for (Mask pending = animating_; pending != 0U; pending &= pending - 1U)
+        {
+            const std::size_t i = index(std::countr_zero(pending));
+            if (state_[i] == CardState::Matched)
+            {
+                consider((1.0F - std::clamp(removeProgress_[i], 0.0F, 1.0F)) * kMatchRemoveDurationSeconds);
+            }
+            else
+            {
+                consider((1.0F - std::clamp(flipProgress_[i], 0.0F, 1.0F)) * kFlipDurationSeconds);
+            }
+        }
+
+        if ((pairPhase_ == PairPhase::WaitingForSecondFlip && selectedStableFaceUp()) ||
+            (pairPhase_ == PairPhase::Resolving && selectedResolved()))
+        {
+            consider(0.0F);
+        }
+        else if (pairPhase_ == PairPhase::RevealWindow)
+        {
+            consider(revealRemaining_);
+        }
+        return next;
+    }
+
+    void advanceToNextDecision()
+    {
+        while (!won_ && pairPhase_ != PairPhase::Idle)
+        {
+            const float seconds = timeUntilNextTransition();
+            if (seconds < 0.0F)
+            {
+                return;
+            }
+            step(seconds > 0.0F ? seconds + kTransitionEpsilonSeconds : 0.0F);
+        }
+    }
+
+    int characterAt(int slot) const { return character_[index(slot)]; }
+    CardState stateAt(int slot) const { return state_[index(slot)]; }
+    int firstSelected() const { return firstSelected_; }
+    int moves() const { return moves_; }
+    int matchedPairs() const { return matchedPairs_; }
+    float elapsedSeconds() const { return elapsedSeconds_; }
+    bool won() const { return won_; }
+
+private:
+    // Same nudge as advanceToNextDecision() on BoardState.
+    static constexpr float kTransitionEpsilonSeconds = 1.0e-5F;
+
+    static constexpr Mask bit(int slot) { return Mask{1} << slot; }
+    static constexpr std::size_t index(int slot) { return static_cast<std::size_t>(slot); }
+
+    void startFlip(int slot, CardState to)
+    {
+        state_[index(slot)] = to;
+        flipProgress_[index(slot)] = 0.0F;
+        faceSwapped_ &= ~bit(slot);
+        faceDown_ &= ~bit(slot);
+        animating_ |= bit(slot);
+    }
+
+    bool advanceCard(int slot, float deltaSeconds)
+    {
+        const std::size_t i = index(slot);
+        if (state_[i] == CardState::Matched)
+        {
+            removeProgress_[i] += deltaSeconds / kMatchRemoveDurationSeconds;
+            if (removeProgress_[i] >= 1.0F)
+            {
+                removeProgress_[i] = 1.0F;
+                state_[i] = CardState::Removed;
+                return false;
+            }
+            return true;
+        }
+
+        flipProgress_[i] += deltaSeconds / kFlipDurationSeconds;
+        const float normalized = std::clamp(flipProgress_[i], 0.0F, 1.0F);
+        if ((faceSwapped_ & bit(slot)) == 0U && normalized >= 0.5F)
+        {
+            faceSwapped_ |= bit(slot);
+        }
+        if (normalized < 1.0F)
+        {
+            return true;
+        }
+
+        flipProgress_[i] = 1.0F;
+        if (state_[i] == CardState::FlippingToFront)
+        {
+            state_[i] = CardState::FaceUp;
+        }
+        else
+        {
+            state_[i] = CardState::FaceDown;
+            faceDown_ |= bit(slot);
+        }
+        return false;
+    }
+
+    bool selectedStableFaceUp() const
+    {
+        return firstSelected_ >= 0 && secondSelected_ >= 0 &&
+               state_[index(firstSelected_)] == CardState::FaceUp &&
+               state_[index(secondSelected_)] == CardState::FaceUp;
+    }
+
+    bool selectedMatch() const
+    {
+        return firstSelected_ >= 0 && secondSelected_ >= 0 &&
+               character_[index(firstSelected_)] == character_[index(secondSelected_)];
+    }
+
+    bool selectedResolved() const
+    {
+        if (firstSelected_ < 0 || secondSelected_ < 0)
+        {
+            return false;
+        }
+        const CardState done = selectedMatch() ? CardState::Removed : CardState::FaceDown;
+        return state_[index(firstSelected_)] == done && state_[index(secondSelected_)] == done;
+    }
+
+    void resolvePair()
+    {
+        if (firstSelected_ < 0 || secondSelected_ < 0)
+        {
+            return;
+        }
+
+        if (selectedMatch())
+        {
+            for (const int slot : {firstSelected_, secondSelected_})
+            {
+                state_[index(slot)] = CardState::Matched;
+                removeProgress_[index(slot)] = 0.0F;
+                animating_ |= bit(slot);
+            }
+        }
+        else
+        {
+            for (const int slot : {firstSelected_, secondSelected_})
+            {
+                if (state_[index(slot)] == CardState::FaceUp)
+                {
+                    startFlip(slot, CardState::FlippingToBack);
+                }
+            }
+        }
+        pairPhase_ = PairPhase::Resolving;
+    }
+
+    std::array<std::int32_t, kCardCount> character_{};
+    std::array<CardState, kCardCount> state_{};
+    std::array<float, kCardCount> flipProgress_{};
+    std::array<float, kCardCount> removeProgress_{};
+    Mask faceDown_ = kAllCards;
+    Mask animating_ = 0U;
+    Mask faceSwapped_ = 0U;
+
+    PairPhase pairPhase_ = PairPhase::Idle;
+    int firstSelected_ = -1;
+    int secondSelected_ = -1;
+    float revealRemaining_ = 0.0F;
+    int moves_ = 0;
+    int matchedPairs_ = 0;
+    float elapsedSeconds_ = 0.0F;
+    bool timerRunning_ = false;
+    bool won_ = false;
+};
+
+// Returns the `n`th set bit of `mask` (0-based, ascending).
+inline int nthSetBit(std::uint64_t mask, std::uint64_t n)
+{
+    for (; n > 0U; --n)
+    {
+        mask &= mask - 1U;
+    }
+    return std::countr_zero(mask);
+}
+
+// Playout loop for the fixed boards with the "random" and "perfect" players.
+// Draws from `random` in the same order as RandomPlayer/PerfectMemoryPlayer
+// with playGame(), so both engines report identical games for one seed.
+template <int Columns, int Rows>
+bool playFixedGame(Board<Columns, Rows>& board, bool perfectMemory, std::mt19937& random, int maxMoves)
+{
+    using FixedBoard = Board<Columns, Rows>;
+    using Mask = typename FixedBoard::Mask;
+
+    std::array<std::int8_t, FixedBoard::kCardCount> seenCharacter{};
+    Mask seen = 0U;
+
+    const auto pickUniform = [&random](Mask candidates)
+    {
+        return nthSetBit(candidates, uniformBelow(random, static_cast<std::uint32_t>(std::popcount(candidates))));
+    };
+
+    const auto choosePerfect = [&](Mask pickable) -> int
+    {
+        const int first = board.firstSelected();
+        if (first >= 0)
+        {
+            // Characters are unique per pair, so the partner is the only other match.
+            const int wanted = seenCharacter[static_cast<std::size_t>(first)];
+            for (Mask known = seen & pickable; known != 0U; known &= known - 1U)
+            {
+                const int slot = std::countr_zero(known);
+                if (slot != first && seenCharacter[static_cast<std::size_t>(slot)] == wanted)
+                {
+                    return slot;
+                }
+            }
+        }
+        else
+        {
+            std::array<std::int8_t, FixedBoard::kPairCount> firstSeenAt;
+            firstSeenAt.fill(-1);
+            for (Mask known = seen & pickable; known != 0U; known &= known - 1U)
+            {
+                const int slot = std::countr_zero(known);
+                std::int8_t& earlier = firstSeenAt[static_cast<std::size_t>(seenCharacter[static_cast<std::size_t>(slot)])];
+                if (earlier >= 0)
+                {
+                    return earlier;
+                }
+                earlier = static_cast<std::int8_t>(slot);
+            }
+        }
+
+        const Mask unseen = pickable & ~seen;
+        return pickUniform(unseen != 0U ? unseen : pickable);
+    };
+
+    board.reset(random);
+    while (!board.won())
+    {
+        if (board.moves() >= maxMoves)
+        {
+            return false;
+        }
+
+        const Mask pickable = board.pickableMask();
+        if (pickable == 0U)
+        {
+            return false;
+        }
+
+        const int slot = perfectMemory ? choosePerfect(pickable) : pickUniform(pickable);
+        const PickResult result = board.applyPick(slot);
+        if (result == PickResult::Rejected)
+        {
+            return false;
+        }
+
+        seen |= Mask{1} << slot;
+        seenCharacter[static_cast<std::size_t>(slot)] = static_cast<std::int8_t>(board.characterAt(slot));
+        if (result == PickResult::SecondCard)
+        {
+            board.advanceToNextDecision();
+        }
+    }
+    return true;
+}
+} // namespace memory
@@ -0,0 +1,290 @@
+#include "core/input_log.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+namespace memory
+{
+namespace
+{
+constexpr std::array<char, 4> kMagic{{'M', 'G', 'I', 'L'}};
+constexpr std::uint16_t kVersion = 4;
+
+void putU16(std::string& out, std::uint16_t value)
+{
+    out.push_back(static_cast<char>(value & 0xFFU));
+    out.push_back(static_cast<char>((value >> 8U) & 0xFFU));
+}
+
+void putU32(std::string& out, std::uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        out.push_back(static_cast<char>((value >> static_cast<unsigned int>(shift)) & 0xFFU));
+    }
+}
+
+void putF32(std::string& out, float value)
+{
+    putU32(out, std::bit_cast<std::uint32_t>(value));
+}
+
+void putVarint(std::string& out, std::uint64_t value)
+{
+    while (value >= 0x80U)
+    {
+        out.push_back(static_cast<char>((value & 0x7FU) | 0x80U));
+        value >>= 7U;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+class ByteReader
+{
+public:
+    explicit ByteReader(const std::string& bytes) :
+        bytes_(bytes)
+    {
+    }
+
+    bool atEnd() const
+    {
+        return offset_ >= bytes_.size();
+    }
+
+    bool readU8(std::uint8_t& value)
+    {
+        if (atEnd())
+        {
+            return false;
+        }
+        value = static_cast<std::uint8_t>(bytes_[offset_++]);
+        return true;
+    }
+
+    bool readU16(std::uint16_t& value)
+    {
+        std::uint8_t low = 0;
+        std::uint8_t high = 0;
+        if (!readU8(low) || !readU8(high))
+        {
+            return false;
+        }
+        value = static_cast<std::uint16_t>(low | (high << 8U));
+        return true;
+    }
+
+    bool readU32(std::uint32_t& value)
+    {
+        value = 0;
+        for (unsigned int shift = 0; shift < 32U; shift += 8U)
+        {
+            std::uint8_t byte = 0;
+            if (!readU8(byte))
+            {
+                return false;
+            }
+            value |= static_cast<std::uint32_t>(byte) << shift;
+        }
+        return true;
+    }
+
+    bool readF32(float& value)
+    {
+        std::uint32_t bits = 0;
+        if (!readU32(bits))
+        {
+            return false;
+        }
+        value = std::bit_cast<float>(bits);
+        return true;
+    }
+
+    bool readVarint(std::uint64_t& value)
+    {
+        value = 0;
+        for (unsigned int shift = 0; shift < 64U; shift += 7U)
+        {
+            std::uint8_t byte = 0;
+            if (!readU8(byte))
+            {
+                return false;
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+            if ((byte & 0x80U) == 0U)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const std::string& bytes_;
+    std::size_t offset_ = 0;
+};
+} // namespace
+
+std::optional<InputLogWriter> InputLogWriter::create(const std::filesystem::path& path, const InputLogHeader& header)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream)
+    {
+        return std::nullopt;
+    }
+
+    std::string bytes(kMagic.begin(), kMagic.end());
+    putU16(bytes, kVersion);
+    putU16(bytes, 0U);
+    putU32(bytes, header.seed);
+    putF32(bytes, header.tickSeconds);
+    putU16(bytes, static_cast<std::uint16_t>(header.board.columns));
+    putU16(bytes, static_cast<std::uint16_t>(header.board.rows));
+    putU32(bytes, static_cast<std::uint32_t>(header.board.characterCount));
+    stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    stream.flush();
+
+    return InputLogWriter(std::move(stream));
+}
+
+InputLogWriter::InputLogWriter(std::ofstream stream) :
+    stream_(std::move(stream))
+{
+}
+
+void InputLogWriter::write(const InputRecord& record)
+{
+    std::string bytes;
+    putVarint(bytes, record.tick - lastTick_);
+    bytes.push_back(static_cast<char>(record.kind));
+
+    switch (record.kind)
+    {
+        case InputKind::Click:
+            putF32(bytes, record.x);
+            putF32(bytes, record.y);
+            putF32(bytes, record.lateSeconds);
+            break;
+        case InputKind::Key:
+            putVarint(bytes, static_cast<std::uint64_t>(static_cast<std::uint32_t>(record.key)));
+            break;
+        case InputKind::End:
+        default:
+            break;
+    }
+
+    lastTick_ = record.tick;
+    stream_.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+    // Input is sparse, so flushing every record is cheap and keeps the log
+    // usable when the session that produced it crashed.
+    stream_.flush();
+}
+
+std::optional<InputLog> readInputLog(const std::filesystem::path& path, std::string& error)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        error = "cannot open " + path.string();
+        return std::nullopt;
+    }
+
+    const std::string bytes{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+    if (bytes.size() < kMagic.size() || std::memcmp(bytes.data(), kMagic.data(), kMagic.size()) != 0)
+    {
+        error = "not an input log: " + path.string();
+        return std::nullopt;
+    }
+
+    ByteReader reader(bytes);
+    for (std::size_t index = 0; index < kMagic.size(); ++index)
+    {
+        std::uint8_t skipped = 0;
+        reader.readU8(skipped);
+    }
+
+    InputLog log;
+    std::uint16_t version = 0;
+    std::uint16_t reserved = 0;
+    if (!reader.readU16(version) || !reader.readU16(reserved) ||
+        !reader.readU32(log.header.seed) || !reader.readF32(log.header.tickSeconds))
+    {
+        error = "truncated input log header";
+        return std::nullopt;
+    }
+    if (version == 0U || version > kVersion)
+    {
+        error = "unsupported input log version " + std::to_string(version);
+        return std::nullopt;
+    }
+    log.header.version = version;
+    if (version >= 2U)
+    {
+        std::uint16_t columns = 0;
+        std::uint16_t rows = 0;
+        std::uint32_t characterCount = 0;
+        if (!reader.readU16(columns) || !reader.readU16(rows) || !reader.readU32(characterCount))
+        {
+            error = "truncated input log header";
+            return std::nullopt;
+        }
+        log.header.board = BoardConfig{columns, rows, static_cast<int>(characterCount)};
+        if (!isValidConfig(log.header.board))
+        {
+            error = "invalid board size in input log header";
+            return std::nullopt;
+        }
+    }
+
+    std::uint64_t tick = 0;
+    while (!reader.atEnd())
+    {
+        std::uint64_t delta = 0;
+        std::uint8_t kind = 0;
+        if (!reader.readVarint(delta) || !reader.readU8(kind))
+        {
+            error = "truncated input log record";
+            return std::nullopt;
+        }
+
+        InputRecord record;
+        tick += delta;
+        record.tick = tick;
+        record.kind = static_cast<InputKind>(kind);
+
+        bool ok = true;
+        switch (record.kind)
+        {
+            case InputKind::Click:
+                ok = reader.readF32(record.x) && reader.readF32(record.y) &&
+                    (version < 3U || reader.readF32(record.lateSeconds));
+                break;
+            case InputKind::Key:
+            {
+                std::uint64_t key = 0;
+                ok = reader.readVarint(key);
+                record.key = static_cast<int>(static_cast<std::uint32_t>(key));
+                break;
+            }
+            case InputKind::End:
+                break;
+            default:
+                error = "unknown input log record kind " + std::to_string(kind);
+                return std::nullopt;
+        }
+
+        if (!ok)
+        {
+            error = "truncated input log record";
+            return std::nullopt;
+        }
+        log.records.push_back(record);
+    }
+
+    return log;
+}
+} // namespace memory
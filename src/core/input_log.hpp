@@ -0,0 +1,81 @@
+#pragma once
+
+#include "core/memory_rules.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Compact binary log of player input for deterministic replays.
+//
+// Layout (little-endian):
+//   header: "MGIL", u16 version, u16 reserved, u32 shuffle seed, f32 tick seconds,
+//           u16 columns, u16 rows, u32 character count (version 2; version 1
+//           logs end after the tick and always used the default 8x4 board)
+//   record: varint tick delta, u8 kind, payload
+//     Click: f32 x, f32 y in virtual (1920x1080) play-area coordinates,
+//            f32 seconds the click preceded its tick (version 3)
+//     Key:   varint key code
+//     End:   no payload; the session closed at this tick
+// Version 4 changes no bytes: its deals come from shuffleRange(), the same on
+// every standard library, where earlier logs dealt through std::shuffle.
+namespace memory
+{
+enum class InputKind : std::uint8_t
+{
+    Click = 1,
+    Key = 2,
+    End = 3
+};
+
+struct InputRecord
+{
+    std::uint64_t tick = 0;
+    InputKind kind = InputKind::Click;
+    float x = 0.0F;
+    float y = 0.0F;
+    int key = 0;
+    // Click only: how long before `tick` the click happened.
+    float lateSeconds = 0.0F;
+};
+
+// Logs before this version dealt through std::shuffle, so their deal only
+// replays on the standard library that recorded them.
+constexpr std::uint16_t kPortableDealInputLogVersion = 4;
+
+struct InputLogHeader
+{
+    std::uint32_t seed = 0;
+    float tickSeconds = 0.0F;
+    BoardConfig board;
+    // Version the log was read from; writers always write the current one.
+    std::uint16_t version = 0;
+};
+
+class InputLogWriter
+{
+public:
+    // Returns std::nullopt if the file cannot be created.
+    static std::optional<InputLogWriter> create(const std::filesystem::path& path, const InputLogHeader& header);
+
+    void write(const InputRecord& record);
+
+private:
+    explicit InputLogWriter(std::ofstream stream);
+
+    std::ofstream stream_;
+    std::uint64_t lastTick_ = 0;
+};
+
+struct InputLog
+{
+    InputLogHeader header;
+    std::vector<InputRecord> records;
+};
+
+// Reads a whole log; on failure returns std::nullopt and fills `error`.
+std::optional<InputLog> readInputLog(const std::filesystem::path& path, std::string& error);
+} // namespace memory
@@ -0,0 +1,398 @@
+#include "core/json.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+
+namespace memory::json
+{
+namespace
+{
+constexpr int kMaxDepth = 64;
+
+class Parser
+{
+public:
+    explicit Parser(std::string_view text) :
+        text_(text)
+    {
+    }
+
+    std::optional<Value> parseDocument(std::string& error)
+    {
+        std::optional<Value> value = parseValue(0);
+        skipWhitespace();
+        if (value && offset_ != text_.size())
+        {
+            fail("unexpected trailing characters");
+            value.reset();
+        }
+        if (!value)
+        {
+            error = "offset " + std::to_string(errorOffset_) + ": " + errorMessage_;
+        }
+        return value;
+    }
+
+private:
+    void fail(const char* message)
+    {
+        if (errorMessage_.empty())
+        {
+            errorMessage_ = message;
+            errorOffset_ = offset_;
+        }
+    }
+
+    void skipWhitespace()
+    {
+        while (offset_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[offset_])) != 0)
+        {
+            ++offset_;
+        }
+    }
+
+    bool consume(char expected)
+    {
+        skipWhitespace();
+        if (offset_ < text_.size() && text_[offset_] == expected)
+        {
+            ++offset_;
+            return true;
+        }
+        return false;
+    }
+
+    bool consumeLiteral(std::string_view literal)
+    {
+        if (text_.substr(offset_, literal.size()) == literal)
+        {
+            offset_ += literal.size();
+            return true;
+        }
+        return false;
+    }
+
+    std::optional<Value> parseValue(int depth)
+    {
+        if (depth > kMaxDepth)
+        {
+            fail("nesting too deep");
+            return std::nullopt;
+        }
+
+        skipWhitespace();
+        if (offset_ >= text_.size())
+        {
+            fail("unexpected end of input");
+            return std::nullopt;
+        }
+
+        const char c = text_[offset_];
+        if (c == '{')
+        {
+            return parseObject(depth);
+        }
+        if (c == '[')
+        {
+            return parseArray(depth);
+        }
+        if (c == '"')
+        {
+            std::optional<std::string> text = parseString();
+            if (!text)
+            {
+                return std::nullopt;
+            }
+            return Value{std::move(*text)};
+        }
+        if (consumeLiteral("true"))
+        {
+            return Value{true};
+        }
+        if (consumeLiteral("false"))
+        {
+            return Value{false};
+        }
+        if (consumeLiteral("null"))
+        {
+            return Value{nullptr};
+        }
+        return parseNumber();
+    }
+
+    std::optional<Value> parseObject(int depth)
+    {
+        ++offset_; // '{'
+        Object object;
+        if (consume('}'))
+        {
+            return Value{std::move(object)};
+        }
+
+        do
+        {
+            skipWhitespace();
+            if (offset_ >= text_.size() || text_[offset_] != '"')
+            {
+                fail("expected object key");
+                return std::nullopt;
+            }
+            std::optional<std::string> key = parseString();
+            if (!key)
+            {
+                return std::nullopt;
+            }
+            if (!consume(':'))
+            {
+                fail("expected ':'");
+                return std::nullopt;
+            }
+            std::optional<Value> member = parseValue(depth + 1);
+            if (!member)
+            {
+                return std::nullopt;
+            }
+            object.insert_or_assign(std::move(*key), std::move(*member));
+        } while (consume(','));
+
+        if (!consume('}'))
+        {
+            fail("expected ',' or '}'");
+            return std::nullopt;
+        }
+        return Value{std::move(object)};
+    }
+
+    std::optional<Value> parseArray(int depth)
+    {
+        ++offset_; // '['
+        Array array;
+        if (consume(']'))
+        {
+            return Value{std::move(array)};
+        }
+
+        do
+        {
+            std::optional<Value> element = parseValue(depth + 1);
+            if (!element)
+            {
+                return std::nullopt;
+            }
+            array.push_back(std::move(*element));
+        } while (consume(','));
+
+        if (!consume(']'))
+        {
+            fail("expected ',' or ']'");
+            return std::nullopt;
+        }
+        return Value{std::move(array)};
+    }
+
+    static void appendUtf8(std::string& out, std::uint32_t codepoint)
+    {
+        if (codepoint < 0x80U)
+        {
+            out.push_back(static_cast<char>(codepoint));
+        }
+        else if (codepoint < 0x800U)
+        {
+            out.push_back(static_cast<char>(0xC0U | (codepoint >> 6U)));
+            out.push_back(static_cast<char>(0x80U | (codepoint & 0x3FU)));
+        }
+        else if (codepoint < 0x10000U)
+        {
+            out.push_back(static_cast<char>(0xE0U | (codepoint >> 12U)));
+            out.push_back(static_cast<char>(0x80U | ((codepoint >> 6U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | (codepoint & 0x3FU)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xF0U | (codepoint >> 18U)));
+            out.push_back(static_cast<char>(0x80U | ((codepoint >> 12U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | ((codepoint >> 6U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | (codepoint & 0x3FU)));
+        }
+    }
+
+    bool parseHex4(std::uint32_t& value)
+    {
+        if (offset_ + 4U > text_.size())
+        {
+            return false;
+        }
+        const auto* begin = text_.data() + offset_;
+        const auto result = std::from_chars(begin, begin + 4, value, 16);
+        if (result.ptr != begin + 4)
+        {
+            return false;
+        }
+        offset_ += 4U;
+        return true;
+    }
+
+    std::optional<std::string> parseString()
+    {
+        ++offset_; // opening quote
+        std::string out;
+        while (offset_ < text_.size())
+        {
+            const char c = text_[offset_++];
+            if (c == '"')
+            {
+                return out;
+            }
+            if (c != '\\')
+            {
+                out.push_back(c);
+                continue;
+            }
+
+            if (offset_ >= text_.size())
+            {
+                break;
+            }
+            const char escape = text_[offset_++];
+            switch (escape)
+            {
+                case '"': out.push_back('"'); break;
+                case '\\': out.push_back('\\'); break;
+                case '/': out.push_back('/'); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u':
+                {
+                    std::uint32_t codepoint = 0;
+                    if (!parseHex4(codepoint))
+                    {
+                        fail("invalid \\u escape");
+                        return std::nullopt;
+                    }
+                    if (codepoint >= 0xD800U && codepoint <= 0xDBFFU && consumeLiteral("\\u"))
+                    {
+                        std::uint32_t low = 0;
+                        if (!parseHex4(low) || low < 0xDC00U || low > 0xDFFFU)
+                        {
+                            fail("invalid surrogate pair");
+                            return std::nullopt;
+                        }
+                        codepoint = 0x10000U + ((codepoint - 0xD800U) << 10U) + (low - 0xDC00U);
+                    }
+                    appendUtf8(out, codepoint);
+                    break;
+                }
+                default:
+                    fail("invalid escape");
+                    return std::nullopt;
+            }
+        }
+
+        fail("unterminated string");
+        return std::nullopt;
+    }
+
+    std::optional<Value> parseNumber()
+    {
+        const std::size_t start = offset_;
+        while (offset_ < text_.size())
+        {
+            const char c = text_[offset_];
+            if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')
+            {
+                ++offset_;
+                continue;
+            }
+            break;
+        }
+
+        double number = 0.0;
+        const auto* begin = text_.data() + start;
+        const auto* end = text_.data() + offset_;
+        const auto result = std::from_chars(begin, end, number);
+        if (start == offset_ || result.ec != std::errc() || result.ptr != end)
+        {
+            offset_ = start;
+            fail("invalid value");
+            return std::nullopt;
+        }
+        return Value{number};
+    }
+
+    std::string_view text_;
+    std::size_t offset_ = 0;
+    std::string errorMessage_;
+    std::size_t errorOffset_ = 0;
+};
+} // namespace
+
+const Value* Value::find(std::string_view key) const
+{
+    const Object* object = asObject();
+    if (object == nullptr)
+    {
+        return nullptr;
+    }
+    const auto iter = object->find(key);
+    return iter == object->end() ? nullptr : &iter->second;
+}
+
+std::string Value::stringOr(std::string_view key, std::string_view fallback) const
+{
+    const Value* member = find(key);
+    if (member != nullptr && member->isString())
+    {
+        return std::get<std::string>(member->data);
+    }
+    return std::string(fallback);
+}
+
+double Value::numberOr(std::string_view key, double fallback) const
+{
+    const Value* member = find(key);
+    if (member != nullptr && member->isNumber())
+    {
+        return std::get<double>(member->data);
+    }
+    return fallback;
+}
+
+bool Value::boolOr(std::string_view key, bool fallback) const
+{
+    const Value* member = find(key);
+    if (member != nullptr && member->isBool())
+    {
+        return std::get<bool>(member->data);
+    }
+    return fallback;
+}
+
+std::optional<Value> parse(std::string_view text, std::string& error)
+{
+    return Parser(text).parseDocument(error);
+}
+
+std::optional<Value> parseFile(const std::string& path, std::string& error)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        error = "cannot open " + path;
+        return std::nullopt;
+    }
+
+    const std::string text{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+    std::optional<Value> value = parse(text, error);
+    if (!value)
+    {
+        error = path + ": " + error;
+    }
+    return value;
+}
+} // namespace memory::json
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+// Minimal JSON reader for the asset manifests and config files. Supports the
+// full value grammar but keeps numbers as double and does not preserve key order.
+namespace memory::json
+{
+struct Value;
+
+using Array = std::vector<Value>;
+using Object = std::map<std::string, Value, std::less<>>;
+
+struct Value
+{
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> data{nullptr};
+
+    bool isObject() const { return std::holds_alternative<Object>(data); }
+    bool isArray() const { return std::holds_alternative<Array>(data); }
+    bool isString() const { return std::holds_alternative<std::string>(data); }
+    bool isNumber() const { return std::holds_alternative<double>(data); }
+    bool isBool() const { return std::holds_alternative<bool>(data); }
+
+    // Member lookup; returns nullptr when this is not an object or the key is missing.
+    const Value* find(std::string_view key) const;
+
+    const Array* asArray() const { return std::get_if<Array>(&data); }
+    const Object* asObject() const { return std::get_if<Object>(&data); }
+
+    std::string stringOr(std::string_view key, std::string_view fallback) const;
+    double numberOr(std::string_view key, double fallback) const;
+    bool boolOr(std::string_view key, bool fallback) const;
+};
+
+// Parses `text`; on failure returns std::nullopt and fills `error` with a position and reason.
+std::optional<Value> parse(std::string_view text, std::string& error);
+
+// Reads and parses a whole file.
+std::optional<Value> parseFile(const std::string& path, std::string& error);
+} // namespace memory::json
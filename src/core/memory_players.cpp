@@ -0,0 +1,257 @@
+#include "core/memory_players.hpp"
+
+#include "core/seeded_random.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <utility>
+
+namespace memory
+{
+namespace
+{
+constexpr std::size_t kDefaultBoundedMemory = 8U;
+
+int pickUniform(const std::vector<int>& candidates, std::mt19937& random)
+{
+    if (candidates.empty())
+    {
+        return -1;
+    }
+
+    return candidates[uniformBelow(random, static_cast<std::uint32_t>(candidates.size()))];
+}
+
+void collectPickable(const BoardState& board, std::vector<int>& out)
+{
+    out.clear();
+    for (int index = 0; index < board.cardCount(); ++index)
+    {
+        if (canPick(board, index))
+        {
+            out.push_back(index);
+        }
+    }
+}
+
+// Shared by the memory players: `seenCharacter` holds the character each slot
+// is remembered to show, or -1.
+int chooseFromMemory(const BoardState& board, const std::vector<int>& seenCharacter, std::vector<int>& candidates, std::mt19937& random)
+{
+    const int cardCount = board.cardCount();
+
+    if (board.firstSelected >= 0)
+    {
+        // Second pick: complete the pair if its partner has been seen.
+        const int wanted = seenCharacter[static_cast<std::size_t>(board.firstSelected)];
+        for (int index = 0; index < cardCount; ++index)
+        {
+            if (index != board.firstSelected &&
+                seenCharacter[static_cast<std::size_t>(index)] == wanted &&
+                canPick(board, index))
+            {
+                return index;
+            }
+        }
+    }
+    else
+    {
+        // First pick: turn over one half of any pair that is fully known.
+        std::vector<int>& firstSeenAt = candidates;
+        firstSeenAt.assign(static_cast<std::size_t>(board.config.characterCount), -1);
+        for (int index = 0; index < cardCount; ++index)
+        {
+            const int character = seenCharacter[static_cast<std::size_t>(index)];
+            if (character < 0 || !canPick(board, index))
+            {
+                continue;
+            }
+
+            int& earlier = firstSeenAt[static_cast<std::size_t>(character)];
+            if (earlier >= 0)
+            {
+                return earlier;
+            }
+            earlier = index;
+        }
+    }
+
+    candidates.clear();
+    for (int index = 0; index < cardCount; ++index)
+    {
+        if (seenCharacter[static_cast<std::size_t>(index)] < 0 && canPick(board, index))
+        {
+            candidates.push_back(index);
+        }
+    }
+
+    if (candidates.empty())
+    {
+        collectPickable(board, candidates);
+    }
+    return pickUniform(candidates, random);
+}
+} // namespace
+
+void RandomPlayer::reset(const BoardState& board)
+{
+    candidates_.reserve(static_cast<std::size_t>(board.cardCount()));
+}
+
+int RandomPlayer::choosePick(const BoardState& board, std::mt19937& random)
+{
+    collectPickable(board, candidates_);
+    return pickUniform(candidates_, random);
+}
+
+void RandomPlayer::observe(const BoardState& /*board*/, int /*index*/)
+{
+}
+
+void PerfectMemoryPlayer::reset(const BoardState& board)
+{
+    seenCharacter_.assign(static_cast<std::size_t>(board.cardCount()), -1);
+    candidates_.reserve(static_cast<std::size_t>(board.cardCount()));
+}
+
+int PerfectMemoryPlayer::choosePick(const BoardState& board, std::mt19937& random)
+{
+    return chooseFromMemory(board, seenCharacter_, candidates_, random);
+}
+
+void PerfectMemoryPlayer::observe(const BoardState& board, int index)
+{
+    seenCharacter_[static_cast<std::size_t>(index)] = board.characterIndex[static_cast<std::size_t>(index)];
+}
+
+BoundedMemoryPlayer::BoundedMemoryPlayer(std::size_t capacity) :
+    capacity_(capacity)
+{
+}
+
+void BoundedMemoryPlayer::reset(const BoardState& board)
+{
+    seenCharacter_.assign(static_cast<std::size_t>(board.cardCount()), -1);
+    remembered_.clear();
+    remembered_.reserve(capacity_ + 1U);
+    candidates_.reserve(static_cast<std::size_t>(board.cardCount()));
+}
+
+int BoundedMemoryPlayer::choosePick(const BoardState& board, std::mt19937& random)
+{
+    return chooseFromMemory(board, seenCharacter_, candidates_, random);
+}
+
+void BoundedMemoryPlayer::observe(const BoardState& board, int index)
+{
+    // Matched cards leave the board, so they stop taking up memory.
+    const auto gone = [this, &board](int slot)
+    {
+        const CardState state = board.state[static_cast<std::size_t>(slot)];
+        if (state != CardState::Matched && state != CardState::Removed)
+        {
+            return false;
+        }
+        seenCharacter_[static_cast<std::size_t>(slot)] = -1;
+        return true;
+    };
+    remembered_.erase(std::remove_if(remembered_.begin(), remembered_.end(), gone), remembered_.end());
+
+    // Seeing a remembered card again refreshes it.
+    remembered_.erase(std::remove(remembered_.begin(), remembered_.end(), index), remembered_.end());
+    remembered_.push_back(index);
+    seenCharacter_[static_cast<std::size_t>(index)] = board.characterIndex[static_cast<std::size_t>(index)];
+
+    if (remembered_.size() > capacity_)
+    {
+        seenCharacter_[static_cast<std::size_t>(remembered_.front())] = -1;
+        remembered_.erase(remembered_.begin());
+    }
+}
+
+ScriptedPlayer::ScriptedPlayer(std::vector<int> script) :
+    script_(std::move(script))
+{
+}
+
+void ScriptedPlayer::reset(const BoardState& board)
+{
+    cursor_ = 0;
+    candidates_.reserve(static_cast<std::size_t>(board.cardCount()));
+}
+
+int ScriptedPlayer::choosePick(const BoardState& board, std::mt19937& random)
+{
+    while (cursor_ < script_.size())
+    {
+        const int index = script_[cursor_++];
+        if (canPick(board, index))
+        {
+            return index;
+        }
+    }
+
+    collectPickable(board, candidates_);
+    return pickUniform(candidates_, random);
+}
+
+void ScriptedPlayer::observe(const BoardState& /*board*/, int /*index*/)
+{
+}
+
+std::unique_ptr<Player> makePlayer(std::string_view name)
+{
+    if (name == "random")
+    {
+        return std::make_unique<RandomPlayer>();
+    }
+    if (name == "perfect")
+    {
+        return std::make_unique<PerfectMemoryPlayer>();
+    }
+    if (name == "bounded")
+    {
+        return std::make_unique<BoundedMemoryPlayer>(kDefaultBoundedMemory);
+    }
+    if (name.starts_with("bounded:"))
+    {
+        const std::string_view value = name.substr(8U);
+        std::size_t capacity = 0U;
+        const auto result = std::from_chars(value.data(), value.data() + value.size(), capacity);
+        if (result.ec == std::errc() && result.ptr == value.data() + value.size())
+        {
+            return std::make_unique<BoundedMemoryPlayer>(capacity);
+        }
+    }
+    return nullptr;
+}
+
+bool playGame(BoardState& board, Player& player, std::mt19937& random, int maxMoves)
+{
+    resetBoard(board, random);
+    player.reset(board);
+
+    while (!board.won)
+    {
+        if (board.moves >= maxMoves)
+        {
+            return false;
+        }
+
+        const int index = player.choosePick(board, random);
+        const PickResult result = applyPick(board, index);
+        if (result == PickResult::Rejected)
+        {
+            return false;
+        }
+
+        player.observe(board, index);
+        if (result == PickResult::SecondCard)
+        {
+            advanceToNextDecision(board);
+        }
+    }
+    return true;
+}
+} // namespace memory
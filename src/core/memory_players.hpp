@@ -0,0 +1,97 @@
+#pragma once
+
+#include "core/memory_rules.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// Scripted and automatic pickers for headless playouts.
+namespace memory
+{
+class Player
+{
+public:
+    virtual ~Player() = default;
+
+    // Called after resetBoard() so the player can drop what it remembered.
+    virtual void reset(const BoardState& board) = 0;
+
+    // Returns the slot to pick; only called when at least one pick is legal.
+    virtual int choosePick(const BoardState& board, std::mt19937& random) = 0;
+
+    // Called after every accepted pick with the slot that was turned over.
+    virtual void observe(const BoardState& board, int index) = 0;
+};
+
+// Picks uniformly among face-down cards and remembers nothing.
+class RandomPlayer final : public Player
+{
+public:
+    void reset(const BoardState& board) override;
+    int choosePick(const BoardState& board, std::mt19937& random) override;
+    void observe(const BoardState& board, int index) override;
+
+private:
+    std::vector<int> candidates_;
+};
+
+// Remembers every card it has seen: completes a known pair whenever it can,
+// otherwise turns over a card it has never seen.
+class PerfectMemoryPlayer final : public Player
+{
+public:
+    void reset(const BoardState& board) override;
+    int choosePick(const BoardState& board, std::mt19937& random) override;
+    void observe(const BoardState& board, int index) override;
+
+private:
+    std::vector<int> seenCharacter_;
+    std::vector<int> candidates_;
+};
+
+// Plays like PerfectMemoryPlayer but only holds the `capacity` cards it saw
+// most recently; older ones are forgotten, as are cards once matched.
+class BoundedMemoryPlayer final : public Player
+{
+public:
+    explicit BoundedMemoryPlayer(std::size_t capacity);
+
+    void reset(const BoardState& board) override;
+    int choosePick(const BoardState& board, std::mt19937& random) override;
+    void observe(const BoardState& board, int index) override;
+
+private:
+    std::size_t capacity_;
+    std::vector<int> seenCharacter_;
+    std::vector<int> remembered_; // oldest first
+    std::vector<int> candidates_;
+};
+
+// Replays a fixed list of slots, skipping entries that are not pickable and
+// falling back to random picks once the script runs out.
+class ScriptedPlayer final : public Player
+{
+public:
+    explicit ScriptedPlayer(std::vector<int> script);
+
+    void reset(const BoardState& board) override;
+    int choosePick(const BoardState& board, std::mt19937& random) override;
+    void observe(const BoardState& board, int index) override;
+
+private:
+    std::vector<int> script_;
+    std::size_t cursor_ = 0;
+    std::vector<int> candidates_;
+};
+
+// Builds a player by name ("random", "perfect", "bounded" or "bounded:N" for
+// a memory of N cards, 8 by default); returns nullptr when unknown.
+std::unique_ptr<Player> makePlayer(std::string_view name);
+
+// Plays one full game on `board` with `player`, returning false if the game
+// did not finish within `maxMoves`.
+bool playGame(BoardState& board, Player& player, std::mt19937& random, int maxMoves);
+} // namespace memory
@@ -0,0 +1,497 @@
+#include "core/memory_rules.hpp"
+
+#include "core/animation_kernels.hpp"
+#include "core/seeded_random.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <numeric>
+
+namespace memory
+{
+namespace
+{
+// Added to analytic transition times so float rounding cannot leave a
+// progress value a hair below its threshold.
+constexpr float kTransitionEpsilonSeconds = 1.0e-5F;
+
+float clamp01(float value)
+{
+    return std::clamp(value, 0.0F, 1.0F);
+}
+
+std::size_t slot(int index)
+{
+    return static_cast<std::size_t>(index);
+}
+
+CardState stateAt(const BoardState& board, int index)
+{
+    return board.state[slot(index)];
+}
+
+void startAnimating(BoardState& board, int index)
+{
+    std::uint8_t& flags = board.flags[slot(index)];
+    if ((flags & kCardAnimating) == 0U)
+    {
+        flags |= kCardAnimating;
+        board.animating.push_back(index);
+    }
+    markCardDirty(board, index);
+}
+
+void startFlip(BoardState& board, int index, CardState from, CardState to)
+{
+    if (stateAt(board, index) != from)
+    {
+        return;
+    }
+
+    board.state[slot(index)] = to;
+    board.flipProgress[slot(index)] = 0.0F;
+    board.flags[slot(index)] &= static_cast<std::uint8_t>(~kCardFaceSwapped);
+    startAnimating(board, index);
+}
+
+bool isFlipping(CardState state)
+{
+    return state == CardState::FlippingToFront || state == CardState::FlippingToBack;
+}
+
+// Handles a card whose progress crossed a threshold this step; returns false
+// once its animation has finished.
+bool applyProgressEvent(BoardState& board, std::size_t i, bool reachedHalf, bool finished)
+{
+    CardState& state = board.state[i];
+    std::uint8_t& flags = board.flags[i];
+
+    if (!isFlipping(state))
+    {
+        if (state == CardState::Matched && finished)
+        {
+            board.removeProgress[i] = 1.0F;
+            state = CardState::Removed;
+        }
+        return state == CardState::Matched;
+    }
+
+    const bool toFront = (state == CardState::FlippingToFront);
+    if ((flags & kCardFaceSwapped) == 0U && reachedHalf)
+    {
+        flags = static_cast<std::uint8_t>(toFront ? (flags | kCardFrontVisible) : (flags & ~kCardFrontVisible));
+        flags |= kCardFaceSwapped;
+    }
+
+    if (finished)
+    {
+        state = toFront ? CardState::FaceUp : CardState::FaceDown;
+        flags = static_cast<std::uint8_t>(toFront ? (flags | kCardFrontVisible) : (flags & ~kCardFrontVisible));
+        board.flipProgress[i] = 1.0F;
+        return false;
+    }
+    return true;
+}
+
+// Advances every animating card in kAnimationBatch-sized batches and compacts
+// the list in place as animations finish. Only cards that cross the face swap
+// or finish leave the vector kernel for the branchy bookkeeping.
+void advanceAnimations(BoardState& board, float deltaSeconds)
+{
+    const float flipRate = deltaSeconds / kFlipDurationSeconds;
+    const float removeRate = deltaSeconds / kMatchRemoveDurationSeconds;
+
+    std::array<std::int32_t, kAnimationBatch> indices{};
+    std::array<float, kAnimationBatch> progress{};
+    std::array<float, kAnimationBatch> rate{};
+    std::size_t kept = 0;
+    for (std::size_t base = 0; base < board.animating.size(); base += kAnimationBatch)
+    {
+        const std::size_t count = std::min(kAnimationBatch, board.animating.size() - base);
+        std::uint32_t pending = 0U; // lanes that still need a reachedHalf check
+        for (std::size_t lane = 0; lane < count; ++lane)
+        {
+            const std::int32_t index = board.animating[base + lane];
+            const std::size_t i = slot(index);
+            const bool flipping = isFlipping(board.state[i]);
+            markCardDirty(board, index);
+            indices[lane] = index;
+            progress[lane] = flipping ? board.flipProgress[i] : board.removeProgress[i];
+            rate[lane] = flipping ? flipRate : (board.state[i] == CardState::Matched ? removeRate : 0.0F);
+            pending |= (flipping && (board.flags[i] & kCardFaceSwapped) == 0U) ? std::uint32_t{1} << lane : 0U;
+        }
+
+        const ProgressEvents events = advanceProgress(progress, rate, count);
+        for (std::size_t lane = 0; lane < count; ++lane)
+        {
+            const std::size_t i = slot(indices[lane]);
+            const std::uint32_t bit = std::uint32_t{1} << lane;
+            float& stored = isFlipping(board.state[i]) ? board.flipProgress[i] : board.removeProgress[i];
+            stored = progress[lane];
+
+            const bool reachedHalf = (events.reachedHalf & pending & bit) != 0U;
+            const bool finished = (events.finished & bit) != 0U;
+            const bool stillAnimating = (reachedHalf || finished || rate[lane] == 0.0F)
+                ? applyProgressEvent(board, i, reachedHalf, finished)
+                : true;
+            if (stillAnimating)
+            {
+                board.animating[kept++] = indices[lane];
+            }
+            else
+            {
+                board.flags[i] &= static_cast<std::uint8_t>(~kCardAnimating);
+            }
+        }
+    }
+    board.animating.resize(kept);
+}
+
+bool hasSelectedPair(const BoardState& board)
+{
+    return board.firstSelected >= 0 && board.secondSelected >= 0;
+}
+
+bool areSelectedCardsStableFaceUp(const BoardState& board)
+{
+    if (!hasSelectedPair(board))
+    {
+        return false;
+    }
+
+    return stateAt(board, board.firstSelected) == CardState::FaceUp &&
+           stateAt(board, board.secondSelected) == CardState::FaceUp;
+}
+
+bool selectedCardsMatch(const BoardState& board)
+{
+    if (!hasSelectedPair(board))
+    {
+        return false;
+    }
+
+    return board.characterIndex[slot(board.firstSelected)] == board.characterIndex[slot(board.secondSelected)];
+}
+
+bool areSelectedCardsResolved(const BoardState& board)
+{
+    if (!hasSelectedPair(board))
+    {
+        return false;
+    }
+
+    const CardState first = stateAt(board, board.firstSelected);
+    const CardState second = stateAt(board, board.secondSelected);
+
+    if (selectedCardsMatch(board))
+    {
+        return first == CardState::Removed && second == CardState::Removed;
+    }
+
+    return first == CardState::FaceDown && second == CardState::FaceDown;
+}
+
+void resolveCurrentPair(BoardState& board)
+{
+    if (!hasSelectedPair(board))
+    {
+        return;
+    }
+
+    if (selectedCardsMatch(board))
+    {
+        for (const int index : {board.firstSelected, board.secondSelected})
+        {
+            board.state[slot(index)] = CardState::Matched;
+            board.removeProgress[slot(index)] = 0.0F;
+            board.flags[slot(index)] |= kCardFrontVisible;
+            startAnimating(board, index);
+        }
+    }
+    else
+    {
+        startFlip(board, board.firstSelected, CardState::FaceUp, CardState::FlippingToBack);
+        startFlip(board, board.secondSelected, CardState::FaceUp, CardState::FlippingToBack);
+    }
+
+    board.pairPhase = PairPhase::Resolving;
+}
+} // namespace
+
+bool isValidConfig(const BoardConfig& config)
+{
+    return config.columns > 0 && config.rows > 0 &&
+           config.columns <= kMaxBoardSide && config.rows <= kMaxBoardSide &&
+           config.cardCount() % 2 == 0 && config.characterCount > 0 && config.revealSeconds >= 0.0F;
+}
+
+bool parsePositiveInt(std::string_view value, int& out)
+{
+    int parsed = 0;
+    const auto result = std::from_chars(value.data(), value.data() + value.size(), parsed);
+    if (result.ec != std::errc() || result.ptr != value.data() + value.size() || parsed < 1)
+    {
+        return false;
+    }
+    out = parsed;
+    return true;
+}
+
+bool parseBoardSize(std::string_view value, int& columns, int& rows)
+{
+    const std::size_t separator = value.find('x');
+    int parsedColumns = 0;
+    int parsedRows = 0;
+    if (separator == std::string_view::npos || !parsePositiveInt(value.substr(0, separator), parsedColumns) ||
+        !parsePositiveInt(value.substr(separator + 1U), parsedRows))
+    {
+        return false;
+    }
+    columns = parsedColumns;
+    rows = parsedRows;
+    return true;
+}
+
+void resetBoard(BoardState& board, std::mt19937& random)
+{
+    const std::size_t cardCount = static_cast<std::size_t>(board.config.cardCount());
+    const int characterCount = board.config.characterCount;
+
+    board.characterIndex.resize(cardCount);
+    for (std::size_t index = 0; index < cardCount; ++index)
+    {
+        board.characterIndex[index] = static_cast<std::int32_t>(static_cast<int>(index / 2U) % characterCount);
+    }
+    shuffleRange(board.characterIndex.begin(), board.characterIndex.end(), random);
+
+    board.state.assign(cardCount, CardState::FaceDown);
+    board.flags.assign(cardCount, kCardDirty);
+    board.flipProgress.assign(cardCount, 0.0F);
+    board.removeProgress.assign(cardCount, 0.0F);
+    board.animating.clear();
+    board.dirty.resize(cardCount);
+    std::iota(board.dirty.begin(), board.dirty.end(), 0);
+
+    board.firstSelected = -1;
+    board.secondSelected = -1;
+    board.pairPhase = PairPhase::Idle;
+    board.revealRemaining = 0.0F;
+    board.matchedPairs = 0;
+    board.moves = 0;
+    board.elapsedSeconds = 0.0F;
+    board.timerRunning = false;
+    board.won = false;
+}
+
+Card cardAt(const BoardState& board, int index)
+{
+    const std::size_t i = slot(index);
+    return Card{
+        board.characterIndex[i],
+        board.state[i],
+        (board.flags[i] & kCardFrontVisible) != 0U,
+        (board.flags[i] & kCardFaceSwapped) != 0U,
+        board.flipProgress[i],
+        board.removeProgress[i]};
+}
+
+bool canPick(const BoardState& board, int index)
+{
+    if (board.won || board.pairPhase != PairPhase::Idle)
+    {
+        return false;
+    }
+
+    if (index < 0 || index >= board.cardCount())
+    {
+        return false;
+    }
+
+    return stateAt(board, index) == CardState::FaceDown;
+}
+
+PickResult applyPick(BoardState& board, int index, float lateSeconds)
+{
+    if (!canPick(board, index))
+    {
+        return PickResult::Rejected;
+    }
+
+    board.timerRunning = true;
+    startFlip(board, index, CardState::FaceDown, CardState::FlippingToFront);
+    if (lateSeconds > 0.0F)
+    {
+        // Stays short of the half way so step() still performs the face swap.
+        board.flipProgress[slot(index)] = std::min(lateSeconds / kFlipDurationSeconds, 0.49F);
+    }
+
+    if (board.firstSelected < 0)
+    {
+        board.firstSelected = index;
+        return PickResult::FirstCard;
+    }
+
+    if (board.secondSelected < 0 && index != board.firstSelected)
+    {
+        board.secondSelected = index;
+        board.moves += 1;
+        board.pairPhase = PairPhase::WaitingForSecondFlip;
+        return PickResult::SecondCard;
+    }
+
+    return PickResult::Rejected;
+}
+
+void step(BoardState& board, float deltaSeconds)
+{
+    if (board.timerRunning && !board.won)
+    {
+        board.elapsedSeconds += deltaSeconds;
+    }
+
+    advanceAnimations(board, deltaSeconds);
+
+    if (board.pairPhase == PairPhase::WaitingForSecondFlip)
+    {
+        if (areSelectedCardsStableFaceUp(board))
+        {
+            board.revealRemaining = board.config.revealSeconds;
+            board.pairPhase = PairPhase::RevealWindow;
+        }
+    }
+    else if (board.pairPhase == PairPhase::RevealWindow)
+    {
+        board.revealRemaining -= deltaSeconds;
+        if (board.revealRemaining <= 0.0F)
+        {
+            resolveCurrentPair(board);
+        }
+    }
+    else if (board.pairPhase == PairPhase::Resolving)
+    {
+        if (areSelectedCardsResolved(board))
+        {
+            if (selectedCardsMatch(board))
+            {
+                board.matchedPairs += 1;
+                if (board.matchedPairs >= board.config.pairCount())
+                {
+                    board.won = true;
+                    board.timerRunning = false;
+                }
+            }
+
+            board.firstSelected = -1;
+            board.secondSelected = -1;
+            board.pairPhase = PairPhase::Idle;
+        }
+    }
+}
+
+bool isCardAnimating(const Card& card)
+{
+    return card.state == CardState::FlippingToFront ||
+           card.state == CardState::FlippingToBack ||
+           card.state == CardState::Matched;
+}
+
+bool isCardAnimating(const BoardState& board, int index)
+{
+    return (board.flags[slot(index)] & kCardAnimating) != 0U;
+}
+
+void markCardDirty(BoardState& board, int index)
+{
+    std::uint8_t& flags = board.flags[slot(index)];
+    if ((flags & kCardDirty) == 0U)
+    {
+        flags |= kCardDirty;
+        board.dirty.push_back(index);
+    }
+}
+
+void markAllCardsDirty(BoardState& board)
+{
+    for (int index = 0; index < board.cardCount(); ++index)
+    {
+        markCardDirty(board, index);
+    }
+}
+
+void takeDirtyCards(BoardState& board, std::vector<std::int32_t>& out)
+{
+    out.clear();
+    out.swap(board.dirty);
+    for (const std::int32_t index : out)
+    {
+        board.flags[slot(index)] &= static_cast<std::uint8_t>(~kCardDirty);
+    }
+}
+
+bool isAnimating(const BoardState& board)
+{
+    return board.pairPhase != PairPhase::Idle || !board.animating.empty();
+}
+
+float timeUntilNextTransition(const BoardState& board)
+{
+    float next = -1.0F;
+    const auto consider = [&next](float seconds)
+    {
+        seconds = std::max(seconds, 0.0F);
+        next = (next < 0.0F) ? seconds : std::min(next, seconds);
+    };
+
+    for (const std::int32_t index : board.animating)
+    {
+        const std::size_t i = slot(index);
+        if (board.state[i] == CardState::FlippingToFront || board.state[i] == CardState::FlippingToBack)
+        {
+            consider((1.0F - clamp01(board.flipProgress[i])) * kFlipDurationSeconds);
+        }
+        else if (board.state[i] == CardState::Matched)
+        {
+            consider((1.0F - clamp01(board.removeProgress[i])) * kMatchRemoveDurationSeconds);
+        }
+    }
+
+    switch (board.pairPhase)
+    {
+        case PairPhase::WaitingForSecondFlip:
+            if (areSelectedCardsStableFaceUp(board))
+            {
+                consider(0.0F);
+            }
+            break;
+        case PairPhase::RevealWindow:
+            consider(board.revealRemaining);
+            break;
+        case PairPhase::Resolving:
+            if (areSelectedCardsResolved(board))
+            {
+                consider(0.0F);
+            }
+            break;
+        case PairPhase::Idle:
+        default:
+            break;
+    }
+
+    return next;
+}
+
+void advanceToNextDecision(BoardState& board)
+{
+    while (!board.won && board.pairPhase != PairPhase::Idle)
+    {
+        const float seconds = timeUntilNextTransition(board);
+        if (seconds < 0.0F)
+        {
+            return;
+        }
+        step(board, seconds > 0.0F ? seconds + kTransitionEpsilonSeconds : 0.0F);
+    }
+}
+} // namespace memory
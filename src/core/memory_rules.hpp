@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// Game rules for the memory board, independent of any window or renderer.
+// The SFML client and the headless tools drive the same BoardState through
+// applyPick() and step().
+namespace memory
+{
+constexpr int kDefaultColumns = 8;
+constexpr int kDefaultRows = 4;
+constexpr int kDefaultCharacterCount = 16;
+constexpr int kMaxBoardSide = 1024;
+
+constexpr float kFlipDurationSeconds = 0.22F;
+constexpr float kRevealDurationSeconds = 2.0F;
+constexpr float kMatchRemoveDurationSeconds = 0.20F;
+
+enum class CardState : std::uint8_t
+{
+    FaceDown,
+    FlippingToFront,
+    FaceUp,
+    FlippingToBack,
+    Matched,
+    Removed
+};
+
+enum class PairPhase
+{
+    Idle,
+    WaitingForSecondFlip,
+    RevealWindow,
+    Resolving
+};
+
+// Board dimensions, chosen at startup. Pair p shows character
+// p % characterCount, so boards larger than the deck repeat characters and
+// any two cards showing the same character match.
+struct BoardConfig
+{
+    int columns = kDefaultColumns;
+    int rows = kDefaultRows;
+    int characterCount = kDefaultCharacterCount;
+    // How long a mismatched pair stays face up; tunable for balancing runs.
+    float revealSeconds = kRevealDurationSeconds;
+
+    int cardCount() const { return columns * rows; }
+    int pairCount() const { return cardCount() / 2; }
+};
+
+// True for a non-empty board with an even card count, at least one character
+// and a non-negative reveal time.
+bool isValidConfig(const BoardConfig& config);
+
+// Command-line parsing shared by the game and the tools. False, leaving the
+// outputs alone, unless every number is a whole number of at least 1 with
+// nothing around it.
+bool parsePositiveInt(std::string_view value, int& out);
+// "COLUMNSxROWS".
+bool parseBoardSize(std::string_view value, int& columns, int& rows);
+
+// Bits in BoardState::flags.
+constexpr std::uint8_t kCardFrontVisible = 1U << 0U;
+constexpr std::uint8_t kCardFaceSwapped = 1U << 1U;
+constexpr std::uint8_t kCardDirty = 1U << 2U;     // listed in BoardState::dirty
+constexpr std::uint8_t kCardAnimating = 1U << 3U; // listed in BoardState::animating
+
+// Value snapshot of one slot, assembled from the board's arrays.
+struct Card
+{
+    int characterIndex = 0;
+    CardState state = CardState::FaceDown;
+    bool frontVisible = false;
+    bool flipFaceSwapped = false;
+    float flipProgress = 0.0F;
+    float removeProgress = 0.0F;
+};
+
+// Cards are stored as parallel arrays indexed by slot. step() only visits the
+// active-animation list, so its cost follows activity rather than board size.
+struct BoardState
+{
+    BoardConfig config;
+    std::vector<std::int32_t> characterIndex;
+    std::vector<CardState> state;
+    std::vector<std::uint8_t> flags;
+    std::vector<float> flipProgress;
+    std::vector<float> removeProgress;
+
+    // Slots mid-flip or fading out after a match.
+    std::vector<std::int32_t> animating;
+    // Slots whose drawn appearance changed since a renderer last called takeDirtyCards().
+    std::vector<std::int32_t> dirty;
+
+    PairPhase pairPhase = PairPhase::Idle;
+    int firstSelected = -1;
+    int secondSelected = -1;
+    float revealRemaining = 0.0F;
+    int moves = 0;
+    int matchedPairs = 0;
+    float elapsedSeconds = 0.0F;
+    bool timerRunning = false;
+    bool won = false;
+
+    int cardCount() const { return static_cast<int>(state.size()); }
+};
+
+enum class PickResult
+{
+    Rejected,
+    FirstCard,
+    SecondCard
+};
+
+// Deals a freshly shuffled board sized from board.config and clears all counters.
+void resetBoard(BoardState& board, std::mt19937& random);
+
+Card cardAt(const BoardState& board, int index);
+
+// True when a pick on `index` would be accepted right now.
+bool canPick(const BoardState& board, int index);
+
+// Flips the card at `index` if the rules allow it. The second accepted pick
+// of a pair counts as a move and starts the reveal sequence. A pick that
+// happened `lateSeconds` ago starts its flip that far along, up to the half way.
+PickResult applyPick(BoardState& board, int index, float lateSeconds = 0.0F);
+
+// Advances animations, the reveal window and pair resolution by `deltaSeconds`.
+void step(BoardState& board, float deltaSeconds);
+
+// True while the card is mid-flip or fading out after a match.
+bool isCardAnimating(const Card& card);
+bool isCardAnimating(const BoardState& board, int index);
+
+void markCardDirty(BoardState& board, int index);
+void markAllCardsDirty(BoardState& board);
+
+// Swaps the dirty list into `out` (its old contents are discarded) and clears
+// the per-card dirty flags.
+void takeDirtyCards(BoardState& board, std::vector<std::int32_t>& out);
+
+// True while any card animates or a pair is still being revealed/resolved.
+bool isAnimating(const BoardState& board);
+
+// Seconds until the next state transition step() would make; 0 when one is
+// due immediately and a negative value when nothing is pending.
+float timeUntilNextTransition(const BoardState& board);
+
+// Steps exactly from transition to transition until picks are accepted again
+// (or the game is won). Used by headless playouts that do not need frames.
+void advanceToNextDecision(BoardState& board);
+} // namespace memory
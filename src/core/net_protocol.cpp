@@ -0,0 +1,334 @@
+#include "core/net_protocol.hpp"
+
+#include <bit>
+
+namespace memory
+{
+namespace
+{
+void putU8(std::string& out, std::uint8_t value)
+{
+    out.push_back(static_cast<char>(value));
+}
+
+void putU16(std::string& out, std::uint16_t value)
+{
+    out.push_back(static_cast<char>(value & 0xFFU));
+    out.push_back(static_cast<char>((value >> 8U) & 0xFFU));
+}
+
+void putF32(std::string& out, float value)
+{
+    const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+    for (unsigned int shift = 0; shift < 32U; shift += 8U)
+    {
+        out.push_back(static_cast<char>((bits >> shift) & 0xFFU));
+    }
+}
+
+void putVarint(std::string& out, std::uint64_t value)
+{
+    while (value >= 0x80U)
+    {
+        out.push_back(static_cast<char>((value & 0x7FU) | 0x80U));
+        value >>= 7U;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Frames are written in place: the length is patched in once the payload is.
+std::size_t beginFrame(std::string& out, NetMessageType type)
+{
+    const std::size_t start = out.size();
+    putU16(out, 0U);
+    putU8(out, static_cast<std::uint8_t>(type));
+    return start;
+}
+
+void endFrame(std::string& out, std::size_t start)
+{
+    const std::size_t length = out.size() - start - kNetFrameHeaderBytes;
+    out[start] = static_cast<char>(length & 0xFFU);
+    out[start + 1U] = static_cast<char>((length >> 8U) & 0xFFU);
+}
+
+class PayloadReader
+{
+public:
+    explicit PayloadReader(std::string_view bytes) :
+        bytes_(bytes)
+    {
+    }
+
+    bool atEnd() const
+    {
+        return offset_ >= bytes_.size();
+    }
+
+    bool readU8(std::uint8_t& value)
+    {
+        if (atEnd())
+        {
+            return false;
+        }
+        value = static_cast<std::uint8_t>(bytes_[offset_++]);
+        return true;
+    }
+
+    bool readU16(std::uint16_t& value)
+    {
+        std::uint8_t low = 0;
+        std::uint8_t high = 0;
+        if (!readU8(low) || !readU8(high))
+        {
+            return false;
+        }
+        value = static_cast<std::uint16_t>(low | (high << 8U));
+        return true;
+    }
+
+    bool readF32(float& value)
+    {
+        std::uint32_t bits = 0;
+        for (unsigned int shift = 0; shift < 32U; shift += 8U)
+        {
+            std::uint8_t byte = 0;
+            if (!readU8(byte))
+            {
+                return false;
+            }
+            bits |= static_cast<std::uint32_t>(byte) << shift;
+        }
+        value = std::bit_cast<float>(bits);
+        return true;
+    }
+
+    bool readVarint(std::uint64_t& value)
+    {
+        value = 0;
+        for (unsigned int shift = 0; shift < 64U; shift += 7U)
+        {
+            std::uint8_t byte = 0;
+            if (!readU8(byte))
+            {
+                return false;
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+            if ((byte & 0x80U) == 0U)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // A varint that must fit in [0, limit].
+    template <typename T>
+    bool readVarint(T& value, std::uint64_t limit)
+    {
+        std::uint64_t raw = 0;
+        if (!readVarint(raw) || raw > limit)
+        {
+            return false;
+        }
+        value = static_cast<T>(raw);
+        return true;
+    }
+
+private:
+    std::string_view bytes_;
+    std::size_t offset_ = 0;
+};
+
+constexpr std::uint8_t kCharacterFollows = 0x80U;
+constexpr std::uint64_t kMaxCounter = 0x7FFFFFFFU;
+} // namespace
+
+bool showsFace(CardState state)
+{
+    return state == CardState::FlippingToFront || state == CardState::FaceUp ||
+           state == CardState::FlippingToBack || state == CardState::Matched;
+}
+
+void appendHello(std::string& out)
+{
+    const std::size_t start = beginFrame(out, NetMessageType::Hello);
+    putU16(out, kNetProtocolVersion);
+    endFrame(out, start);
+}
+
+void appendPick(std::string& out, const NetPick& pick)
+{
+    const std::size_t start = beginFrame(out, NetMessageType::Pick);
+    putVarint(out, pick.sequence);
+    putVarint(out, static_cast<std::uint64_t>(pick.slot));
+    endFrame(out, start);
+}
+
+void appendMatchStart(std::string& out, const NetMatchStart& matchStart)
+{
+    const std::size_t start = beginFrame(out, NetMessageType::MatchStart);
+    putVarint(out, matchStart.match);
+    putU8(out, matchStart.seat);
+    putU16(out, static_cast<std::uint16_t>(matchStart.board.columns));
+    putU16(out, static_cast<std::uint16_t>(matchStart.board.rows));
+    putVarint(out, static_cast<std::uint64_t>(matchStart.board.characterCount));
+    putF32(out, matchStart.board.revealSeconds);
+    endFrame(out, start);
+}
+
+void appendBoardDelta(std::string& out, const NetBoardDelta& delta)
+{
+    const std::size_t start = beginFrame(out, NetMessageType::BoardDelta);
+    putVarint(out, delta.tick);
+    putVarint(out, delta.ackedPick);
+    putU8(out, delta.turn);
+    putVarint(out, static_cast<std::uint64_t>(delta.moves));
+    putVarint(out, static_cast<std::uint64_t>(delta.matchedPairs));
+    for (const std::int32_t score : delta.scores)
+    {
+        putVarint(out, static_cast<std::uint64_t>(score));
+    }
+
+    putVarint(out, delta.cards.size());
+    std::int32_t next = 0;
+    for (const NetCardChange& change : delta.cards)
+    {
+        putVarint(out, static_cast<std::uint64_t>(change.slot - next));
+        const bool face = change.character >= 0;
+        putU8(out, static_cast<std::uint8_t>(static_cast<std::uint8_t>(change.state) | (face ? kCharacterFollows : 0U)));
+        if (face)
+        {
+            putVarint(out, static_cast<std::uint64_t>(change.character));
+        }
+        next = change.slot + 1;
+    }
+    endFrame(out, start);
+}
+
+void appendMatchEnd(std::string& out, const NetMatchEnd& end)
+{
+    const std::size_t start = beginFrame(out, NetMessageType::MatchEnd);
+    putU8(out, end.winner);
+    putU8(out, static_cast<std::uint8_t>(end.reason));
+    endFrame(out, start);
+}
+
+FrameStatus peekFrame(std::string_view bytes, NetFrame& frame)
+{
+    if (bytes.size() < kNetFrameHeaderBytes)
+    {
+        return FrameStatus::Incomplete;
+    }
+
+    const std::size_t length = static_cast<std::uint8_t>(bytes[0]) | (static_cast<std::size_t>(static_cast<std::uint8_t>(bytes[1])) << 8U);
+    const std::uint8_t type = static_cast<std::uint8_t>(bytes[2]);
+    if (type != static_cast<std::uint8_t>(NetMessageType::Hello) &&
+        type != static_cast<std::uint8_t>(NetMessageType::Pick) &&
+        type != static_cast<std::uint8_t>(NetMessageType::MatchStart) &&
+        type != static_cast<std::uint8_t>(NetMessageType::BoardDelta) &&
+        type != static_cast<std::uint8_t>(NetMessageType::MatchEnd))
+    {
+        return FrameStatus::Malformed;
+    }
+    if (bytes.size() < kNetFrameHeaderBytes + length)
+    {
+        return FrameStatus::Incomplete;
+    }
+
+    frame.type = static_cast<NetMessageType>(type);
+    frame.payload = bytes.substr(kNetFrameHeaderBytes, length);
+    frame.size = kNetFrameHeaderBytes + length;
+    return FrameStatus::Ready;
+}
+
+bool decodeHello(std::string_view payload, std::uint16_t& version)
+{
+    PayloadReader reader(payload);
+    return reader.readU16(version);
+}
+
+bool decodePick(std::string_view payload, NetPick& pick)
+{
+    PayloadReader reader(payload);
+    return reader.readVarint(pick.sequence, 0xFFFFFFFFU) && reader.readVarint(pick.slot, kMaxCounter);
+}
+
+bool decodeMatchStart(std::string_view payload, NetMatchStart& start)
+{
+    PayloadReader reader(payload);
+    std::uint16_t columns = 0;
+    std::uint16_t rows = 0;
+    if (!reader.readVarint(start.match, 0xFFFFFFFFU) || !reader.readU8(start.seat) ||
+        !reader.readU16(columns) || !reader.readU16(rows) ||
+        !reader.readVarint(start.board.characterCount, kMaxCounter) || !reader.readF32(start.board.revealSeconds))
+    {
+        return false;
+    }
+    start.board.columns = columns;
+    start.board.rows = rows;
+    return start.seat < kSeatCount && isValidConfig(start.board);
+}
+
+bool decodeBoardDelta(std::string_view payload, int cardCount, NetBoardDelta& delta)
+{
+    PayloadReader reader(payload);
+    if (!reader.readVarint(delta.tick, 0xFFFFFFFFU) || !reader.readVarint(delta.ackedPick, 0xFFFFFFFFU) ||
+        !reader.readU8(delta.turn) || !reader.readVarint(delta.moves, kMaxCounter) ||
+        !reader.readVarint(delta.matchedPairs, kMaxCounter))
+    {
+        return false;
+    }
+    for (std::int32_t& score : delta.scores)
+    {
+        if (!reader.readVarint(score, kMaxCounter))
+        {
+            return false;
+        }
+    }
+
+    std::size_t count = 0;
+    if (!reader.readVarint(count, static_cast<std::uint64_t>(cardCount)))
+    {
+        return false;
+    }
+    delta.cards.resize(count);
+    std::uint64_t next = 0;
+    for (NetCardChange& change : delta.cards)
+    {
+        std::uint64_t gap = 0;
+        std::uint8_t code = 0;
+        if (!reader.readVarint(gap) || !reader.readU8(code))
+        {
+            return false;
+        }
+        const std::uint8_t state = static_cast<std::uint8_t>(code & ~kCharacterFollows);
+        if (gap >= static_cast<std::uint64_t>(cardCount) - next || state > static_cast<std::uint8_t>(CardState::Removed))
+        {
+            return false;
+        }
+        change.slot = static_cast<std::int32_t>(next + gap);
+        change.state = static_cast<CardState>(state);
+        change.character = -1;
+        if ((code & kCharacterFollows) != 0U && !reader.readVarint(change.character, kMaxCounter))
+        {
+            return false;
+        }
+        next = static_cast<std::uint64_t>(change.slot) + 1U;
+    }
+    return delta.turn < kSeatCount && reader.atEnd();
+}
+
+bool decodeMatchEnd(std::string_view payload, NetMatchEnd& end)
+{
+    PayloadReader reader(payload);
+    std::uint8_t reason = 0;
+    if (!reader.readU8(end.winner) || !reader.readU8(reason) ||
+        reason > static_cast<std::uint8_t>(NetEndReason::OpponentLeft))
+    {
+        return false;
+    }
+    end.reason = static_cast<NetEndReason>(reason);
+    return end.winner < kSeatCount || end.winner == kNoSeat;
+}
+} // namespace memory
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "core/memory_rules.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Wire format between memory_server and its clients. A match is two seats
+// taking turns on one board: a matched pair scores and keeps the turn, a
+// miss hands it over. Clients only ever send picks; the server answers with
+// deltas carrying the cards whose CardState changed and the counters.
+//
+// Frame (little-endian): u16 payload length, u8 message type, payload.
+//   Hello:      u16 protocol version; asks to be queued for the next match
+//   Pick:       varint pick sequence (from 1, increasing), varint slot
+//   MatchStart: varint match id, u8 seat, u16 columns, u16 rows,
+//               varint character count, f32 reveal seconds
+//   BoardDelta: varint server tick, varint last pick sequence handled for
+//               the receiving seat, u8 seat to move, varint moves, varint
+//               matched pairs, varint score per seat, varint change count,
+//               then per change: varint slot gap from the previous change + 1,
+//               u8 CardState (bit 7: a varint character index follows, sent
+//               whenever the card shows its face)
+//   MatchEnd:   u8 winning seat (kNoSeat for a draw), u8 NetEndReason
+namespace memory
+{
+constexpr std::uint16_t kNetProtocolVersion = 1;
+constexpr std::uint16_t kDefaultServerPort = 47474;
+constexpr std::size_t kNetFrameHeaderBytes = 3U;
+constexpr std::size_t kMaxNetPayloadBytes = 0xFFFFU;
+constexpr std::size_t kSeatCount = 2U;
+constexpr std::uint8_t kNoSeat = 0xFFU;
+
+enum class NetMessageType : std::uint8_t
+{
+    Hello = 1,
+    Pick = 2,
+    MatchStart = 16,
+    BoardDelta = 17,
+    MatchEnd = 18
+};
+
+enum class NetEndReason : std::uint8_t
+{
+    BoardCleared = 0,
+    OpponentLeft = 1
+};
+
+struct NetPick
+{
+    std::uint32_t sequence = 0;
+    std::int32_t slot = -1;
+};
+
+struct NetMatchStart
+{
+    std::uint32_t match = 0;
+    std::uint8_t seat = 0;
+    BoardConfig board;
+};
+
+struct NetCardChange
+{
+    std::int32_t slot = 0;
+    CardState state = CardState::FaceDown;
+    std::int32_t character = -1; // -1 while the card hides its face
+};
+
+struct NetBoardDelta
+{
+    std::uint32_t tick = 0;
+    std::uint32_t ackedPick = 0;
+    std::uint8_t turn = 0;
+    std::int32_t moves = 0;
+    std::int32_t matchedPairs = 0;
+    std::array<std::int32_t, kSeatCount> scores{};
+    std::vector<NetCardChange> cards; // ascending slots
+};
+
+struct NetMatchEnd
+{
+    std::uint8_t winner = kNoSeat;
+    NetEndReason reason = NetEndReason::BoardCleared;
+};
+
+// True for the states in which a card shows its face, and so its character.
+bool showsFace(CardState state);
+
+// Each appends one whole frame to `out`.
+void appendHello(std::string& out);
+void appendPick(std::string& out, const NetPick& pick);
+void appendMatchStart(std::string& out, const NetMatchStart& start);
+void appendBoardDelta(std::string& out, const NetBoardDelta& delta);
+void appendMatchEnd(std::string& out, const NetMatchEnd& end);
+
+enum class FrameStatus
+{
+    Incomplete,
+    Ready,
+    Malformed
+};
+
+struct NetFrame
+{
+    NetMessageType type = NetMessageType::Hello;
+    std::string_view payload;
+    std::size_t size = 0; // bytes the whole frame occupies
+};
+
+// Splits the first frame off `bytes`; Incomplete until all of it has arrived.
+FrameStatus peekFrame(std::string_view bytes, NetFrame& frame);
+
+// Each returns false for a truncated or out-of-range payload. A delta's card
+// list is only checked against `cardCount`, so decode into a reused value.
+bool decodeHello(std::string_view payload, std::uint16_t& version);
+bool decodePick(std::string_view payload, NetPick& pick);
+bool decodeMatchStart(std::string_view payload, NetMatchStart& start);
+bool decodeBoardDelta(std::string_view payload, int cardCount, NetBoardDelta& delta);
+bool decodeMatchEnd(std::string_view payload, NetMatchEnd& end);
+} // namespace memory
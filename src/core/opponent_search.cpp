@@ -0,0 +1,174 @@
+#include "core/opponent_search.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace memory
+{
+namespace
+{
+// Also bounds the recursion; boards too large to finish within it are
+// played from the deepest estimate.
+constexpr int kMaxDepth = 512;
+constexpr std::uint32_t kClockCheckInterval = 1024U;
+
+std::uint64_t positionKey(int pairs, int known)
+{
+    return (static_cast<std::uint64_t>(pairs) << 32U) | static_cast<std::uint32_t>(known);
+}
+} // namespace
+
+OpponentSearch::OpponentSearch(std::size_t maxEntries) :
+    maxEntries_(std::max<std::size_t>(maxEntries, 1U))
+{
+}
+
+bool OpponentSearch::search(int pairs, int known, Clock::time_point deadline)
+{
+    if (pairs != rootPairs_ || known != rootKnown_)
+    {
+        rootPairs_ = pairs;
+        rootKnown_ = known;
+        completedDepth_ = 0;
+        exact_ = pairs <= 0;
+        policy_ = SolverPolicy{};
+        value_ = 0.0;
+        const auto stored = table_.find(positionKey(pairs, known));
+        if (stored != table_.end())
+        {
+            completedDepth_ = stored->second.depth;
+            exact_ = stored->second.exact;
+            policy_ = stored->second.policy;
+            value_ = stored->second.value;
+        }
+    }
+
+    deadline_ = deadline;
+    untilClockCheck_ = 0;
+    while (!exact_ && completedDepth_ < kMaxDepth && Clock::now() < deadline_)
+    {
+        timedOut_ = false;
+        cutOff_ = false;
+        // Doubling keeps the re-searched shallower depths a small share of the work.
+        const int depth = std::min(std::max(completedDepth_ * 2, completedDepth_ + 1), kMaxDepth);
+        const double value = evaluate(pairs, known, depth);
+        if (std::isnan(value))
+        {
+            break;
+        }
+        const Entry& entry = table_[positionKey(pairs, known)];
+        completedDepth_ = entry.depth;
+        exact_ = entry.exact;
+        policy_ = entry.policy;
+        value_ = value;
+    }
+    return exact_;
+}
+
+double OpponentSearch::evaluate(int pairs, int known, int depth)
+{
+    if (pairs <= 0)
+    {
+        return 0.0;
+    }
+
+    const double unseen = static_cast<double>(2 * pairs - known);
+    const auto stored = table_.find(positionKey(pairs, known));
+    if (stored != table_.end() && (stored->second.exact || stored->second.depth >= depth))
+    {
+        cutOff_ = cutOff_ || !stored->second.exact;
+        return stored->second.value;
+    }
+    if (depth <= 0)
+    {
+        // Chance that the next card turned completes a known single.
+        cutOff_ = true;
+        return static_cast<double>(known) / unseen;
+    }
+    if (untilClockCheck_ == 0U)
+    {
+        untilClockCheck_ = kClockCheckInterval;
+        timedOut_ = timedOut_ || Clock::now() >= deadline_;
+    }
+    --untilClockCheck_;
+    if (timedOut_)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // Whether this position's own subtree was searched to the end.
+    const bool outerCutOff = cutOff_;
+    cutOff_ = false;
+
+    const int next = depth - 1;
+    const double k = static_cast<double>(known);
+    const double fresh = static_cast<double>(2 * (pairs - known));
+    Entry entry;
+
+    // Scoring keeps the turn (+1 and our value); a miss hands the position to
+    // the opponent (minus theirs), and a miss that reveals a full pair hands
+    // them that pair too.
+    double openUnseen = 0.0;
+    double afterMatch = 0.0;
+    if (known > 0)
+    {
+        afterMatch = 1.0 + evaluate(pairs - 1, known - 1, next);
+        openUnseen += (k / unseen) * afterMatch;
+    }
+    if (pairs > known)
+    {
+        const double rest = unseen - 1.0;
+        const double paired = 1.0 + evaluate(pairs - 1, known, next);
+        double secondUnseen = (1.0 / rest) * paired - (k / rest) * paired;
+        if (fresh - 2.0 > 0.0)
+        {
+            secondUnseen -= ((fresh - 2.0) / rest) * evaluate(pairs, known + 2, next);
+        }
+
+        double second = secondUnseen;
+        if (known > 0)
+        {
+            // Turning a known single reveals one card to the opponent, not two.
+            const double secondKnown = -evaluate(pairs, known + 1, next);
+            if (secondKnown > secondUnseen)
+            {
+                second = secondKnown;
+                entry.policy.secondPickKnown = true;
+            }
+        }
+        openUnseen += (fresh / unseen) * second;
+    }
+
+    double best = openUnseen;
+    if (known > 0)
+    {
+        double openKnown = (1.0 / unseen) * afterMatch - ((k - 1.0) / unseen) * afterMatch;
+        if (pairs > known)
+        {
+            openKnown -= (fresh / unseen) * evaluate(pairs, known + 1, next);
+        }
+        if (openKnown > openUnseen)
+        {
+            best = openKnown;
+            entry.policy.openWithKnown = true;
+        }
+    }
+
+    if (timedOut_)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    entry.value = static_cast<float>(best);
+    entry.depth = static_cast<std::uint16_t>(depth);
+    entry.exact = !cutOff_;
+    cutOff_ = outerCutOff || cutOff_;
+    if (table_.size() >= maxEntries_)
+    {
+        table_.clear();
+    }
+    table_[positionKey(pairs, known)] = entry;
+    return best;
+}
+} // namespace memory
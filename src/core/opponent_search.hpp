@@ -0,0 +1,69 @@
+#pragma once
+
+#include "core/optimal_solver.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+// Expectimax for the two-seat game: a matched pair scores and keeps the
+// turn, a miss hands it over. Like OptimalSolver, a position is summarised
+// by (pairs left on the table, pairs with exactly one card known), with
+// every fully known pair assumed taken at once; both seats are assumed to
+// know the same cards. Values are the expected pairs the seat to move wins
+// over its opponent from here on.
+//
+// Positions only ever lose pairs or gain known cards, so the search is
+// over a DAG. It deepens one move at a time and keeps what it learns in a
+// table keyed by position alone, which stays valid across turns and deals:
+// a new turn's root is usually a child of the last one and is already
+// searched most of the way. Work cut short by a deadline is not lost either,
+// since every position finished before it stays in the table.
+namespace memory
+{
+class OpponentSearch
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit OpponentSearch(std::size_t maxEntries = std::size_t{1} << 20U);
+
+    // Deepens the search at (pairs, known) until it is exact or `deadline`
+    // passes; returns true once it is exact. Later calls for the same root
+    // carry on from the depth reached.
+    bool search(int pairs, int known, Clock::time_point deadline);
+
+    // Best play at the last searched root; the greedy policy until its first
+    // depth completes.
+    const SolverPolicy& policy() const { return policy_; }
+    double value() const { return value_; }
+    int depth() const { return completedDepth_; }
+
+private:
+    struct Entry
+    {
+        float value = 0.0F;
+        std::uint16_t depth = 0;
+        bool exact = false;
+        SolverPolicy policy;
+    };
+
+    // The value of (pairs, known) searched `depth` moves deep, or NaN once
+    // the deadline has passed.
+    double evaluate(int pairs, int known, int depth);
+
+    std::size_t maxEntries_;
+    std::unordered_map<std::uint64_t, Entry> table_;
+    Clock::time_point deadline_{};
+    std::uint32_t untilClockCheck_ = 0;
+    bool timedOut_ = false;
+    bool cutOff_ = false; // a leaf was estimated during the current depth
+
+    int rootPairs_ = -1;
+    int rootKnown_ = -1;
+    int completedDepth_ = 0;
+    bool exact_ = false;
+    SolverPolicy policy_;
+    double value_ = 0.0;
+};
+} // namespace memory
@@ -0,0 +1,106 @@
+#include "core/optimal_solver.hpp"
+
+#include <algorithm>
+
+namespace memory
+{
+OptimalSolver::OptimalSolver(int maxPairs) :
+    maxPairs_(std::max(maxPairs, 0))
+{
+    const std::size_t size = static_cast<std::size_t>(maxPairs_ + 1) * static_cast<std::size_t>(maxPairs_ + 1);
+    optimal_.assign(size, 0.0);
+    greedy_.assign(size, 0.0);
+    policy_.assign(size, SolverPolicy{});
+
+    for (int pairs = 1; pairs <= maxPairs_; ++pairs)
+    {
+        for (int known = pairs; known >= 0; --known)
+        {
+            const double unseen = static_cast<double>(2 * pairs - known);
+            const double k = static_cast<double>(known);
+            const double fresh = static_cast<double>(2 * (pairs - known));
+
+            // Both tables share these shapes; `value` reads one of them.
+            const auto evaluate = [&](const std::vector<double>& value, bool allowKnown, SolverPolicy& chosen)
+            {
+                const auto at = [&](int p, int q) { return value[index(p, q)]; };
+
+                // Open with an unseen card.
+                double openUnseen = 0.0;
+                if (known > 0)
+                {
+                    openUnseen += (k / unseen) * (1.0 + at(pairs - 1, known - 1));
+                }
+                if (pairs > known)
+                {
+                    const double rest = unseen - 1.0;
+                    double secondUnseen = (1.0 / rest) * (1.0 + at(pairs - 1, known))
+                                          + (k / rest) * (2.0 + at(pairs - 1, known));
+                    if (fresh - 2.0 > 0.0)
+                    {
+                        secondUnseen += ((fresh - 2.0) / rest) * (1.0 + at(pairs, known + 2));
+                    }
+
+                    double second = secondUnseen;
+                    chosen.secondPickKnown = false;
+                    if (allowKnown && known > 0)
+                    {
+                        const double secondKnown = 1.0 + at(pairs, known + 1);
+                        if (secondKnown < secondUnseen)
+                        {
+                            second = secondKnown;
+                            chosen.secondPickKnown = true;
+                        }
+                    }
+                    openUnseen += (fresh / unseen) * second;
+                }
+
+                chosen.openWithKnown = false;
+                if (!allowKnown || known == 0)
+                {
+                    return openUnseen;
+                }
+
+                // Open with a known single, then turn an unseen card.
+                double openKnown = (1.0 / unseen) * (1.0 + at(pairs - 1, known - 1))
+                                   + ((k - 1.0) / unseen) * (2.0 + at(pairs - 1, known - 1));
+                if (pairs > known)
+                {
+                    openKnown += (fresh / unseen) * (1.0 + at(pairs, known + 1));
+                }
+
+                if (openKnown < openUnseen)
+                {
+                    chosen.openWithKnown = true;
+                    return openKnown;
+                }
+                return openUnseen;
+            };
+
+            SolverPolicy greedyPolicy;
+            greedy_[index(pairs, known)] = evaluate(greedy_, false, greedyPolicy);
+            optimal_[index(pairs, known)] = evaluate(optimal_, true, policy_[index(pairs, known)]);
+        }
+    }
+}
+
+double OptimalSolver::expectedMoves(int pairs, int known) const
+{
+    return optimal_[index(pairs, known)];
+}
+
+double OptimalSolver::expectedGreedyMoves(int pairs, int known) const
+{
+    return greedy_[index(pairs, known)];
+}
+
+const SolverPolicy& OptimalSolver::policy(int pairs, int known) const
+{
+    return policy_[index(pairs, known)];
+}
+
+std::size_t OptimalSolver::index(int pairs, int known) const
+{
+    return static_cast<std::size_t>(pairs) * static_cast<std::size_t>(maxPairs_ + 1) + static_cast<std::size_t>(known);
+}
+} // namespace memory
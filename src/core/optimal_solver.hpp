@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Exact expected move counts for a solo player with perfect memory.
+//
+// With every fully known pair cleared first, a position is summarised by
+// (pairs left on the table, pairs with exactly one card seen). A move either
+// opens with an unseen card or with a known one, and after an unseen card
+// that matches nothing the second pick is either another unseen card or a
+// known one. The table is filled bottom-up; transitions only lower the pair
+// count or raise the known count, so no position depends on itself.
+namespace memory
+{
+struct SolverPolicy
+{
+    bool openWithKnown = false;    // turn over a known single first
+    bool secondPickKnown = false;  // after a new unseen card, turn a known single next
+};
+
+class OptimalSolver
+{
+public:
+    explicit OptimalSolver(int maxPairs);
+
+    int maxPairs() const { return maxPairs_; }
+
+    // Expected remaining moves with optimal play / with the greedy perfect-memory
+    // policy (always open unseen, always pick unseen second).
+    double expectedMoves(int pairs, int known) const;
+    double expectedGreedyMoves(int pairs, int known) const;
+
+    const SolverPolicy& policy(int pairs, int known) const;
+
+private:
+    std::size_t index(int pairs, int known) const;
+
+    int maxPairs_ = 0;
+    std::vector<double> optimal_;
+    std::vector<double> greedy_;
+    std::vector<SolverPolicy> policy_;
+};
+} // namespace memory
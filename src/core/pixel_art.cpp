@@ -0,0 +1,277 @@
+#include "core/pixel_art.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace memory
+{
+namespace
+{
+constexpr float kCardAspect = 3.0F / 4.0F;
+
+struct CropBox
+{
+    unsigned int x = 0;
+    unsigned int y = 0;
+    unsigned int width = 0;
+    unsigned int height = 0;
+};
+
+CropBox centreCrop(unsigned int width, unsigned int height)
+{
+    CropBox box{0U, 0U, width, height};
+    if (static_cast<float>(width) / static_cast<float>(height) > kCardAspect)
+    {
+        box.width = std::max(1U, static_cast<unsigned int>(static_cast<float>(height) * kCardAspect));
+        box.x = (width - box.width) / 2U;
+    }
+    else
+    {
+        box.height = std::max(1U, static_cast<unsigned int>(static_cast<float>(width) / kCardAspect));
+        box.y = (height - box.height) / 2U;
+    }
+    return box;
+}
+
+// Source column (or row) of every destination one, sampling at pixel centres.
+std::vector<unsigned int> nearestIndices(unsigned int sourceSize, unsigned int offset, unsigned int size)
+{
+    std::vector<unsigned int> indices(size);
+    const double scale = static_cast<double>(sourceSize) / static_cast<double>(size);
+    for (unsigned int index = 0; index < size; ++index)
+    {
+        const unsigned int source = static_cast<unsigned int>((static_cast<double>(index) + 0.5) * scale);
+        indices[index] = offset + std::min(source, sourceSize - 1U);
+    }
+    return indices;
+}
+
+// A nearest-neighbour resize is a gather of whole 32-bit texels.
+RgbaImage resizeNearest(const std::uint8_t* pixels, unsigned int stride, const CropBox& box, unsigned int width, unsigned int height)
+{
+    const std::vector<unsigned int> columns = nearestIndices(box.width, box.x, width);
+    const std::vector<unsigned int> rows = nearestIndices(box.height, box.y, height);
+
+    RgbaImage out;
+    out.width = width;
+    out.height = height;
+    out.pixels.resize(static_cast<std::size_t>(width) * height * 4U);
+    for (unsigned int y = 0; y < height; ++y)
+    {
+        const std::uint8_t* row = pixels + static_cast<std::size_t>(rows[y]) * stride * 4U;
+        std::uint8_t* target = out.pixels.data() + static_cast<std::size_t>(y) * width * 4U;
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            std::copy_n(row + static_cast<std::size_t>(columns[x]) * 4U, 4U, target + static_cast<std::size_t>(x) * 4U);
+        }
+    }
+    return out;
+}
+
+struct ColorCount
+{
+    std::array<std::uint8_t, 3> rgb{};
+    std::uint32_t count = 0;
+};
+
+struct ColorBox
+{
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    int channel = 0; // widest channel
+    int range = 0;   // its extent; 0 cannot be split
+};
+
+void measure(const std::vector<ColorCount>& colors, ColorBox& box)
+{
+    std::array<int, 3> low{255, 255, 255};
+    std::array<int, 3> high{0, 0, 0};
+    for (std::size_t index = box.begin; index < box.end; ++index)
+    {
+        for (std::size_t channel = 0; channel < 3U; ++channel)
+        {
+            low[channel] = std::min<int>(low[channel], colors[index].rgb[channel]);
+            high[channel] = std::max<int>(high[channel], colors[index].rgb[channel]);
+        }
+    }
+    box.range = -1;
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        const int range = high[static_cast<std::size_t>(channel)] - low[static_cast<std::size_t>(channel)];
+        if (range > box.range)
+        {
+            box.range = range;
+            box.channel = channel;
+        }
+    }
+    if (box.end - box.begin < 2U)
+    {
+        box.range = 0;
+    }
+}
+
+// Median cut over the distinct colours, weighted by how often each occurs.
+// Palette entries are stored per channel so the nearest-colour search below
+// is a straight loop the compiler vectorises.
+struct Palette
+{
+    std::vector<int> r;
+    std::vector<int> g;
+    std::vector<int> b;
+};
+
+Palette medianCut(const RgbaImage& image, unsigned int maximumColors)
+{
+    std::vector<std::uint32_t> packed(static_cast<std::size_t>(image.width) * image.height);
+    for (std::size_t index = 0; index < packed.size(); ++index)
+    {
+        const std::uint8_t* texel = image.pixels.data() + index * 4U;
+        packed[index] = (static_cast<std::uint32_t>(texel[0]) << 16U) | (static_cast<std::uint32_t>(texel[1]) << 8U) | texel[2];
+    }
+    std::sort(packed.begin(), packed.end());
+
+    std::vector<ColorCount> colors;
+    for (std::size_t index = 0; index < packed.size();)
+    {
+        std::size_t next = index;
+        while (next < packed.size() && packed[next] == packed[index])
+        {
+            ++next;
+        }
+        const std::uint32_t value = packed[index];
+        colors.push_back(ColorCount{
+            {static_cast<std::uint8_t>(value >> 16U), static_cast<std::uint8_t>(value >> 8U), static_cast<std::uint8_t>(value)},
+            static_cast<std::uint32_t>(next - index)});
+        index = next;
+    }
+
+    std::vector<ColorBox> boxes{ColorBox{0U, colors.size()}};
+    measure(colors, boxes.front());
+    while (boxes.size() < maximumColors)
+    {
+        const auto widest = std::max_element(
+            boxes.begin(),
+            boxes.end(),
+            [](const ColorBox& left, const ColorBox& right) { return left.range < right.range; });
+        if (widest->range <= 0)
+        {
+            break;
+        }
+
+        const ColorBox box = *widest;
+        const std::size_t channel = static_cast<std::size_t>(box.channel);
+        std::sort(
+            colors.begin() + static_cast<std::ptrdiff_t>(box.begin),
+            colors.begin() + static_cast<std::ptrdiff_t>(box.end),
+            [channel](const ColorCount& left, const ColorCount& right) { return left.rgb[channel] < right.rgb[channel]; });
+
+        std::uint64_t total = 0;
+        for (std::size_t index = box.begin; index < box.end; ++index)
+        {
+            total += colors[index].count;
+        }
+        std::uint64_t seen = 0;
+        std::size_t split = box.begin + 1U;
+        for (std::size_t index = box.begin; index + 1U < box.end; ++index)
+        {
+            seen += colors[index].count;
+            split = index + 1U;
+            if (seen * 2U >= total)
+            {
+                break;
+            }
+        }
+
+        *widest = ColorBox{box.begin, split};
+        measure(colors, *widest);
+        ColorBox upper{split, box.end};
+        measure(colors, upper);
+        boxes.push_back(upper);
+    }
+
+    Palette palette;
+    for (const ColorBox& box : boxes)
+    {
+        std::array<std::uint64_t, 3> sum{};
+        std::uint64_t count = 0;
+        for (std::size_t index = box.begin; index < box.end; ++index)
+        {
+            for (std::size_t channel = 0; channel < 3U; ++channel)
+            {
+                sum[channel] += static_cast<std::uint64_t>(colors[index].rgb[channel]) * colors[index].count;
+            }
+            count += colors[index].count;
+        }
+        palette.r.push_back(static_cast<int>((sum[0] + count / 2U) / count));
+        palette.g.push_back(static_cast<int>((sum[1] + count / 2U) / count));
+        palette.b.push_back(static_cast<int>((sum[2] + count / 2U) / count));
+    }
+    return palette;
+}
+
+void mapToPalette(RgbaImage& image, const Palette& palette)
+{
+    const std::size_t entries = palette.r.size();
+    std::vector<int> distance(entries);
+    for (std::size_t texel = 0; texel < image.pixels.size(); texel += 4U)
+    {
+        const int r = image.pixels[texel];
+        const int g = image.pixels[texel + 1U];
+        const int b = image.pixels[texel + 2U];
+        for (std::size_t entry = 0; entry < entries; ++entry)
+        {
+            const int dr = palette.r[entry] - r;
+            const int dg = palette.g[entry] - g;
+            const int db = palette.b[entry] - b;
+            distance[entry] = dr * dr + dg * dg + db * db;
+        }
+        const std::size_t nearest = static_cast<std::size_t>(std::min_element(distance.begin(), distance.end()) - distance.begin());
+        image.pixels[texel] = static_cast<std::uint8_t>(palette.r[nearest]);
+        image.pixels[texel + 1U] = static_cast<std::uint8_t>(palette.g[nearest]);
+        image.pixels[texel + 2U] = static_cast<std::uint8_t>(palette.b[nearest]);
+        image.pixels[texel + 3U] = 255U;
+    }
+}
+} // namespace
+
+bool isValidPixelArtSettings(const PixelArtSettings& settings)
+{
+    return settings.height > 0U && settings.pixelHeight > 0U && settings.pixelHeight <= settings.height &&
+           settings.colors >= 2U && settings.colors <= 256U;
+}
+
+RgbaImage makePixelArt(const std::uint8_t* pixels, unsigned int width, unsigned int height, const PixelArtSettings& settings)
+{
+    if (width == 0U || height == 0U || !isValidPixelArtSettings(settings))
+    {
+        return RgbaImage{};
+    }
+
+    const auto cardWidth = [](unsigned int cardHeight)
+    {
+        return std::max(1U, static_cast<unsigned int>(std::lround(static_cast<float>(cardHeight) * kCardAspect)));
+    };
+
+    RgbaImage grid = resizeNearest(pixels, width, centreCrop(width, height), cardWidth(settings.pixelHeight), settings.pixelHeight);
+    mapToPalette(grid, medianCut(grid, settings.colors));
+    return resizeNearest(
+        grid.pixels.data(), grid.width, CropBox{0U, 0U, grid.width, grid.height}, cardWidth(settings.height), settings.height);
+}
+
+std::uint64_t contentHash(std::span<const std::uint8_t> bytes, std::uint64_t hash)
+{
+    for (const std::uint8_t byte : bytes)
+    {
+        hash = (hash ^ byte) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+std::uint64_t contentHash(std::string_view text, std::uint64_t hash)
+{
+    return contentHash(std::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(text.data()), text.size()), hash);
+}
+} // namespace memory
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "core/texture_tiers.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// The card-art look: centre-crop a source image to the 3:4 card shape,
+// nearest-neighbour it down to a coarse pixel grid, reduce that grid to a
+// small median-cut palette and blow it back up to the processed size. Works
+// on tightly packed RGBA8; the processed image is fully opaque.
+namespace memory
+{
+struct PixelArtSettings
+{
+    unsigned int height = 256;     // processed card height; width is 3/4 of it
+    unsigned int pixelHeight = 64; // height of the coarse pixel grid
+    unsigned int colors = 28;      // palette size, at least 2
+};
+
+bool isValidPixelArtSettings(const PixelArtSettings& settings);
+
+RgbaImage makePixelArt(const std::uint8_t* pixels, unsigned int width, unsigned int height, const PixelArtSettings& settings);
+
+// 64-bit FNV-1a, for telling whether a source changed since it was processed.
+constexpr std::uint64_t kContentHashSeed = 0xCBF29CE484222325ULL;
+std::uint64_t contentHash(std::span<const std::uint8_t> bytes, std::uint64_t hash = kContentHashSeed);
+std::uint64_t contentHash(std::string_view text, std::uint64_t hash = kContentHashSeed);
+} // namespace memory
@@ -0,0 +1,261 @@
+#include "core/remote_board.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace memory
+{
+namespace
+{
+// Where a predicted flip waits for the server to reveal its face; applyPick()
+// uses the same bound for late clicks.
+constexpr float kHiddenFaceHoldProgress = 0.49F;
+
+std::size_t slotOf(int index)
+{
+    return static_cast<std::size_t>(index);
+}
+
+bool isFlipping(CardState state)
+{
+    return state == CardState::FlippingToFront || state == CardState::FlippingToBack;
+}
+
+// True when the drawn state is an animation already heading for `confirmed`.
+bool settlesInto(CardState drawn, CardState confirmed)
+{
+    return (drawn == CardState::FlippingToFront && confirmed == CardState::FaceUp) ||
+           (drawn == CardState::FlippingToBack && confirmed == CardState::FaceDown) ||
+           (drawn == CardState::Matched && confirmed == CardState::Removed);
+}
+} // namespace
+
+void RemoteBoard::start(const NetMatchStart& match)
+{
+    const std::size_t cardCount = static_cast<std::size_t>(match.board.cardCount());
+    board_.config = match.board;
+    board_.characterIndex.assign(cardCount, -1);
+    board_.state.assign(cardCount, CardState::FaceDown);
+    board_.flags.assign(cardCount, 0U);
+    board_.flipProgress.assign(cardCount, 0.0F);
+    board_.removeProgress.assign(cardCount, 0.0F);
+    board_.animating.clear();
+    board_.dirty.clear();
+    markAllCardsDirty(board_);
+    board_.pairPhase = PairPhase::Idle;
+    board_.firstSelected = -1;
+    board_.secondSelected = -1;
+    board_.moves = 0;
+    board_.matchedPairs = 0;
+    board_.elapsedSeconds = 0.0F;
+    board_.timerRunning = false;
+    board_.won = false;
+
+    confirmed_.assign(cardCount, CardState::FaceDown);
+    predicted_.clear();
+    nextSequence_ = 1;
+    match_ = match.match;
+    seat_ = match.seat;
+    turn_ = 0;
+    scores_ = {};
+}
+
+bool RemoteBoard::canPick(int slot) const
+{
+    if (!myTurn() || board_.won || slot < 0 || slot >= board_.cardCount())
+    {
+        return false;
+    }
+    if (confirmed_[slotOf(slot)] != CardState::FaceDown || board_.state[slotOf(slot)] != CardState::FaceDown)
+    {
+        return false;
+    }
+
+    // The server takes picks while at most one card of the pair is turned
+    // and nothing is flipping back or fading out.
+    int turned = 0;
+    for (const CardState state : board_.state)
+    {
+        if (state == CardState::FlippingToBack || state == CardState::Matched)
+        {
+            return false;
+        }
+        turned += (state == CardState::FlippingToFront || state == CardState::FaceUp) ? 1 : 0;
+    }
+    return turned < 2;
+}
+
+std::optional<NetPick> RemoteBoard::pick(int slot)
+{
+    if (!canPick(slot))
+    {
+        return std::nullopt;
+    }
+
+    setState(slot, CardState::FlippingToFront);
+    board_.timerRunning = true;
+    predicted_.push_back(PredictedPick{nextSequence_, slot});
+    return NetPick{nextSequence_++, slot};
+}
+
+void RemoteBoard::applyDelta(const NetBoardDelta& delta)
+{
+    turn_ = delta.turn;
+    board_.moves = delta.moves;
+    board_.matchedPairs = delta.matchedPairs;
+    board_.won = delta.matchedPairs >= board_.config.pairCount();
+    for (std::size_t seat = 0; seat < kSeatCount; ++seat)
+    {
+        scores_[seat] = delta.scores[seat];
+    }
+
+    for (const NetCardChange& change : delta.cards)
+    {
+        const std::size_t card = slotOf(change.slot);
+        confirmed_[card] = change.state;
+        if (change.character >= 0)
+        {
+            board_.characterIndex[card] = change.character;
+        }
+        board_.timerRunning = true;
+
+        // A local animation already on its way there finishes on its own.
+        const CardState drawn = board_.state[card];
+        if (drawn != change.state && !settlesInto(drawn, change.state))
+        {
+            setState(change.slot, change.state);
+        }
+        markCardDirty(board_, change.slot);
+    }
+
+    // A pick the server has handled without turning the card was refused.
+    std::size_t kept = 0;
+    for (const PredictedPick& predicted : predicted_)
+    {
+        if (predicted.sequence > delta.ackedPick)
+        {
+            predicted_[kept++] = predicted;
+            continue;
+        }
+        if (confirmed_[slotOf(predicted.slot)] == CardState::FaceDown && board_.state[slotOf(predicted.slot)] != CardState::FaceDown)
+        {
+            setState(predicted.slot, CardState::FaceDown);
+        }
+    }
+    predicted_.resize(kept);
+}
+
+void RemoteBoard::step(float deltaSeconds)
+{
+    if (board_.timerRunning && !board_.won)
+    {
+        board_.elapsedSeconds += deltaSeconds;
+    }
+
+    const float flipStep = deltaSeconds / kFlipDurationSeconds;
+    const float removeStep = deltaSeconds / kMatchRemoveDurationSeconds;
+    std::size_t kept = 0;
+    for (const std::int32_t index : board_.animating)
+    {
+        const std::size_t card = slotOf(index);
+        CardState& state = board_.state[card];
+        std::uint8_t& flags = board_.flags[card];
+        markCardDirty(board_, index);
+
+        bool animating = true;
+        if (isFlipping(state))
+        {
+            const bool toFront = state == CardState::FlippingToFront;
+            float& progress = board_.flipProgress[card];
+            progress = std::min(progress + flipStep, 1.0F);
+            if (toFront && board_.characterIndex[card] < 0)
+            {
+                progress = std::min(progress, kHiddenFaceHoldProgress);
+            }
+            if (progress >= 0.5F && (flags & kCardFaceSwapped) == 0U)
+            {
+                flags = static_cast<std::uint8_t>(toFront ? (flags | kCardFrontVisible) : (flags & ~kCardFrontVisible));
+                flags |= kCardFaceSwapped;
+            }
+            if (progress >= 1.0F)
+            {
+                state = toFront ? CardState::FaceUp : CardState::FaceDown;
+                animating = false;
+            }
+        }
+        else if (state == CardState::Matched)
+        {
+            float& progress = board_.removeProgress[card];
+            progress = std::min(progress + removeStep, 1.0F);
+            if (progress >= 1.0F)
+            {
+                state = CardState::Removed;
+                animating = false;
+            }
+        }
+        else
+        {
+            animating = false;
+        }
+
+        if (animating)
+        {
+            board_.animating[kept++] = index;
+        }
+        else
+        {
+            flags &= static_cast<std::uint8_t>(~kCardAnimating);
+        }
+    }
+    board_.animating.resize(kept);
+}
+
+void RemoteBoard::setState(int slot, CardState state)
+{
+    const std::size_t card = slotOf(slot);
+    std::uint8_t& flags = board_.flags[card];
+    board_.state[card] = state;
+    flags &= static_cast<std::uint8_t>(~kCardFaceSwapped);
+    switch (state)
+    {
+        case CardState::FlippingToFront:
+            board_.flipProgress[card] = 0.0F;
+            flags &= static_cast<std::uint8_t>(~kCardFrontVisible);
+            startAnimating(slot);
+            break;
+        case CardState::FlippingToBack:
+            board_.flipProgress[card] = 0.0F;
+            flags |= kCardFrontVisible;
+            startAnimating(slot);
+            break;
+        case CardState::Matched:
+            board_.removeProgress[card] = 0.0F;
+            flags |= kCardFrontVisible;
+            startAnimating(slot);
+            break;
+        case CardState::FaceUp:
+            board_.flipProgress[card] = 1.0F;
+            flags |= kCardFrontVisible;
+            break;
+        case CardState::Removed:
+            board_.removeProgress[card] = 1.0F;
+            break;
+        case CardState::FaceDown:
+        default:
+            board_.flipProgress[card] = 0.0F;
+            flags &= static_cast<std::uint8_t>(~kCardFrontVisible);
+            break;
+    }
+    markCardDirty(board_, slot);
+}
+
+void RemoteBoard::startAnimating(int slot)
+{
+    std::uint8_t& flags = board_.flags[slotOf(slot)];
+    if ((flags & kCardAnimating) == 0U)
+    {
+        flags |= kCardAnimating;
+        board_.animating.push_back(slot);
+    }
+}
+} // namespace memory
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "core/memory_rules.hpp"
+#include "core/net_protocol.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Client-side mirror of a networked match. The server's card states arrive as
+// deltas and flips animate locally between them, so board() can be drawn
+// like a local BoardState. A pick is predicted: its flip starts at once
+// rather than a round trip later, and is rolled back if the server refuses
+// it. Until the server reveals the face, a predicted flip holds just short of
+// its half way, where the face would become visible.
+namespace memory
+{
+class RemoteBoard
+{
+public:
+    void start(const NetMatchStart& match);
+
+    // Predicts a pick of `slot`; returns the message to send, or std::nullopt
+    // when the server would refuse it anyway.
+    std::optional<NetPick> pick(int slot);
+    void applyDelta(const NetBoardDelta& delta);
+    void step(float deltaSeconds);
+
+    // Card states as drawn, predictions included; characterIndex is -1 for
+    // cards that have not shown their face yet.
+    const BoardState& board() const { return board_; }
+    // Card states as last confirmed by the server.
+    CardState confirmedState(int slot) const { return confirmed_[static_cast<std::size_t>(slot)]; }
+    bool canPick(int slot) const;
+    bool myTurn() const { return turn_ == seat_; }
+    std::uint8_t seat() const { return seat_; }
+    std::uint32_t match() const { return match_; }
+    int score(std::size_t seat) const { return scores_[seat]; }
+    std::size_t pendingPicks() const { return predicted_.size(); }
+
+private:
+    struct PredictedPick
+    {
+        std::uint32_t sequence = 0;
+        std::int32_t slot = -1;
+    };
+
+    void setState(int slot, CardState state);
+    void startAnimating(int slot);
+
+    BoardState board_;
+    std::vector<CardState> confirmed_;
+    std::vector<PredictedPick> predicted_;
+    std::uint32_t nextSequence_ = 1;
+    std::uint32_t match_ = 0;
+    std::uint8_t seat_ = 0;
+    std::uint8_t turn_ = 0;
+    std::array<int, kSeatCount> scores_{};
+};
+} // namespace memory
@@ -0,0 +1,26 @@
+#include "core/seeded_random.hpp"
+
+namespace memory
+{
+std::uint32_t uniformBelow(std::mt19937& random, std::uint32_t bound)
+{
+    std::uint64_t product = static_cast<std::uint64_t>(static_cast<std::uint32_t>(random())) * bound;
+    auto low = static_cast<std::uint32_t>(product);
+    if (low < bound)
+    {
+        // Rejects the 2^32 mod bound low products that would bias the result.
+        const std::uint32_t threshold = (0U - bound) % bound;
+        while (low < threshold)
+        {
+            product = static_cast<std::uint64_t>(static_cast<std::uint32_t>(random())) * bound;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+    return static_cast<std::uint32_t>(product >> 32U);
+}
+
+float uniformUnit(std::mt19937& random)
+{
+    return static_cast<float>(static_cast<std::uint32_t>(random()) >> 8U) * (1.0F / 16777216.0F);
+}
+} // namespace memory
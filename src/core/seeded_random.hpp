@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <utility>
+
+// Draws taken straight from std::mt19937 output. The engine's sequence is
+// fixed by the standard, but std::shuffle and the std:: distributions are
+// not, so a seed only reproduces a deal across standard libraries when every
+// deal and pick goes through these instead.
+namespace memory
+{
+// Uniform in [0, bound) by Lemire's multiply-and-reject; `bound` must be non-zero.
+std::uint32_t uniformBelow(std::mt19937& random, std::uint32_t bound);
+
+// Uniform in [0, 1), from the top 24 bits of one output.
+float uniformUnit(std::mt19937& random);
+
+// Fisher-Yates from the back, one uniformBelow() per position.
+template <typename RandomIt>
+void shuffleRange(RandomIt first, RandomIt last, std::mt19937& random)
+{
+    const auto count = static_cast<std::uint32_t>(std::distance(first, last));
+    for (std::uint32_t index = count; index > 1U; --index)
+    {
+        using std::swap;
+        swap(first[index - 1U], first[uniformBelow(random, index)]);
+    }
+}
+} // namespace memory
@@ -0,0 +1,56 @@
+#include "core/telemetry_format.hpp"
+
+#include <algorithm>
+
+namespace memory
+{
+namespace
+{
+void putVarint(std::string& out, std::uint64_t value)
+{
+    while (value >= 0x80U)
+    {
+        out.push_back(static_cast<char>((value & 0x7FU) | 0x80U));
+        value >>= 7U;
+    }
+    out.push_back(static_cast<char>(value));
+}
+} // namespace
+
+std::size_t telemetryFrameBucket(std::uint32_t frameMicros)
+{
+    return static_cast<std::size_t>(
+        std::lower_bound(kTelemetryFrameBucketMicros.begin(), kTelemetryFrameBucketMicros.end(), frameMicros) -
+        kTelemetryFrameBucketMicros.begin());
+}
+
+void appendTelemetryBatch(std::string& out, const TelemetryBatchHeader& header, std::span<const TelemetryEvent> events)
+{
+    out.append("MGTL");
+    out.push_back(static_cast<char>(kTelemetryVersion));
+    putVarint(out, header.session);
+    putVarint(out, header.sequence);
+    putVarint(out, header.dropped);
+    putVarint(out, events.size());
+
+    std::uint64_t previous = 0;
+    for (const TelemetryEvent& event : events)
+    {
+        std::size_t count = kTelemetryValueCount;
+        while (count > 0U && event.values[count - 1U] == 0U)
+        {
+            --count;
+        }
+
+        out.push_back(static_cast<char>(event.type));
+        putVarint(out, event.micros - std::min(previous, event.micros));
+        out.push_back(static_cast<char>(event.board));
+        out.push_back(static_cast<char>(count));
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            putVarint(out, event.values[index]);
+        }
+        previous = event.micros;
+    }
+}
+} // namespace memory
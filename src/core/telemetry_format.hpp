@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+// Gameplay and frame-time telemetry. Events are fixed-size so a producer can
+// copy them into a ring without allocating; the exporter packs them into
+// batches that only spend bytes on what an event actually says.
+//
+// Batch (little-endian): "MGTL", u8 version, varint session id, varint batch
+// sequence, varint events dropped since the previous batch, varint event
+// count, then per event in time order: u8 type, varint microseconds since
+// the previous event (since session start for the first), u8 board, u8 value
+// count n (trailing zero values are not stored), n varint values.
+//
+// Values by type:
+//   GameStart, GameReset: deck, columns, rows; a reset adds the abandoned
+//                         game's moves and elapsed milliseconds
+//   Pick:                 slot, 1 for the first card of a pair or 2 for the second
+//   Match, Mismatch:      first slot, second slot, first card's character, moves
+//   Win:                  moves, elapsed milliseconds
+//   FrameTimes:           frames per kTelemetryFrameBucketMicros bucket, since
+//                         the previous FrameTimes event
+namespace memory
+{
+constexpr std::uint8_t kTelemetryVersion = 1;
+constexpr std::size_t kTelemetryValueCount = 13;
+
+enum class TelemetryEventType : std::uint8_t
+{
+    GameStart = 1,
+    GameReset = 2,
+    Pick = 3,
+    Match = 4,
+    Mismatch = 5,
+    Win = 6,
+    FrameTimes = 7
+};
+
+struct TelemetryEvent
+{
+    std::uint64_t micros = 0; // since the session started
+    TelemetryEventType type = TelemetryEventType::GameStart;
+    std::uint8_t board = 0;
+    std::array<std::uint32_t, kTelemetryValueCount> values{};
+};
+
+static_assert(sizeof(TelemetryEvent) == 64U, "telemetry events should stay one cache line");
+
+// Upper bounds of the frame-time buckets; the last bucket takes the rest.
+constexpr std::array<std::uint32_t, kTelemetryValueCount - 1U> kTelemetryFrameBucketMicros{
+    2000U, 4000U, 6000U, 8000U, 10000U, 12000U, 14000U, 16667U, 20000U, 25000U, 33333U, 50000U};
+
+std::size_t telemetryFrameBucket(std::uint32_t frameMicros);
+
+struct TelemetryBatchHeader
+{
+    std::uint64_t session = 0;
+    std::uint64_t sequence = 0;
+    std::uint64_t dropped = 0;
+};
+
+// Appends one batch; `events` must be sorted by time.
+void appendTelemetryBatch(std::string& out, const TelemetryBatchHeader& header, std::span<const TelemetryEvent> events);
+} // namespace memory
@@ -0,0 +1,73 @@
+#include "core/texture_tiers.hpp"
+
+#include <algorithm>
+
+namespace memory
+{
+unsigned int chooseTextureDivisor(unsigned int sourceHeight, float displayHeight)
+{
+    unsigned int chosen = kTextureTierDivisors.front();
+    for (const unsigned int divisor : kTextureTierDivisors)
+    {
+        if (sourceHeight / divisor > 0U && static_cast<float>(sourceHeight / divisor) >= displayHeight)
+        {
+            chosen = divisor;
+        }
+    }
+    return chosen;
+}
+
+std::string textureTierName(std::string_view name, unsigned int divisor)
+{
+    std::string tierName(name);
+    if (divisor > 1U)
+    {
+        tierName += '@';
+        tierName += std::to_string(divisor);
+    }
+    return tierName;
+}
+
+RgbaImage downsampleRgba(const std::uint8_t* pixels, unsigned int width, unsigned int height, unsigned int divisor)
+{
+    divisor = std::max(divisor, 1U);
+    RgbaImage out;
+    out.width = width / divisor;
+    out.height = height / divisor;
+    out.pixels.resize(static_cast<std::size_t>(out.width) * out.height * 4U);
+
+    const std::uint32_t blockSize = divisor * divisor;
+    for (unsigned int y = 0; y < out.height; ++y)
+    {
+        for (unsigned int x = 0; x < out.width; ++x)
+        {
+            std::uint32_t red = 0;
+            std::uint32_t green = 0;
+            std::uint32_t blue = 0;
+            std::uint32_t alpha = 0;
+            for (unsigned int dy = 0; dy < divisor; ++dy)
+            {
+                const std::uint8_t* row = pixels + (static_cast<std::size_t>(y * divisor + dy) * width + x * divisor) * 4U;
+                for (unsigned int dx = 0; dx < divisor; ++dx)
+                {
+                    const std::uint8_t* texel = row + dx * 4U;
+                    red += static_cast<std::uint32_t>(texel[0]) * texel[3];
+                    green += static_cast<std::uint32_t>(texel[1]) * texel[3];
+                    blue += static_cast<std::uint32_t>(texel[2]) * texel[3];
+                    alpha += texel[3];
+                }
+            }
+
+            std::uint8_t* target = out.pixels.data() + (static_cast<std::size_t>(y) * out.width + x) * 4U;
+            if (alpha > 0U)
+            {
+                target[0] = static_cast<std::uint8_t>((red + alpha / 2U) / alpha);
+                target[1] = static_cast<std::uint8_t>((green + alpha / 2U) / alpha);
+                target[2] = static_cast<std::uint8_t>((blue + alpha / 2U) / alpha);
+            }
+            target[3] = static_cast<std::uint8_t>((alpha + blockSize / 2U) / blockSize);
+        }
+    }
+    return out;
+}
+} // namespace memory
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Reduced-resolution copies of the card art. Each tier divides the processed
+// image's size by a power of two; the game loads the smallest tier that is
+// still at least as tall as a card on screen, so textures are at most
+// minified by 2x and never upscaled further than the source already is.
+namespace memory
+{
+constexpr std::array<unsigned int, 3> kTextureTierDivisors{{1U, 2U, 4U}};
+
+// Largest tier divisor that keeps `sourceHeight` at or above `displayHeight`.
+unsigned int chooseTextureDivisor(unsigned int sourceHeight, float displayHeight);
+
+// Pack entry name of one tier: `name` itself for divisor 1, "name@2" etc. otherwise.
+std::string textureTierName(std::string_view name, unsigned int divisor);
+
+struct RgbaImage
+{
+    unsigned int width = 0;
+    unsigned int height = 0;
+    std::vector<std::uint8_t> pixels;
+};
+
+// Box-filters tightly packed RGBA8 pixels down by `divisor`, weighting colour
+// by alpha so transparent texels do not darken edges. A remainder of rows or
+// columns that does not fill a whole block is dropped.
+RgbaImage downsampleRgba(const std::uint8_t* pixels, unsigned int width, unsigned int height, unsigned int divisor);
+} // namespace memory
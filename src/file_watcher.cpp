@@ -0,0 +1,157 @@
+#include "file_watcher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <system_error>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+// How often the watch thread looks at its stop token while no events arrive.
+constexpr int kStopCheckMilliseconds = 200;
+#else
+constexpr std::chrono::milliseconds kScanInterval{500};
+#endif
+} // namespace
+
+FileWatcher::FileWatcher(std::vector<std::filesystem::path> directories) :
+    directories_(std::move(directories))
+{
+#ifdef __linux__
+    inotify_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_ < 0)
+    {
+        std::cerr << "Warning: cannot watch for file changes (inotify unavailable)\n";
+        return;
+    }
+    for (const std::filesystem::path& directory : directories_)
+    {
+        // Editors and exporters that save by renaming a temporary file show
+        // up as IN_MOVED_TO rather than IN_CLOSE_WRITE.
+        const int watch = ::inotify_add_watch(inotify_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watch < 0)
+        {
+            std::cerr << "Warning: cannot watch " << directory.string() << " for changes\n";
+            continue;
+        }
+        watches_[watch] = directory;
+    }
+#else
+    scan(false);
+#endif
+    thread_ = std::jthread([this](const std::stop_token& stopToken) { watchLoop(stopToken); });
+}
+
+FileWatcher::~FileWatcher()
+{
+    if (thread_.joinable())
+    {
+        thread_.request_stop();
+        thread_.join();
+    }
+#ifdef __linux__
+    if (inotify_ >= 0)
+    {
+        ::close(inotify_);
+    }
+#endif
+}
+
+void FileWatcher::poll(std::vector<std::filesystem::path>& out)
+{
+    out.clear();
+    {
+        const std::lock_guard lock(changedMutex_);
+        out.swap(changed_);
+    }
+    // A save can touch a file several times; report it once.
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void FileWatcher::report(std::filesystem::path path)
+{
+    const std::lock_guard lock(changedMutex_);
+    changed_.push_back(std::move(path));
+}
+
+#ifdef __linux__
+void FileWatcher::watchLoop(const std::stop_token& stopToken)
+{
+    if (inotify_ < 0)
+    {
+        return;
+    }
+    alignas(inotify_event) char buffer[4096];
+    while (!stopToken.stop_requested())
+    {
+        pollfd descriptor{inotify_, POLLIN, 0};
+        if (::poll(&descriptor, 1, kStopCheckMilliseconds) <= 0)
+        {
+            continue;
+        }
+        const ssize_t length = ::read(inotify_, buffer, sizeof(buffer));
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            const auto watch = watches_.find(event->wd);
+            if (event->len == 0U || watch == watches_.end())
+            {
+                continue;
+            }
+            report(watch->second / event->name);
+        }
+    }
+}
+#else
+void FileWatcher::watchLoop(const std::stop_token& stopToken)
+{
+    std::mutex sleepMutex;
+    std::condition_variable_any sleep;
+    while (!stopToken.stop_requested())
+    {
+        {
+            std::unique_lock lock(sleepMutex);
+            sleep.wait_for(lock, stopToken, kScanInterval, [] { return false; });
+        }
+        scan(true);
+    }
+}
+
+void FileWatcher::scan(bool reportChanges)
+{
+    for (const std::filesystem::path& directory : directories_)
+    {
+        std::error_code error;
+        for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+        {
+            std::error_code stampError;
+            const std::filesystem::file_time_type stamp = it->last_write_time(stampError);
+            if (stampError || !it->is_regular_file(stampError))
+            {
+                continue;
+            }
+            const std::filesystem::path path = directory / it->path().filename();
+            auto [known, inserted] = stamps_.try_emplace(path, stamp);
+            if (!inserted && known->second == stamp)
+            {
+                continue;
+            }
+            known->second = stamp;
+            if (reportChanges)
+            {
+                report(path);
+            }
+        }
+    }
+}
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+// Reports files written or moved into a set of directories (not their
+// subdirectories) from a background thread. Linux uses inotify, which only
+// reports a file once its writer has closed it; elsewhere the directories
+// are rescanned for new modification times twice a second.
+class FileWatcher
+{
+public:
+    explicit FileWatcher(std::vector<std::filesystem::path> directories);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Moves the files changed since the last call into `out` (its old
+    // contents are discarded), each as directory / file name. Never blocks
+    // on the file system.
+    void poll(std::vector<std::filesystem::path>& out);
+
+private:
+    void watchLoop(const std::stop_token& stopToken);
+    void report(std::filesystem::path path);
+
+    std::vector<std::filesystem::path> directories_;
+    std::mutex changedMutex_;
+    std::vector<std::filesystem::path> changed_;
+
+#ifdef __linux__
+    int inotify_ = -1;
+    std::map<int, std::filesystem::path> watches_; // watch descriptor -> directory
+#else
+    void scan(bool reportChanges);
+    std::map<std::filesystem::path, std::filesystem::file_time_type> stamps_;
+#endif
+
+    std::jthread thread_;
+};
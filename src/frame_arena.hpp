@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+// Bump allocator for data that lives for one frame. Allocation is a pointer
+// bump into a block reserved up front and deallocation does nothing; reset()
+// at the start of the next frame reclaims everything at once. A frame that
+// outgrows the block falls back to the heap, which the steady-state
+// allocation check then reports.
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+    explicit FrameArena(std::size_t capacity) :
+        buffer_(std::make_unique<std::byte[]>(capacity)),
+        capacity_(capacity)
+    {
+    }
+
+    void reset() { used_ = 0; }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(buffer_.get());
+        const std::size_t start = static_cast<std::size_t>(((base + used_ + alignment - 1U) & ~(alignment - 1U)) - base);
+        if (start + bytes > capacity_)
+        {
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        used_ = start + bytes;
+        return buffer_.get() + start;
+    }
+
+    void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override
+    {
+        const std::byte* pointer = static_cast<const std::byte*>(memory);
+        if (pointer < buffer_.get() || pointer >= buffer_.get() + capacity_)
+        {
+            std::pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::unique_ptr<std::byte[]> buffer_;
+    std::size_t capacity_ = 0;
+    std::size_t used_ = 0;
+};
@@ -0,0 +1,212 @@
+#include "frame_profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+float toMilliseconds(FrameProfiler::Clock::duration elapsed)
+{
+    return std::chrono::duration<float, std::milli>(elapsed).count();
+}
+
+float percentile(std::pmr::vector<float>& values, float fraction)
+{
+    if (values.empty())
+    {
+        return 0.0F;
+    }
+
+    const std::size_t rank = std::min(
+        values.size() - 1U,
+        static_cast<std::size_t>(fraction * static_cast<float>(values.size() - 1U) + 0.5F));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(rank), values.end());
+    return values[rank];
+}
+} // namespace
+
+FrameProfiler::FrameProfiler() :
+    slots_(std::make_unique<Slot[]>(kCapacity))
+{
+}
+
+void FrameProfiler::beginFrame()
+{
+    current_ = FrameSample{};
+    current_.frameIndex = published_.load(std::memory_order_relaxed);
+    frameStart_ = Clock::now();
+    lastTexture_ = nullptr;
+    inFrame_ = true;
+}
+
+void FrameProfiler::endFrame()
+{
+    if (!inFrame_)
+    {
+        return;
+    }
+    inFrame_ = false;
+    current_.frameMs = toMilliseconds(Clock::now() - frameStart_);
+
+    const std::uint64_t frameIndex = current_.frameIndex;
+    Slot& slot = slots_[frameIndex % kCapacity];
+    slot.sequence.store(frameIndex * 2U + 1U, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.sample = current_;
+    slot.sequence.store((frameIndex + 1U) * 2U, std::memory_order_release);
+    published_.store(frameIndex + 1U, std::memory_order_release);
+}
+
+void FrameProfiler::addZoneTime(ProfileZone zone, Clock::duration elapsed)
+{
+    current_.zoneMs[static_cast<std::size_t>(zone)] += toMilliseconds(elapsed);
+}
+
+void FrameProfiler::countDraw(const void* texture)
+{
+    current_.drawCalls += 1U;
+    if (texture != nullptr && texture != lastTexture_)
+    {
+        current_.textureBinds += 1U;
+    }
+    lastTexture_ = texture;
+}
+
+void FrameProfiler::countCardDrawn()
+{
+    current_.cardsDrawn += 1U;
+}
+
+void FrameProfiler::recordInputLatency(Clock::duration latency)
+{
+    current_.inputLatencyMs = std::max(toMilliseconds(latency), 0.001F);
+}
+
+bool FrameProfiler::readSlot(std::uint64_t frameIndex, FrameSample& out) const
+{
+    const Slot& slot = slots_[frameIndex % kCapacity];
+    const std::uint64_t expected = (frameIndex + 1U) * 2U;
+    if (slot.sequence.load(std::memory_order_acquire) != expected)
+    {
+        return false;
+    }
+
+    out = slot.sample;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
+
+FrameStats FrameProfiler::summarize(std::size_t window, std::pmr::memory_resource* scratch) const
+{
+    FrameStats stats;
+    const std::uint64_t published = published_.load(std::memory_order_acquire);
+    const std::uint64_t count = std::min<std::uint64_t>({published, window, kCapacity});
+
+    std::pmr::vector<float> frameTimes(scratch);
+    frameTimes.reserve(static_cast<std::size_t>(count));
+    std::pmr::vector<float> inputLatencies(scratch);
+    inputLatencies.reserve(static_cast<std::size_t>(count));
+
+    double drawCalls = 0.0;
+    double textureBinds = 0.0;
+    for (std::uint64_t frame = published - count; frame < published; ++frame)
+    {
+        FrameSample sample;
+        if (!readSlot(frame, sample))
+        {
+            continue;
+        }
+
+        frameTimes.push_back(sample.frameMs);
+        stats.maxMs = std::max(stats.maxMs, sample.frameMs);
+        for (std::size_t zone = 0; zone < kProfileZoneCount; ++zone)
+        {
+            stats.zoneMeanMs[zone] += sample.zoneMs[zone];
+        }
+        drawCalls += sample.drawCalls;
+        textureBinds += sample.textureBinds;
+        if (sample.inputLatencyMs > 0.0F)
+        {
+            inputLatencies.push_back(sample.inputLatencyMs);
+            stats.inputLatencyMaxMs = std::max(stats.inputLatencyMaxMs, sample.inputLatencyMs);
+        }
+    }
+
+    stats.sampleCount = frameTimes.size();
+    if (stats.sampleCount == 0U)
+    {
+        return stats;
+    }
+
+    const float inverseCount = 1.0F / static_cast<float>(stats.sampleCount);
+    for (float& zoneMean : stats.zoneMeanMs)
+    {
+        zoneMean *= inverseCount;
+    }
+    stats.meanDrawCalls = static_cast<float>(drawCalls) * inverseCount;
+    stats.meanTextureBinds = static_cast<float>(textureBinds) * inverseCount;
+    stats.p50Ms = percentile(frameTimes, 0.50F);
+    stats.p99Ms = percentile(frameTimes, 0.99F);
+    stats.inputSampleCount = inputLatencies.size();
+    stats.inputLatencyP50Ms = percentile(inputLatencies, 0.50F);
+    return stats;
+}
+
+bool FrameProfiler::writeCsv(const std::filesystem::path& path) const
+{
+    std::ofstream stream(path, std::ios::trunc);
+    if (!stream)
+    {
+        return false;
+    }
+
+    stream << "frame,frame_ms";
+    for (std::size_t zone = 0; zone < kProfileZoneCount; ++zone)
+    {
+        stream << ',' << zoneName(static_cast<ProfileZone>(zone)) << "_ms";
+    }
+    stream << ",draw_calls,texture_binds,cards_drawn,input_latency_ms\n";
+
+    const std::uint64_t published = published_.load(std::memory_order_acquire);
+    const std::uint64_t count = std::min<std::uint64_t>(published, kCapacity);
+    for (std::uint64_t frame = published - count; frame < published; ++frame)
+    {
+        FrameSample sample;
+        if (!readSlot(frame, sample))
+        {
+            continue;
+        }
+
+        stream << sample.frameIndex << ',' << sample.frameMs;
+        for (float zoneMs : sample.zoneMs)
+        {
+            stream << ',' << zoneMs;
+        }
+        stream << ',' << sample.drawCalls << ',' << sample.textureBinds << ',' << sample.cardsDrawn << ',' << sample.inputLatencyMs << '\n';
+    }
+
+    return static_cast<bool>(stream);
+}
+
+const char* FrameProfiler::zoneName(ProfileZone zone)
+{
+    switch (zone)
+    {
+        case ProfileZone::ProcessEvents:
+            return "process_events";
+        case ProfileZone::Update:
+            return "update";
+        case ProfileZone::RecomputeLayout:
+            return "recompute_layout";
+        case ProfileZone::Render:
+            return "render";
+        case ProfileZone::DrawCard:
+            return "draw_card";
+        case ProfileZone::Display:
+            return "display";
+        case ProfileZone::Count:
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+
+// Per-frame instrumentation for the game client: scoped zone timers, draw and
+// texture-bind counters, and a lock-free ring of recent frame samples that the
+// overlay and the CSV export read from.
+enum class ProfileZone : std::uint8_t
+{
+    ProcessEvents,
+    Update,
+    RecomputeLayout,
+    Render,
+    DrawCard,
+    Display,
+    Count
+};
+
+constexpr std::size_t kProfileZoneCount = static_cast<std::size_t>(ProfileZone::Count);
+
+struct FrameSample
+{
+    std::uint64_t frameIndex = 0;
+    float frameMs = 0.0F;
+    std::array<float, kProfileZoneCount> zoneMs{};
+    std::uint32_t drawCalls = 0;
+    std::uint32_t textureBinds = 0;
+    std::uint32_t cardsDrawn = 0;
+    // Click to end of display() for the input this frame first showed; 0 when none.
+    float inputLatencyMs = 0.0F;
+};
+
+struct FrameStats
+{
+    std::size_t sampleCount = 0;
+    float p50Ms = 0.0F;
+    float p99Ms = 0.0F;
+    float maxMs = 0.0F;
+    std::array<float, kProfileZoneCount> zoneMeanMs{};
+    float meanDrawCalls = 0.0F;
+    float meanTextureBinds = 0.0F;
+    std::size_t inputSampleCount = 0;
+    float inputLatencyP50Ms = 0.0F;
+    float inputLatencyMaxMs = 0.0F;
+};
+
+class FrameProfiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t kCapacity = 1U << 14U; // ~4.5 minutes at 60 Hz
+
+    FrameProfiler();
+
+    void beginFrame();
+    void endFrame();
+
+    void addZoneTime(ProfileZone zone, Clock::duration elapsed);
+
+    // Counts a draw call; a bind is counted whenever the texture differs from
+    // the previous draw's, which is when the renderer has to rebind.
+    void countDraw(const void* texture);
+    void countCardDrawn();
+    void recordInputLatency(Clock::duration latency);
+
+    // Length of the frame endFrame() last closed.
+    float lastFrameMs() const { return current_.frameMs; }
+
+    // Summarises the most recent `window` retained frames; the sort buffers
+    // come from `scratch`, e.g. the render thread's frame arena.
+    FrameStats summarize(std::size_t window, std::pmr::memory_resource* scratch = std::pmr::get_default_resource()) const;
+
+    // Writes every retained frame, oldest first. Returns false on I/O failure.
+    bool writeCsv(const std::filesystem::path& path) const;
+
+    static const char* zoneName(ProfileZone zone);
+
+private:
+    struct Slot
+    {
+        // Seqlock: odd while the producer writes the slot, 2 * (frame + 1) once published.
+        std::atomic<std::uint64_t> sequence{0};
+        FrameSample sample;
+    };
+
+    bool readSlot(std::uint64_t frameIndex, FrameSample& out) const;
+
+    // Heap-allocated: the ring is ~1 MB and the game object lives on the stack.
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<std::uint64_t> published_{0};
+
+    FrameSample current_;
+    Clock::time_point frameStart_{};
+    const void* lastTexture_ = nullptr;
+    bool inFrame_ = false;
+};
+
+// Zone time measured off the render thread, e.g. by the simulation. Totals
+// only grow, so a reader charges the difference since it last looked.
+struct ZoneTotals
+{
+    std::array<FrameProfiler::Clock::duration, kProfileZoneCount> elapsed{};
+
+    void addZoneTime(ProfileZone zone, FrameProfiler::Clock::duration time)
+    {
+        elapsed[static_cast<std::size_t>(zone)] += time;
+    }
+};
+
+// Times a scope into a FrameProfiler or ZoneTotals.
+template <typename Sink>
+class ProfileScope
+{
+public:
+    ProfileScope(Sink& profiler, ProfileZone zone) :
+        profiler_(profiler),
+        zone_(zone),
+        start_(FrameProfiler::Clock::now())
+    {
+    }
+
+    ~ProfileScope()
+    {
+        profiler_.addZoneTime(zone_, FrameProfiler::Clock::now() - start_);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Sink& profiler_;
+    ProfileZone zone_;
+    FrameProfiler::Clock::time_point start_;
+};
@@ -0,0 +1,244 @@
+#include "gpu_card_renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr std::size_t kCardsPerDataRow = 512;
+constexpr std::size_t kTexelsPerCard = 2; // animation progress, state + front tint
+constexpr std::size_t kQuadsPerCard = 4;
+constexpr std::size_t kVerticesPerGpuCard = kQuadsPerCard * 6U;
+
+// GLSL 1.20 so the compatibility contexts SFML creates on every platform
+// (including macOS) accept it. Vertex shader texture fetch is core there.
+constexpr const char* kVertexShader = R"(
+#version 120
+uniform sampler2D cardData;
+uniform vec2 cardDataSize;
+uniform vec2 halfSize;
+uniform float outlineThickness;
+uniform float hoveredCard;
+uniform float blend;
+uniform float perspective;
+uniform vec4 outlineFrontColor;
+uniform vec4 outlineBackColor;
+uniform vec4 outlineHoverColor;
+uniform vec4 backTint;
+
+float decode16(vec2 bytes)
+{
+    return (bytes.x * 65280.0 + bytes.y * 255.0) / 65535.0;
+}
+
+void main()
+{
+    vec4 code = floor(gl_Color * 255.0 + 0.5);
+    float card = code.r * 65536.0 + code.g * 256.0 + code.b;
+    float layer = floor(code.a / 4.0);
+    float corner = code.a - layer * 4.0;
+    vec2 side = vec2(mod(corner, 2.0) * 2.0 - 1.0, floor(corner / 2.0) * 2.0 - 1.0);
+
+    float row = floor(card / 512.0);
+    float column = card - row * 512.0;
+    vec2 texel = vec2((column * 2.0 + 0.5) / cardDataSize.x, (row + 0.5) / cardDataSize.y);
+    vec4 animation = texture2DLod(cardData, texel, 0.0);
+    vec4 info = texture2DLod(cardData, texel + vec2(1.0 / cardDataSize.x, 0.0), 0.0);
+
+    float state = floor(info.r * 255.0 + 0.5);
+    float progress = clamp(mix(decode16(animation.rg), decode16(animation.ba), blend), 0.0, 1.0);
+    bool flipping = state == 1.0 || state == 3.0;
+    bool matched = state == 4.0;
+
+    float t = matched ? progress : 0.0;
+    float vanish = 1.0 - 0.40 * t;
+    float flipScale = flipping ? max(0.02, abs(1.0 - progress * 2.0)) : 1.0;
+    vec2 scale = vec2(max(0.02, flipScale * vanish), max(0.02, vanish));
+
+    bool showFront = state == 2.0 || matched || (state == 1.0 && progress >= 0.5) || (state == 3.0 && progress < 0.5);
+    bool frontLayer = layer >= 2.0;
+    bool outline = layer == 0.0 || layer == 2.0;
+    bool visible = state != 5.0 && frontLayer == showFront;
+
+    // Rotating about the vertical axis: the edge turning towards the viewer
+    // grows while the far one shrinks, and they trade places at the half way.
+    float lean = flipping ? perspective * sqrt(max(0.0, 1.0 - flipScale * flipScale)) * (progress < 0.5 ? 1.0 : -1.0) : 0.0;
+    vec2 extent = (halfSize + (outline ? vec2(outlineThickness) : vec2(0.0))) * scale;
+    extent.y *= 1.0 + lean * side.x;
+    vec2 position = gl_Vertex.xy + (visible ? side * extent : vec2(0.0));
+
+    vec4 color = frontLayer
+        ? (outline ? outlineFrontColor : vec4(info.gba, 1.0))
+        : (outline ? (state == 0.0 && card == hoveredCard ? outlineHoverColor : outlineBackColor) : backTint);
+    color.a *= 1.0 - t;
+
+    gl_Position = gl_ModelViewProjectionMatrix * vec4(position, 0.0, 1.0);
+    gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;
+    gl_FrontColor = color;
+}
+)";
+
+constexpr const char* kFragmentShader = R"(
+#version 120
+uniform sampler2D texture;
+
+void main()
+{
+    gl_FragColor = gl_Color * texture2D(texture, gl_TexCoord[0].xy);
+}
+)";
+
+std::uint16_t encodeProgress(float progress)
+{
+    return static_cast<std::uint16_t>(std::lround(std::clamp(progress, 0.0F, 1.0F) * 65535.0F));
+}
+
+// Corners in the order (-,-), (+,-), (-,+), (+,+), matching the shader's decode.
+void writeCodedQuad(sf::Vertex* out, sf::Vector2f center, std::size_t card, std::uint8_t layer, const sf::FloatRect& uv)
+{
+    const float u0 = uv.position.x;
+    const float u1 = uv.position.x + uv.size.x;
+    const float v0 = uv.position.y;
+    const float v1 = uv.position.y + uv.size.y;
+
+    const auto vertex = [&](std::uint8_t corner, float u, float v)
+    {
+        const sf::Color code(
+            static_cast<std::uint8_t>(card >> 16U),
+            static_cast<std::uint8_t>(card >> 8U),
+            static_cast<std::uint8_t>(card),
+            static_cast<std::uint8_t>(layer * 4U + corner));
+        return sf::Vertex{center, code, {u, v}};
+    };
+
+    out[0] = vertex(0U, u0, v0);
+    out[1] = vertex(1U, u1, v0);
+    out[2] = vertex(2U, u0, v1);
+    out[3] = vertex(2U, u0, v1);
+    out[4] = vertex(1U, u1, v0);
+    out[5] = vertex(3U, u1, v1);
+}
+} // namespace
+
+bool GpuCardRenderer::create(std::size_t cardCount)
+{
+    if (!sf::Shader::isAvailable() || !shader_.loadFromMemory(kVertexShader, kFragmentShader))
+    {
+        return false;
+    }
+
+    const std::size_t rows = std::max<std::size_t>(1U, (cardCount + kCardsPerDataRow - 1U) / kCardsPerDataRow);
+    const std::size_t columns = std::clamp<std::size_t>(cardCount, 1U, kCardsPerDataRow) * kTexelsPerCard;
+    dataSize_ = sf::Vector2u(static_cast<unsigned int>(columns), static_cast<unsigned int>(rows));
+    if (!data_.resize(dataSize_))
+    {
+        return false;
+    }
+    data_.setSmooth(false);
+    pixels_.assign(columns * rows * 4U, 0U);
+    dirtyRowBegin_ = 0U;
+    dirtyRowEnd_ = dataSize_.y;
+
+    vertices_.assign(cardCount * kVerticesPerGpuCard, sf::Vertex{});
+    useBuffer_ = sf::VertexBuffer::isAvailable() && buffer_.create(vertices_.size());
+    return true;
+}
+
+std::uint8_t* GpuCardRenderer::texel(std::size_t index, std::size_t offset)
+{
+    const std::size_t row = index / kCardsPerDataRow;
+    const std::size_t column = (index % kCardsPerDataRow) * kTexelsPerCard + offset;
+    dirtyRowBegin_ = std::min(dirtyRowBegin_, static_cast<unsigned int>(row));
+    dirtyRowEnd_ = std::max(dirtyRowEnd_, static_cast<unsigned int>(row + 1U));
+    return pixels_.data() + (row * dataSize_.x + column) * 4U;
+}
+
+void GpuCardRenderer::setGeometry(
+    std::size_t index,
+    sf::Vector2f center,
+    const sf::FloatRect& outlineUv,
+    const sf::FloatRect& backUv,
+    const sf::FloatRect& frontUv,
+    sf::Color frontTint)
+{
+    if (index * kVerticesPerGpuCard >= vertices_.size())
+    {
+        return;
+    }
+
+    sf::Vertex* out = vertices_.data() + index * kVerticesPerGpuCard;
+    writeCodedQuad(out, center, index, 0U, outlineUv);
+    writeCodedQuad(out + 6U, center, index, 1U, backUv);
+    writeCodedQuad(out + 12U, center, index, 2U, outlineUv);
+    writeCodedQuad(out + 18U, center, index, 3U, frontUv);
+
+    std::uint8_t* info = texel(index, 1U);
+    info[1] = frontTint.r;
+    info[2] = frontTint.g;
+    info[3] = frontTint.b;
+}
+
+void GpuCardRenderer::setPose(std::size_t index, memory::CardState state, float previousProgress, float progress)
+{
+    if (index * kVerticesPerGpuCard >= vertices_.size())
+    {
+        return;
+    }
+
+    const std::uint16_t previous = encodeProgress(previousProgress);
+    const std::uint16_t current = encodeProgress(progress);
+    std::uint8_t* animation = texel(index, 0U);
+    animation[0] = static_cast<std::uint8_t>(previous >> 8U);
+    animation[1] = static_cast<std::uint8_t>(previous);
+    animation[2] = static_cast<std::uint8_t>(current >> 8U);
+    animation[3] = static_cast<std::uint8_t>(current);
+    texel(index, 1U)[0] = static_cast<std::uint8_t>(state);
+}
+
+void GpuCardRenderer::uploadGeometry()
+{
+    if (useBuffer_ && !buffer_.update(vertices_.data()))
+    {
+        useBuffer_ = false;
+    }
+}
+
+void GpuCardRenderer::uploadPoses()
+{
+    if (dirtyRowBegin_ >= dirtyRowEnd_)
+    {
+        return;
+    }
+
+    data_.update(
+        pixels_.data() + static_cast<std::size_t>(dirtyRowBegin_) * dataSize_.x * 4U,
+        sf::Vector2u(dataSize_.x, dirtyRowEnd_ - dirtyRowBegin_),
+        sf::Vector2u(0U, dirtyRowBegin_));
+    dirtyRowBegin_ = dataSize_.y;
+    dirtyRowEnd_ = 0U;
+}
+
+void GpuCardRenderer::draw(sf::RenderTarget& target, const sf::Texture& atlas, const GpuCardStyle& style)
+{
+    shader_.setUniform("texture", sf::Shader::CurrentTexture);
+    shader_.setUniform("cardData", data_);
+    shader_.setUniform("cardDataSize", sf::Glsl::Vec2(static_cast<float>(dataSize_.x), static_cast<float>(dataSize_.y)));
+    shader_.setUniform("halfSize", sf::Glsl::Vec2(style.halfSize));
+    shader_.setUniform("outlineThickness", style.outlineThickness);
+    shader_.setUniform("hoveredCard", static_cast<float>(style.hoveredCard));
+    shader_.setUniform("blend", style.blend);
+    shader_.setUniform("perspective", style.perspective);
+    shader_.setUniform("outlineFrontColor", sf::Glsl::Vec4(style.outlineFront));
+    shader_.setUniform("outlineBackColor", sf::Glsl::Vec4(style.outlineBack));
+    shader_.setUniform("outlineHoverColor", sf::Glsl::Vec4(style.outlineHover));
+    shader_.setUniform("backTint", sf::Glsl::Vec4(style.backTint));
+
+    sf::RenderStates states(&atlas);
+    states.shader = &shader_;
+    if (useBuffer_)
+    {
+        target.draw(buffer_, states);
+        return;
+    }
+    target.draw(vertices_.data(), vertices_.size(), sf::PrimitiveType::Triangles, states);
+}
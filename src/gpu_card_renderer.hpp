@@ -0,0 +1,73 @@
+#pragma once
+
+#include "core/memory_rules.hpp"
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Per-frame inputs of the card shader.
+struct GpuCardStyle
+{
+    sf::Vector2f halfSize{0.0F, 0.0F};
+    float outlineThickness = 0.0F;
+    int hoveredCard = -1;
+    // Fraction of the way from each card's previous pose to its current one.
+    float blend = 1.0F;
+    // Height change of the near edge mid-flip; 0 gives the flat squash.
+    float perspective = 0.15F;
+    sf::Color outlineFront;
+    sf::Color outlineBack;
+    sf::Color outlineHover;
+    sf::Color backTint;
+};
+
+// Draws the whole board from static quads, with the flip squash, face
+// selection and fade done in a vertex shader. Every card owns four quads
+// (back outline, back, front outline, front) positioned at its centre; the
+// vertex colour encodes the card index, layer and corner, so no custom vertex
+// attributes are needed. Per-card state and progress live in a small RGBA
+// data texture that only changes when the simulation does, so frames between
+// ticks cost the CPU nothing per card.
+class GpuCardRenderer
+{
+public:
+    // Compiles the shaders and sizes the buffers; false when shaders are
+    // unavailable or fail to compile.
+    bool create(std::size_t cardCount);
+
+    // Static appearance of a card; takes effect on the next uploadGeometry().
+    void setGeometry(
+        std::size_t index,
+        sf::Vector2f center,
+        const sf::FloatRect& outlineUv,
+        const sf::FloatRect& backUv,
+        const sf::FloatRect& frontUv,
+        sf::Color frontTint);
+
+    // `previousProgress` is blended towards `progress` by GpuCardStyle::blend;
+    // progress is the flip for flipping cards and the fade for matched ones.
+    void setPose(std::size_t index, memory::CardState state, float previousProgress, float progress);
+
+    void uploadGeometry();
+    // Sends the data-texture rows touched since the last upload.
+    void uploadPoses();
+
+    void draw(sf::RenderTarget& target, const sf::Texture& atlas, const GpuCardStyle& style);
+
+private:
+    std::uint8_t* texel(std::size_t index, std::size_t offset);
+
+    sf::Shader shader_;
+    sf::Texture data_;
+    sf::Vector2u dataSize_{0U, 0U};
+    std::vector<std::uint8_t> pixels_;
+    unsigned int dirtyRowBegin_ = 0U;
+    unsigned int dirtyRowEnd_ = 0U;
+
+    std::vector<sf::Vertex> vertices_;
+    sf::VertexBuffer buffer_{sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static};
+    bool useBuffer_ = false;
+};
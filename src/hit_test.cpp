@@ -0,0 +1,183 @@
+#include "hit_test.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Cells per slot in the bucketed fallback; about one rect per cell keeps
+// buckets short without making the table much larger than the board.
+constexpr float kCellsPerRect = 1.0F;
+
+bool containsPoint(const sf::FloatRect& rect, sf::Vector2f point)
+{
+    return point.x >= rect.position.x &&
+           point.x <= rect.position.x + rect.size.x &&
+           point.y >= rect.position.y &&
+           point.y <= rect.position.y + rect.size.y;
+}
+
+int cellCoordinate(float value, float cellSize, int cellCount)
+{
+    return std::clamp(static_cast<int>(std::floor(value / cellSize)), 0, cellCount - 1);
+}
+} // namespace
+
+void HitTestGrid::setRegularGrid(sf::Vector2f origin, sf::Vector2f cardSize, sf::Vector2f pitch, int columns, int rows)
+{
+    regular_ = true;
+    origin_ = origin;
+    cardSize_ = cardSize;
+    pitch_ = sf::Vector2f(std::max(pitch.x, 1.0e-3F), std::max(pitch.y, 1.0e-3F));
+    columns_ = columns;
+    rows_ = rows;
+    geometry_ = memory::GridGeometry{origin.x, origin.y, cardSize.x, cardSize.y, pitch_.x, pitch_.y};
+
+    fixedPick_ = nullptr;
+    if (columns == 4 && rows == 4)
+    {
+        fixedPick_ = &memory::Board<4, 4>::pick;
+    }
+    else if (columns == 6 && rows == 6)
+    {
+        fixedPick_ = &memory::Board<6, 6>::pick;
+    }
+    else if (columns == 8 && rows == 4)
+    {
+        fixedPick_ = &memory::Board<8, 4>::pick;
+    }
+
+    rects_.clear();
+    cellStart_.clear();
+    cellSlots_.clear();
+}
+
+void HitTestGrid::setRects(std::span<const sf::FloatRect> bounds)
+{
+    regular_ = false;
+    rects_.assign(bounds.begin(), bounds.end());
+    cellStart_.clear();
+    cellSlots_.clear();
+    if (rects_.empty())
+    {
+        columns_ = 0;
+        rows_ = 0;
+        return;
+    }
+
+    sf::Vector2f low = rects_.front().position;
+    sf::Vector2f high = low;
+    for (const sf::FloatRect& rect : rects_)
+    {
+        low = sf::Vector2f(std::min(low.x, rect.position.x), std::min(low.y, rect.position.y));
+        high = sf::Vector2f(
+            std::max(high.x, rect.position.x + rect.size.x),
+            std::max(high.y, rect.position.y + rect.size.y));
+    }
+
+    const sf::Vector2f extent{std::max(high.x - low.x, 1.0F), std::max(high.y - low.y, 1.0F)};
+    const float cellArea = extent.x * extent.y / (static_cast<float>(rects_.size()) * kCellsPerRect);
+    const float side = std::sqrt(cellArea);
+    origin_ = low;
+    columns_ = std::max(1, static_cast<int>(std::ceil(extent.x / side)));
+    rows_ = std::max(1, static_cast<int>(std::ceil(extent.y / side)));
+    cellSize_ = sf::Vector2f(extent.x / static_cast<float>(columns_), extent.y / static_cast<float>(rows_));
+
+    // Two passes (count, then fill) build a compact table with one allocation each.
+    const auto forEachCell = [this](const sf::FloatRect& rect, auto&& visit)
+    {
+        const int column0 = cellCoordinate(rect.position.x - origin_.x, cellSize_.x, columns_);
+        const int column1 = cellCoordinate(rect.position.x + rect.size.x - origin_.x, cellSize_.x, columns_);
+        const int row0 = cellCoordinate(rect.position.y - origin_.y, cellSize_.y, rows_);
+        const int row1 = cellCoordinate(rect.position.y + rect.size.y - origin_.y, cellSize_.y, rows_);
+        for (int row = row0; row <= row1; ++row)
+        {
+            for (int column = column0; column <= column1; ++column)
+            {
+                visit(static_cast<std::size_t>(row * columns_ + column));
+            }
+        }
+    };
+
+    const std::size_t cellCount = static_cast<std::size_t>(columns_) * static_cast<std::size_t>(rows_);
+    cellStart_.assign(cellCount + 1U, 0U);
+    for (const sf::FloatRect& rect : rects_)
+    {
+        forEachCell(rect, [this](std::size_t cell) { ++cellStart_[cell + 1U]; });
+    }
+    for (std::size_t cell = 0; cell < cellCount; ++cell)
+    {
+        cellStart_[cell + 1U] += cellStart_[cell];
+    }
+
+    cellSlots_.resize(cellStart_.back());
+    std::vector<std::uint32_t> cursor(cellStart_.begin(), cellStart_.end() - 1);
+    for (std::size_t slot = 0; slot < rects_.size(); ++slot)
+    {
+        // Slots are visited in ascending order, so each bucket stays sorted.
+        forEachCell(rects_[slot], [this, &cursor, slot](std::size_t cell)
+        {
+            cellSlots_[cursor[cell]++] = static_cast<std::int32_t>(slot);
+        });
+    }
+}
+
+int HitTestGrid::pick(sf::Vector2f point) const
+{
+    return regular_ ? pickRegular(point) : pickBucketed(point);
+}
+
+int HitTestGrid::pickRegular(sf::Vector2f point) const
+{
+    if (fixedPick_ != nullptr)
+    {
+        return fixedPick_(geometry_, point.x, point.y);
+    }
+
+    const sf::Vector2f local = point - origin_;
+    if (local.x < 0.0F || local.y < 0.0F)
+    {
+        return -1;
+    }
+
+    const int column = static_cast<int>(local.x / pitch_.x);
+    const int row = static_cast<int>(local.y / pitch_.y);
+    if (column >= columns_ || row >= rows_)
+    {
+        return -1;
+    }
+
+    // Only the candidate cell is bounds-checked; points in the gap miss.
+    const sf::FloatRect bounds(
+        origin_ + sf::Vector2f(static_cast<float>(column) * pitch_.x, static_cast<float>(row) * pitch_.y),
+        cardSize_);
+    return containsPoint(bounds, point) ? row * columns_ + column : -1;
+}
+
+int HitTestGrid::pickBucketed(sf::Vector2f point) const
+{
+    if (cellStart_.empty())
+    {
+        return -1;
+    }
+
+    const sf::Vector2f local = point - origin_;
+    if (local.x < 0.0F || local.y < 0.0F)
+    {
+        return -1;
+    }
+
+    // Points past the far edges clamp into the last cell and fail the bounds test there.
+    const int column = std::min(static_cast<int>(local.x / cellSize_.x), columns_ - 1);
+    const int row = std::min(static_cast<int>(local.y / cellSize_.y), rows_ - 1);
+    const std::size_t cell = static_cast<std::size_t>(row * columns_ + column);
+    for (std::uint32_t entry = cellStart_[cell]; entry < cellStart_[cell + 1U]; ++entry)
+    {
+        const std::int32_t slot = cellSlots_[entry];
+        if (containsPoint(rects_[static_cast<std::size_t>(slot)], point))
+        {
+            return slot;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "core/fixed_board.hpp"
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Maps a point to the card slot under it without scanning the board. A
+// regular grid is resolved arithmetically from its origin and pitch (with the
+// compile-time memory::Board tests for the cabinet sizes); any other layout is
+// bucketed into a uniform grid of cells so only the few rects overlapping the
+// point's cell are tested.
+class HitTestGrid
+{
+public:
+    // Slots are laid out row-major; `pitch` is card size plus gap.
+    void setRegularGrid(sf::Vector2f origin, sf::Vector2f cardSize, sf::Vector2f pitch, int columns, int rows);
+
+    // Arbitrary (possibly overlapping) rects, indexed by slot.
+    void setRects(std::span<const sf::FloatRect> bounds);
+
+    // Returns the lowest slot whose bounds contain `point`, or -1.
+    int pick(sf::Vector2f point) const;
+
+private:
+    int pickRegular(sf::Vector2f point) const;
+    int pickBucketed(sf::Vector2f point) const;
+
+    using FixedPick = int (*)(const memory::GridGeometry&, float, float);
+
+    bool regular_ = true;
+    FixedPick fixedPick_ = nullptr;
+    memory::GridGeometry geometry_;
+
+    sf::Vector2f origin_{0.0F, 0.0F};
+    sf::Vector2f cardSize_{0.0F, 0.0F};
+    sf::Vector2f pitch_{1.0F, 1.0F};
+    int columns_ = 0;
+    int rows_ = 0;
+
+    // Bucketed fallback; cell c owns cellSlots_[cellStart_[c] .. cellStart_[c + 1]).
+    std::vector<sf::FloatRect> rects_;
+    sf::Vector2f cellSize_{1.0F, 1.0F};
+    std::vector<std::uint32_t> cellStart_;
+    std::vector<std::int32_t> cellSlots_;
+};
@@ -0,0 +1,46 @@
+#include "hud_text.hpp"
+
+#include <cctype>
+#include <cmath>
+
+HudString formatElapsedTime(float elapsedSeconds)
+{
+    const int totalSeconds = static_cast<int>(std::floor(elapsedSeconds));
+    const int hours = totalSeconds / 3600;
+    const int minutes = (totalSeconds % 3600) / 60;
+    const int seconds = totalSeconds % 60;
+
+    HudString output;
+    if (hours > 0)
+    {
+        output.append(hours, 2).append(":");
+    }
+    output.append(minutes, 2).append(":").append(seconds, 2);
+    return output;
+}
+
+std::string makeInitials(const std::string& name)
+{
+    std::string output;
+    bool takeNext = true;
+
+    for (char c : name)
+    {
+        const bool separator = (c == ' ' || c == '-');
+        if (takeNext && std::isalnum(static_cast<unsigned char>(c)) != 0)
+        {
+            output.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+            if (output.size() >= 3)
+            {
+                break;
+            }
+        }
+        takeNext = separator;
+    }
+
+    if (output.empty())
+    {
+        return "???";
+    }
+    return output;
+}
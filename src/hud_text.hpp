@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Fixed-capacity string for HUD values so per-frame formatting never touches the heap.
+struct HudString
+{
+    std::array<char, 64> chars{};
+    std::size_t length = 0;
+
+    HudString& append(std::string_view value)
+    {
+        const std::size_t count = std::min(value.size(), chars.size() - length);
+        std::copy_n(value.data(), count, chars.data() + length);
+        length += count;
+        return *this;
+    }
+
+    HudString& append(int value, int minDigits = 1)
+    {
+        std::array<char, 16> digits{};
+        const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+        const std::size_t digitCount = static_cast<std::size_t>(result.ptr - digits.data());
+        for (std::size_t pad = digitCount; pad < static_cast<std::size_t>(minDigits); ++pad)
+        {
+            append("0");
+        }
+        return append(std::string_view(digits.data(), digitCount));
+    }
+
+    std::string_view view() const
+    {
+        return std::string_view(chars.data(), length);
+    }
+};
+
+// "mm:ss", or "hh:mm:ss" from the first hour on.
+HudString formatElapsedTime(float elapsedSeconds);
+
+// Up to three upper-case initials of `name`, or "???" when it has none.
+std::string makeInitials(const std::string& name);
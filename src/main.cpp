@@ -1,47 +1,116 @@
+#include "ai_opponent.hpp"
+#include "allocation_counter.hpp"
+#include "async_image_loader.hpp"
+#include "board_layout.hpp"
+#include "card_mesh.hpp"
+#include "file_watcher.hpp"
+#include "core/animation_kernels.hpp"
+#include "core/asset_pack.hpp"
+#include "core/belief_state.hpp"
+#include "core/card_manifest.hpp"
+#include "core/input_log.hpp"
+#include "core/memory_rules.hpp"
+#include "core/telemetry_format.hpp"
+#include "core/texture_tiers.hpp"
+#include "frame_arena.hpp"
+#include "frame_profiler.hpp"
+#include "gpu_card_renderer.hpp"
+#include "hit_test.hpp"
+#include "hud_text.hpp"
+#include "telemetry_exporter.hpp"
+#include "texture_residency.hpp"
+#include "triple_buffer.hpp"
+#include "worker_pool.hpp"
+
 #include <SFML/Graphics.hpp>
 #include <SFML/System.hpp>
 #include <SFML/Window.hpp>
 
 #include <algorithm>
 #include <array>
-#include <cctype>
+#include <atomic>
+#include <charconv>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <filesystem>
-#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <optional>
 #include <random>
-#include <sstream>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 namespace
 {
 namespace fs = std::filesystem;
 
-constexpr int kColumns = 8;
-constexpr int kRows = 4;
-constexpr int kPairCount = 16;
-constexpr int kCardCount = kColumns * kRows;
-
-constexpr float kVirtualWidth = 1920.0F;
-constexpr float kVirtualHeight = 1080.0F;
-constexpr float kCardAspectRatio = 3.0F / 4.0F; // width / height
-
-constexpr float kFlipDurationSeconds = 0.22F;
-constexpr float kRevealDurationSeconds = 2.0F;
-constexpr float kMatchRemoveDurationSeconds = 0.20F;
+using memory::Card;
+using memory::CardState;
+
+constexpr float kIdleWakeSlackSeconds = 0.005F;
+
+// Rules always advance in fixed ticks so results do not depend on frame rate;
+// rendering interpolates between the last two ticks.
+constexpr float kSimulationStepSeconds = 1.0F / 120.0F;
+constexpr float kMaxFrameSeconds = 0.1F;
+constexpr int kMaxReplayTicksPerFrame = 2000;
+
+constexpr std::size_t kProfilerOverlayWindow = 600U; // frames summarised on screen
+constexpr std::size_t kFrameArenaBytes = 64U * 1024U;
+constexpr std::size_t kPendingClickCapacity = 16U;
+constexpr float kProfilerOverlayRefreshSeconds = 0.25F;
+constexpr std::chrono::seconds kTelemetryFrameWindow{10};
+constexpr std::size_t kMinTelemetryRotateMegabytes = 1U;
+
+constexpr const char* kAssetPackPath = "assets/memory_game.pack";
+constexpr const char* kManifestPath = "assets/manifest/cards.json";
+constexpr const char* kLayoutConfigPath = "assets/layout.json";
+constexpr const char* kAssetDirectory = "assets";
+constexpr const char* kProcessedDirectory = "assets/processed";
+constexpr const char* kFontDirectory = "assets/fonts";
+constexpr const char* kCardBackPath = "assets/processed/card_back.png";
+constexpr float kHotReloadPollSeconds = 0.25F; // longest an idle loop sleeps with --hot-reload
+
+constexpr unsigned int kAtlasInitialSize = 1024U;
+constexpr unsigned int kAtlasPadding = 2U;
+constexpr unsigned int kAtlasSolidTileSize = 4U;
+constexpr std::size_t kDefaultTextureBudgetMegabytes = 64U;
+constexpr std::size_t kMinTextureBudgetMegabytes = 8U; // the initial atlas, with mip levels
+constexpr std::size_t kChromeQuadCount = 5U; // play frame, HUD, grid, button outline, button
+constexpr std::int32_t kMaxUploadGapCards = 8; // clean cards re-sent to merge two dirty runs
+constexpr int kMaxKioskBoards = 64;
+// Seats in a game against the computer; the player always starts.
+constexpr int kPlayerSeat = 0;
+constexpr int kComputerSeat = 1;
 
 struct CharacterInfo
 {
     std::string name;
     std::string slug;
     sf::Color fallbackColor;
+    // Label for cards without art, made once when the deck loads.
+    std::string initials{};
+    fs::path processed{};
+};
+
+// A themed set of characters: characters_[firstCharacter, firstCharacter +
+// characterCount). Boards deal from their own deck's range only.
+struct Deck
+{
+    std::string name;
+    std::size_t firstCharacter = 0;
+    int characterCount = 0;
 };
 
-const std::array<CharacterInfo, kPairCount> kCharacters{{
+// Used when the manifest cannot be read, and for the fallback colours of the
+// characters it lists.
+const std::array<CharacterInfo, memory::kDefaultCharacterCount> kDefaultCharacters{{
     {"Luke Skywalker", "luke_skywalker", sf::Color(226, 188, 94)},
     {"Leia Organa", "leia_organa", sf::Color(235, 152, 152)},
     {"Darth Vader", "darth_vader", sf::Color(155, 155, 170)},
@@ -60,50 +129,139 @@ const std::array<CharacterInfo, kPairCount> kCharacters{{
     {"Padme Amidala", "padme_amidala", sf::Color(228, 162, 180)},
 }};
 
-enum class CardState
+// A card's pose at the start of the tick it was captured on, for interpolation.
+struct CardPose
+{
+    std::uint64_t tick = 0;
+    CardState state = CardState::FaceDown;
+    float flipProgress = 0.0F;
+    float removeProgress = 0.0F;
+};
+
+// A live click waiting for the tick boundary that follows it. Applying it
+// there, `lateSeconds` after it happened, keeps live play on the same tick
+// grid as replays while the flip still starts at the click's own time.
+struct PendingClick
 {
-    FaceDown,
-    FlippingToFront,
-    FaceUp,
-    FlippingToBack,
-    Matched,
-    Removed
+    sf::Vector2f virtualPoint;
+    std::uint64_t dueTick = 0;
+    float lateSeconds = 0.0F;
+    FrameProfiler::Clock::time_point receivedAt;
+    std::size_t instance = 0;
 };
 
-enum class PairPhase
+// One independent game. Kiosk mode hosts several side by side; they share
+// the window, deck, atlas and card buffers, and instance i owns snapshot card
+// slots [i * cards per board, (i + 1) * cards per board).
+struct GameInstance
 {
-    Idle,
-    WaitingForSecondFlip,
-    RevealWindow,
-    Resolving
+    memory::BoardState board;
+    std::vector<CardPose> previousPoses;
+    std::mt19937 random;
+    Layout layout;
+    HitTestGrid hitTest;
+    int hoveredCard = -1;
+    int publishedSecond = -1;
+    std::size_t deck = 0;
+    std::vector<std::int32_t> dirty; // takeDirtyCards() target, reused
+    // What telemetry has already reported, to spot pair resolutions and wins.
+    memory::PairPhase reportedPhase = memory::PairPhase::Idle;
+    bool reportedWon = false;
+    // Set in a game against the computer: whose turn it is and the pairs each seat took.
+    std::unique_ptr<AiOpponent> opponent;
+    int turn = kPlayerSeat;
+    std::array<int, 2> scores{};
 };
 
-struct Card
+// The per-board part of a RenderSnapshot. Selections are snapshot card slots.
+struct InstanceView
 {
-    int slotIndex = 0;
-    int characterIndex = 0;
-    CardState state = CardState::FaceDown;
-    sf::FloatRect bounds{{0.0F, 0.0F}, {0.0F, 0.0F}};
-    bool frontVisible = false;
-    bool flipFaceSwapped = false;
-    float flipProgress = 0.0F;
-    float removeProgress = 0.0F;
+    Layout layout;
+    int firstSelected = -1;
+    int secondSelected = -1;
+    int moves = 0;
+    float elapsedSeconds = 0.0F;
+    bool won = false;
+    std::size_t deck = 0;
+    bool versusComputer = false;
+    int turn = kPlayerSeat;
+    std::array<int, 2> scores{};
 };
 
-struct Layout
-{
-    float scale = 1.0F;
-    float outlineThickness = 2.0F;
-    sf::FloatRect playArea{{0.0F, 0.0F}, {kVirtualWidth, kVirtualHeight}};
-    sf::FloatRect hudArea{{0.0F, 0.0F}, {kVirtualWidth, 180.0F}};
-    sf::FloatRect gridArea{{0.0F, 180.0F}, {kVirtualWidth, kVirtualHeight - 180.0F}};
-    sf::FloatRect newGameButton{{0.0F, 0.0F}, {220.0F, 70.0F}};
-    std::array<sf::FloatRect, kCardCount> cardBounds{};
-    unsigned int titleSize = 42U;
-    unsigned int statsSize = 30U;
-    unsigned int buttonSize = 28U;
-    unsigned int cardLabelSize = 24U;
-    unsigned int overlaySize = 52U;
+// Everything the render thread draws, published by the simulation thread
+// through a TripleBuffer. Card arrays are whole-board copies, but each slot
+// only refreshes the cards that changed since that slot was last written.
+struct RenderSnapshot
+{
+    std::uint64_t tick = 0;
+    float blend = 0.0F; // fraction of a tick past `tick`, for interpolation
+    std::uint64_t layoutVersion = 0;
+    std::vector<InstanceView> instances;
+
+    std::vector<std::int32_t> characterIndex; // into characters_, not a board's deck
+    std::vector<CardState> state;
+    std::vector<float> flipProgress;
+    std::vector<float> removeProgress;
+    std::vector<CardPose> previousPoses;
+    std::vector<std::int32_t> animating;
+    // Cards that changed since the snapshot the render thread last acquired.
+    std::vector<std::int32_t> dirty;
+
+    int hoveredCard = -1;
+    bool profilerOverlayVisible = false;
+    ZoneTotals simulationZones;
+    // Arrival of the oldest click this snapshot is the first to show.
+    std::optional<FrameProfiler::Clock::time_point> inputReceivedAt;
+};
+
+// Bit per snapshot slot in MemoryGame::snapshotPending_, plus one marking a
+// card as not yet seen by the render thread.
+constexpr std::size_t kSnapshotSlots = 3U;
+constexpr std::uint8_t kSnapshotUnseen = 1U << kSnapshotSlots;
+
+enum class HudRole
+{
+    Title,
+    Time,
+    Moves,
+    NewGame,
+    WinTitle,
+    WinStats,
+    Count
+};
+
+// A pre-built sf::Text that only re-lays out glyphs when its string or
+// character size actually changes.
+struct CachedText
+{
+    std::optional<sf::Text> text;
+    std::string value;
+    unsigned int size = 0U;
+    bool centered = false;
+};
+
+// Shelf-packed atlas that grows as images arrive, up to the texture budget.
+// Regions never move when the texture grows, so UVs handed out earlier stay
+// valid; an evicted face's region is handed to the next face that fits it.
+struct TextureAtlas
+{
+    sf::Texture texture;
+    sf::Vector2u cursor{0U, 0U};
+    unsigned int shelfHeight = 0U;
+    sf::FloatRect solidRegion{{0.0F, 0.0F}, {0.0F, 0.0F}};
+    std::optional<sf::FloatRect> backRegion;
+    std::vector<std::optional<sf::FloatRect>> faceRegions;
+    // The whole region reserved for the back and each face. Art drawn from a
+    // reused region may not fill it, but the full region is what is freed.
+    sf::FloatRect backSlot{{0.0F, 0.0F}, {0.0F, 0.0F}};
+    std::vector<sf::FloatRect> faceSlots;
+    std::vector<sf::FloatRect> freeRegions;
+    bool mipmapsStale = false;
+    bool budgetWarned = false;
+    // Card height the loaded tiers were chosen for (0 until the first load),
+    // and the tallest full-size art seen, to tell when a resize needs another tier.
+    float cardHeight = 0.0F;
+    unsigned int sourceHeight = 0U;
 };
 
 bool containsPoint(const sf::FloatRect& rect, sf::Vector2f point)
@@ -119,854 +277,2730 @@ float clamp01(float value)
     return std::clamp(value, 0.0F, 1.0F);
 }
 
+// Clicks are logged in virtual play-area coordinates so a replay hits the
+// same cards at any window size.
+sf::Vector2f toVirtual(const Layout& layout, sf::Vector2f point)
+{
+    return sf::Vector2f(
+        (point.x - layout.playArea.position.x) / layout.scale,
+        (point.y - layout.playArea.position.y) / layout.scale);
+}
+
+sf::Vector2f fromVirtual(const Layout& layout, sf::Vector2f point)
+{
+    return sf::Vector2f(
+        layout.playArea.position.x + point.x * layout.scale,
+        layout.playArea.position.y + point.y * layout.scale);
+}
+
+struct LaunchOptions
+{
+    std::optional<fs::path> recordPath;
+    std::optional<fs::path> replayPath;
+    // Replay speed multiplier; 0 replays as fast as the sim can run.
+    float replaySpeed = 1.0F;
+    std::optional<fs::path> profileCsvPath;
+    // Overrides the manifest's board size when both are non-zero.
+    int boardColumns = 0;
+    int boardRows = 0;
+    // Animate cards in a vertex shader instead of rewriting their vertices.
+    bool gpuAnimation = false;
+    // Bilinear, mipmapped card art instead of crisp nearest-neighbour pixels.
+    bool smoothTextures = false;
+    // Independent boards hosted side by side, as columns x rows.
+    int kioskColumns = 1;
+    int kioskRows = 1;
+    // Directory of card manifests; a board moves on to the next deck each
+    // time it is cleared.
+    std::optional<fs::path> decksPath;
+    std::size_t textureBudgetMegabytes = kDefaultTextureBudgetMegabytes;
+    TelemetryOptions telemetry;
+    // Watch the art, fonts and layout config and apply changes while running.
+    bool hotReload = false;
+    // Play against the computer, which remembers cards this well.
+    std::optional<memory::BeliefSettings> opponent;
+};
+
 class MemoryGame
 {
 public:
-    MemoryGame();
+    explicit MemoryGame(const LaunchOptions& options);
     void run();
 
 private:
     void processEvents();
+    void handleEvent(const sf::Event& event);
+    void handleKeyPress(sf::Keyboard::Key key);
+    void recordInput(const memory::InputRecord& record);
+    void applyReplayInputs();
+    void queueClick(sf::Vector2f point);
+    void applyPendingClicks();
+    bool isBoardIdle() const;
+    void waitForActivity();
+    void waitForNextTick();
+    void advanceSimulation(float seconds);
     void update(float deltaSeconds);
+    void stepInstance(GameInstance& instance, float deltaSeconds);
+    void reportBoardEvents();
+    void updateOpponents(float deltaSeconds);
+    Card presentedCard(std::size_t index) const;
+    sf::FloatRect cardBounds(std::size_t index) const;
+    void publishSnapshot();
+    void renderLoop();
+    void recordFrameTime();
     void render();
     void recomputeLayout();
-    void resetGame();
-    void handleLeftClick(sf::Vector2f point);
+    void loadLayoutConfig();
+    void applyFileChanges();
+    int instanceAt(sf::Vector2f point) const;
+    void resetGame(GameInstance& instance);
+    void handleLeftClick(GameInstance& instance, sf::Vector2f point, float lateSeconds = 0.0F);
+    void notePick(GameInstance& instance, int index, memory::PickResult result);
+    void updateHover(sf::Vector2f point);
 
-    void startFlipToFront(int index);
-    void startFlipToBack(int index);
-    void resolveCurrentPair();
-
-    bool isCardClickable(const Card& card) const;
-    bool areSelectedCardsStableFaceUp() const;
-    bool areSelectedCardsResolved() const;
-    bool selectedCardsMatch() const;
-
-    float computeFlipScaleX(const Card& card) const;
     bool shouldRenderFrontFace(const Card& card) const;
 
-    void drawText(const std::string& value, sf::Vector2f position, unsigned int size, sf::Color color, bool centered);
-    void drawCard(const Card& card);
-    std::string formatElapsedTime() const;
-    std::string makeInitials(const std::string& name) const;
-    const sf::Texture* textureForCharacter(int characterIndex) const;
+    void drawText(CachedText& cache, std::string_view value, sf::Vector2f position, unsigned int size, sf::Color color, bool centered);
+    void drawHudText(std::size_t instance, HudRole role, std::string_view value, sf::Vector2f position, unsigned int size, sf::Color color, bool centered);
+    void drawCard(const Card& card, const memory::CardPoseBatch& poses, std::size_t lane, const sf::FloatRect& bounds, bool hovered, sf::Vertex* vertices) const;
+    void drawCardLabel(const Card& card, const sf::FloatRect& bounds);
+    const sf::FloatRect* faceRegionForCharacter(int characterIndex) const;
+    void openAssetPack();
+    memory::BoardConfig loadDeck(const LaunchOptions& options);
+    std::optional<memory::BoardConfig> loadDeckDirectory(const fs::path& directory);
+    void appendDeck(const memory::CardManifest& manifest, std::string name);
+    const CharacterInfo& characterFor(int characterIndex) const;
     void loadFont();
-    void loadCharacterTextures();
-    void updateCardBoundsFromLayout();
-
+    void applyAssetReloads();
+    void reloadFont(const fs::path& path);
+    void queueTextureReload(const fs::path& path, std::vector<ImageLoadRequest>& requests);
+    void redrawCardsShowing(std::size_t face);
+    bool textureTierChanged(float cardHeight) const;
+    void loadCharacterTextures(float cardHeight);
+    bool updateTextureResidency();
+    void requestFaces(std::size_t deck);
+    bool loadPackedImage(int id, const std::string& name);
+    void placeImage(int id, const std::uint8_t* pixels, sf::Vector2u size, const std::string& name);
+    void pollTextureLoads();
+    void refreshMipmaps();
+    void initTextureAtlas();
+    std::optional<sf::FloatRect> addToAtlas(const sf::Image& image);
+    std::optional<sf::FloatRect> addToAtlas(const std::uint8_t* pixels, sf::Vector2u size);
+    std::optional<sf::FloatRect> reserveAtlasRegion(sf::Vector2u size);
+    std::optional<sf::FloatRect> reserveFaceRegion(sf::Vector2u size);
+    bool growAtlas(sf::Vector2u minimumSize);
+    void rebuildChromeMesh();
+    void uploadDirtyCards();
+    void uploadGpuCards();
+    void writeGpuGeometry(std::size_t slot);
+    void drawMesh(const sf::VertexBuffer& buffer, const std::vector<sf::Vertex>& vertices, std::size_t first, std::size_t count);
+    void drawProfilerOverlay();
+
+    // Simulation thread (the main thread, which owns the window's events):
+    // rules, input, layout and hit testing.
     sf::RenderWindow window_;
     sf::Clock frameClock_;
-    Layout layout_;
-
-    std::vector<Card> cards_;
-    PairPhase pairPhase_ = PairPhase::Idle;
-    int firstSelected_ = -1;
-    int secondSelected_ = -1;
-    float revealRemaining_ = 0.0F;
-    int moves_ = 0;
-    int matchedPairs_ = 0;
-    float elapsedSeconds_ = 0.0F;
-    bool timerRunning_ = false;
-    bool won_ = false;
+    sf::Vector2f windowSize_{0.0F, 0.0F};
+    std::uint64_t layoutVersion_ = 0;
+    LayoutConfig layoutConfig_;
+    bool layoutConfigChanged_ = false;
+    bool quit_ = false;
+    std::optional<FileWatcher> watcher_;
+    std::vector<fs::path> changedFiles_;
+
+    // Boards in a kioskGrid_.x by kioskGrid_.y wall; one outside kiosk mode.
+    std::vector<GameInstance> instances_;
+    sf::Vector2i kioskGrid_{1, 1};
+    std::size_t cardsPerInstance_ = 0;
+    // Several boards tick in parallel; absent for a single board.
+    std::optional<WorkerPool> workers_;
+    float accumulatorSeconds_ = 0.0F;
+    std::uint64_t simulationTick_ = 0;
+    std::vector<PendingClick> pendingClicks_;
+    std::optional<FrameProfiler::Clock::time_point> newInputAt_;
+    std::optional<FrameProfiler::Clock::time_point> unseenInputAt_;
+
+    std::optional<memory::InputLogWriter> recorder_;
+    std::optional<memory::InputLog> replay_;
+    std::size_t replayCursor_ = 0;
+    float replaySpeed_ = 1.0F;
+
+    ZoneTotals simulationZones_;
+    bool profilerOverlayVisible_ = false;
     bool layoutDirty_ = true;
-
+    bool redrawRequested_ = true;
+
+    // Snapshot bookkeeping: per-card kSnapshotSlots/kSnapshotUnseen bits, the
+    // cards each slot still has to copy, and those the renderer has not seen.
+    TripleBuffer<RenderSnapshot> snapshots_;
+    std::vector<std::uint8_t> snapshotPending_;
+    std::array<std::vector<std::int32_t>, kSnapshotSlots> slotPending_;
+    std::vector<std::int32_t> unseenCards_;
+    std::vector<std::int32_t> changedCards_;
+    SteadyStateAllocationCheck simulationAllocations_{"simulation loop"};
+
+    // Fed from both threads, each through a queue of its own.
+    TelemetryExporter telemetry_;
+
+    // Changed art and fonts, handed from the watcher to the render thread.
+    std::mutex assetReloadMutex_;
+    std::vector<fs::path> assetReloads_;
+    std::atomic<bool> assetReloadPending_{false};
+
+    // Render thread: once renderLoop() runs only it touches the members
+    // below. The deck (characters_) is read-only by then.
+    std::thread renderThread_;
+    std::atomic<bool> rendering_{false};
+    const RenderSnapshot* frame_ = nullptr;
+    std::uint64_t renderedLayoutVersion_ = 0;
+    ZoneTotals chargedZones_;
+    FrameProfiler profiler_;
+    // Scratch for the frame being drawn, reclaimed at the start of the next.
+    FrameArena frameArena_{kFrameArenaBytes};
+    SteadyStateAllocationCheck renderAllocations_{"render loop"};
+    bool textRebuilt_ = false; // sf::Text allocates whenever its string changes
+    std::optional<fs::path> profileCsvPath_;
+    CachedText profilerText_;
+    std::array<char, 512> profilerOverlayBuffer_{};
+    std::size_t profilerOverlayLength_ = 0U;
+    sf::Clock profilerOverlayClock_;
+    memory::TelemetryEvent frameTimes_{0U, memory::TelemetryEventType::FrameTimes, 0U, {}};
+    FrameProfiler::Clock::time_point frameTimesSince_{};
+
+    // Declared before font_: a font opened from the pack reads the mapping lazily.
+    std::optional<memory::AssetPack> assetPack_;
     sf::Font font_;
     bool fontLoaded_ = false;
-    std::unordered_map<int, sf::Texture> characterTextures_;
-
-    std::mt19937 random_{std::random_device{}()};
+    std::vector<std::array<CachedText, static_cast<std::size_t>(HudRole::Count)>> hudTexts_; // per instance
+    std::vector<CharacterInfo> characters_;
+    std::vector<Deck> decks_;
+    std::vector<CachedText> cardLabels_;
+    TextureAtlas atlas_;
+    bool smoothTextures_ = false;
+    std::size_t textureBudgetBytes_ = 0;
+    TextureResidency residency_;
+    std::vector<std::size_t> wantedDecks_;
+    std::vector<std::size_t> pinnedDecks_; // decks whose faces residency_ holds pinned
+    // One loader per batch of requested faces; finished ones are dropped.
+    std::vector<std::unique_ptr<AsyncImageLoader>> textureLoaders_;
+    std::vector<ImageLoadResult> loadedImages_;
+    std::vector<fs::path> reloadedFiles_;
+    // Faces (and the back) whose loose file changed while running; from then
+    // on they load from it rather than from the asset pack.
+    std::vector<std::uint8_t> looseFaces_;
+    bool looseBack_ = false;
+    std::vector<sf::Vertex> chromeVertices_;
+    std::vector<sf::Vertex> cardVertices_;
+    std::vector<std::int32_t> redrawCards_;
+    std::vector<std::uint8_t> redrawQueued_; // per card, already listed in redrawCards_
+    std::vector<std::int32_t> textureRedraws_; // cards whose art arrived since the last frame
+    bool redrawAllCards_ = false;
+    sf::VertexBuffer chromeBuffer_{sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static};
+    sf::VertexBuffer cardBuffer_{sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Dynamic};
+    bool useVertexBuffers_ = false;
+    GpuCardRenderer gpuCards_;
+    bool useGpuCards_ = false;
+    bool gpuGeometryDirty_ = true;
+    std::vector<std::int32_t> gpuCharacters_; // character each card's GPU geometry shows
 };
 
-MemoryGame::MemoryGame() :
+MemoryGame::MemoryGame(const LaunchOptions& options) :
     window_(sf::VideoMode::getDesktopMode(), "Star Wars Memory Game", sf::State::Fullscreen)
 {
     window_.setVerticalSyncEnabled(true);
-    cards_.resize(kCardCount);
-
-    loadFont();
-    loadCharacterTextures();
-    recomputeLayout();
-    resetGame();
-}
+    openAssetPack();
+    memory::BoardConfig config = loadDeck(options);
 
-void MemoryGame::run()
-{
-    while (window_.isOpen())
+    std::uint32_t seed = std::random_device{}();
+    if (options.replayPath)
     {
-        processEvents();
-
-        float dt = frameClock_.restart().asSeconds();
-        dt = std::min(dt, 0.1F);
-
-        update(dt);
-        render();
+        std::string error;
+        replay_ = memory::readInputLog(*options.replayPath, error);
+        if (replay_)
+        {
+            seed = replay_->header.seed;
+            config = replay_->header.board;
+            replaySpeed_ = std::max(options.replaySpeed, 0.0F);
+            std::cout << "Replaying " << replay_->records.size() << " inputs from " << options.replayPath->string() << "\n";
+            if (replay_->header.version < memory::kPortableDealInputLogVersion)
+            {
+                std::cerr << "Warning: input log version " << replay_->header.version
+                          << " predates portable shuffles; its deal may differ from the recorded one\n";
+            }
+        }
+        else
+        {
+            std::cerr << "Warning: cannot replay input log: " << error << "\n";
+        }
     }
-}
-
-void MemoryGame::processEvents()
-{
-    while (const std::optional event = window_.pollEvent())
+    else if (options.recordPath)
     {
-        if (event->is<sf::Event::Closed>())
+        recorder_ = memory::InputLogWriter::create(*options.recordPath, memory::InputLogHeader{seed, kSimulationStepSeconds, config});
+        if (!recorder_)
         {
-            window_.close();
-            continue;
+            std::cerr << "Warning: cannot create input log: " << options.recordPath->string() << "\n";
         }
-
-        if (const auto* keyPressed = event->getIf<sf::Event::KeyPressed>())
+    }
+    profileCsvPath_ = options.profileCsvPath;
+
+    // Further boards deal from their own seeds, so the first one still
+    // matches a single-board game (and its input logs) with the same seed.
+    kioskGrid_ = sf::Vector2i(std::max(options.kioskColumns, 1), std::max(options.kioskRows, 1));
+    const std::size_t instanceCount = static_cast<std::size_t>(kioskGrid_.x) * static_cast<std::size_t>(kioskGrid_.y);
+    cardsPerInstance_ = static_cast<std::size_t>(config.cardCount());
+    instances_.resize(instanceCount);
+    for (std::size_t index = 0; index < instanceCount; ++index)
+    {
+        GameInstance& instance = instances_[index];
+        instance.board.config = config;
+        instance.random.seed(seed + static_cast<std::uint32_t>(index));
+        // Kiosk boards start a deck apart, so the wall shows several themes.
+        if (decks_.size() > 1U)
         {
-            if (keyPressed->code == sf::Keyboard::Key::Escape)
-            {
-                window_.close();
-            }
-            continue;
+            instance.deck = index % decks_.size();
+            instance.board.config.characterCount = decks_[instance.deck].characterCount;
         }
+        instance.board.animating.reserve(cardsPerInstance_);
+        instance.dirty.reserve(cardsPerInstance_);
+    }
+    hudTexts_.resize(instanceCount);
+    if (options.opponent)
+    {
+        instances_.front().opponent = std::make_unique<AiOpponent>(*options.opponent, seed ^ 0x9E3779B9U);
+    }
 
-        if (const auto* resized = event->getIf<sf::Event::Resized>())
-        {
-            window_.setView(sf::View(sf::FloatRect(
-                sf::Vector2f(0.0F, 0.0F),
-                sf::Vector2f(
-                    static_cast<float>(resized->size.x),
-                    static_cast<float>(resized->size.y)))));
-            layoutDirty_ = true;
-            continue;
-        }
+    // The calling thread takes a share of every tick, so it is not counted.
+    const std::size_t threads = std::min<std::size_t>(instanceCount, std::max(1U, std::thread::hardware_concurrency())) - 1U;
+    if (threads > 0U)
+    {
+        workers_.emplace(threads);
+        std::cout << "Kiosk: " << instanceCount << " boards ticking on " << threads + 1U << " threads\n";
+    }
 
-        if (const auto* mousePressed = event->getIf<sf::Event::MouseButtonPressed>())
+    const std::size_t cardCount = cardsPerInstance_ * instanceCount;
+    chromeVertices_.resize((kChromeQuadCount + 1U) * kVerticesPerQuad * instanceCount);
+    cardVertices_.resize(cardCount * kVerticesPerCard);
+    // Every per-frame list is sized for all boards up front, so no
+    // amount of activity grows one after startup.
+    redrawCards_.reserve(cardCount);
+    redrawQueued_.assign(cardCount, 0U);
+    snapshotPending_.assign(cardCount, 0U);
+    for (std::vector<std::int32_t>& pending : slotPending_)
+    {
+        pending.reserve(cardCount);
+    }
+    unseenCards_.reserve(cardCount);
+    changedCards_.reserve(cardCount);
+    pendingClicks_.reserve(kPendingClickCapacity);
+    useVertexBuffers_ = sf::VertexBuffer::isAvailable() &&
+                        chromeBuffer_.create(chromeVertices_.size()) &&
+                        cardBuffer_.create(cardVertices_.size());
+    if (options.gpuAnimation)
+    {
+        useGpuCards_ = gpuCards_.create(cardCount);
+        if (!useGpuCards_)
         {
-            if (mousePressed->button == sf::Mouse::Button::Left)
-            {
-                handleLeftClick(
-                    sf::Vector2f(
-                        static_cast<float>(mousePressed->position.x),
-                        static_cast<float>(mousePressed->position.y)));
-            }
+            std::cerr << "Warning: card shader unavailable, animating cards on the CPU\n";
         }
     }
-}
 
-void MemoryGame::update(float deltaSeconds)
-{
-    if (layoutDirty_)
+    wantedDecks_.reserve(instanceCount * 2U);
+    pinnedDecks_.reserve(instanceCount * 2U);
+    textureBudgetBytes_ = options.textureBudgetMegabytes * 1024U * 1024U;
+    looseFaces_.assign(characters_.size(), 0U);
+    cardLabels_.resize(characters_.size());
+    for (CharacterInfo& character : characters_)
     {
-        recomputeLayout();
+        character.initials = makeInitials(character.name);
     }
 
-    if (timerRunning_ && !won_)
+    loadFont();
+    smoothTextures_ = options.smoothTextures;
+    if (options.telemetry.file || options.telemetry.udpHost)
+    {
+        (void)telemetry_.start(options.telemetry);
+    }
+    if (fs::exists(kLayoutConfigPath))
+    {
+        loadLayoutConfig();
+    }
+    if (options.hotReload)
+    {
+        watcher_.emplace(std::vector<fs::path>{kAssetDirectory, kProcessedDirectory, kFontDirectory});
+        std::cout << "Hot reload: watching " << kProcessedDirectory << ", " << kFontDirectory << " and " << kLayoutConfigPath << "\n";
+    }
+    recomputeLayout();
+    for (GameInstance& instance : instances_)
     {
-        elapsedSeconds_ += deltaSeconds;
+        resetGame(instance);
     }
+}
 
-    for (Card& card : cards_)
+void MemoryGame::run()
+{
+    // The window's events stay on this thread (macOS requires it); drawing
+    // and the vsync-blocked display() move to the render thread, so a slow
+    // frame never delays input or the simulation.
+    publishSnapshot();
+    (void)window_.setActive(false);
+    rendering_.store(true, std::memory_order_release);
+    renderThread_ = std::thread([this] { renderLoop(); });
+
+    while (!quit_)
     {
-        switch (card.state)
+        if (isBoardIdle() && !redrawRequested_ && !replay_)
         {
-            case CardState::FlippingToFront:
-            case CardState::FlippingToBack:
-            {
-                card.flipProgress += deltaSeconds / kFlipDurationSeconds;
-                const float normalized = clamp01(card.flipProgress);
+            waitForActivity();
+        }
+        else if (!replay_ || replaySpeed_ > 0.0F)
+        {
+            waitForNextTick();
+        }
 
-                if (!card.flipFaceSwapped && normalized >= 0.5F)
-                {
-                    card.frontVisible = (card.state == CardState::FlippingToFront);
-                    card.flipFaceSwapped = true;
-                }
+        {
+            const ProfileScope scope(simulationZones_, ProfileZone::ProcessEvents);
+            processEvents();
+        }
+        if (watcher_)
+        {
+            applyFileChanges();
+        }
 
-                if (normalized >= 1.0F)
-                {
-                    if (card.state == CardState::FlippingToFront)
-                    {
-                        card.state = CardState::FaceUp;
-                        card.frontVisible = true;
-                    }
-                    else
-                    {
-                        card.state = CardState::FaceDown;
-                        card.frontVisible = false;
-                    }
-                    card.flipProgress = 1.0F;
-                }
-                break;
-            }
-            case CardState::Matched:
+        // Events are left out: SFML queues them in a deque. A resize is the
+        // one thing the rest of an iteration may legitimately allocate for.
+        simulationAllocations_.begin();
+        const bool steady = !layoutDirty_;
+        const float frameSeconds = std::min(frameClock_.restart().asSeconds(), kMaxFrameSeconds);
+        if (!replay_)
+        {
+            advanceSimulation(frameSeconds);
+        }
+        else if (replaySpeed_ > 0.0F)
+        {
+            advanceSimulation(frameSeconds * replaySpeed_);
+        }
+        else
+        {
+            advanceSimulation(kSimulationStepSeconds * static_cast<float>(kMaxReplayTicksPerFrame));
+        }
+
+        if (layoutDirty_)
+        {
+            recomputeLayout();
+        }
+
+        const bool changed = std::any_of(
+            instances_.begin(),
+            instances_.end(),
+            [](const GameInstance& instance)
             {
-                card.removeProgress += deltaSeconds / kMatchRemoveDurationSeconds;
-                if (card.removeProgress >= 1.0F)
-                {
-                    card.removeProgress = 1.0F;
-                    card.state = CardState::Removed;
-                }
-                break;
-            }
-            case CardState::FaceDown:
-            case CardState::FaceUp:
-            case CardState::Removed:
-            default:
-                break;
+                return !instance.board.dirty.empty() ||
+                       static_cast<int>(std::floor(instance.board.elapsedSeconds)) != instance.publishedSecond;
+            });
+        if (redrawRequested_ || changed)
+        {
+            publishSnapshot();
+            redrawRequested_ = false;
         }
+        simulationAllocations_.end(steady);
     }
 
-    if (pairPhase_ == PairPhase::WaitingForSecondFlip)
+    rendering_.store(false, std::memory_order_release);
+    snapshots_.wake();
+    renderThread_.join();
+    (void)window_.setActive(true);
+    window_.close();
+
+    recordInput(memory::InputRecord{simulationTick_, memory::InputKind::End});
+
+    if (profileCsvPath_)
     {
-        if (areSelectedCardsStableFaceUp())
+        if (profiler_.writeCsv(*profileCsvPath_))
+        {
+            std::cout << "Wrote frame profile: " << profileCsvPath_->string() << "\n";
+        }
+        else
         {
-            revealRemaining_ = kRevealDurationSeconds;
-            pairPhase_ = PairPhase::RevealWindow;
+            std::cerr << "Warning: failed to write frame profile: " << profileCsvPath_->string() << "\n";
         }
     }
-    else if (pairPhase_ == PairPhase::RevealWindow)
+}
+
+void MemoryGame::publishSnapshot()
+{
+    // Every changed card is queued for all three slots and for the renderer;
+    // a slot then copies only its own queue when it is next written.
+    changedCards_.clear();
+    for (std::size_t instanceIndex = 0; instanceIndex < instances_.size(); ++instanceIndex)
     {
-        revealRemaining_ -= deltaSeconds;
-        if (revealRemaining_ <= 0.0F)
+        GameInstance& instance = instances_[instanceIndex];
+        memory::takeDirtyCards(instance.board, instance.dirty);
+        const std::int32_t firstCard = static_cast<std::int32_t>(instanceIndex * cardsPerInstance_);
+        for (const std::int32_t index : instance.dirty)
         {
-            resolveCurrentPair();
+            changedCards_.push_back(firstCard + index);
         }
+        instance.publishedSecond = static_cast<int>(std::floor(instance.board.elapsedSeconds));
     }
-    else if (pairPhase_ == PairPhase::Resolving)
+    for (const std::int32_t index : changedCards_)
     {
-        if (areSelectedCardsResolved())
+        std::uint8_t& pending = snapshotPending_[static_cast<std::size_t>(index)];
+        for (std::size_t slot = 0; slot < kSnapshotSlots; ++slot)
         {
-            if (selectedCardsMatch())
+            if ((pending & (1U << slot)) == 0U)
             {
-                matchedPairs_ += 1;
-                if (matchedPairs_ >= kPairCount)
-                {
-                    won_ = true;
-                    timerRunning_ = false;
-                }
+                slotPending_[slot].push_back(index);
             }
-
-            firstSelected_ = -1;
-            secondSelected_ = -1;
-            pairPhase_ = PairPhase::Idle;
         }
-    }
-}
-
-void MemoryGame::render()
-{
-    window_.clear(sf::Color(10, 13, 20));
-
-    sf::RectangleShape playFrame(layout_.playArea.size);
-    playFrame.setPosition(layout_.playArea.position);
-    playFrame.setFillColor(sf::Color(18, 24, 40));
-    window_.draw(playFrame);
-
-    sf::RectangleShape hud(layout_.hudArea.size);
-    hud.setPosition(layout_.hudArea.position);
-    hud.setFillColor(sf::Color(26, 35, 58));
-    window_.draw(hud);
-
-    sf::RectangleShape gridBg(layout_.gridArea.size);
-    gridBg.setPosition(layout_.gridArea.position);
-    gridBg.setFillColor(sf::Color(20, 27, 46));
-    window_.draw(gridBg);
-
-    sf::RectangleShape newGameButton(layout_.newGameButton.size);
-    newGameButton.setPosition(layout_.newGameButton.position);
-    newGameButton.setFillColor(sf::Color(78, 113, 170));
-    newGameButton.setOutlineThickness(layout_.outlineThickness);
-    newGameButton.setOutlineColor(sf::Color(199, 216, 241));
-    window_.draw(newGameButton);
-
-    for (const Card& card : cards_)
-    {
-        drawCard(card);
-    }
-
-    if (fontLoaded_)
-    {
-        drawText(
-            "Star Wars Memory",
-            sf::Vector2f(layout_.hudArea.position.x + 26.0F * layout_.scale, layout_.hudArea.position.y + 24.0F * layout_.scale),
-            layout_.titleSize,
-            sf::Color(245, 226, 121),
-            false);
-
-        drawText(
-            "Time: " + formatElapsedTime(),
-            sf::Vector2f(layout_.hudArea.position.x + 30.0F * layout_.scale, layout_.hudArea.position.y + 92.0F * layout_.scale),
-            layout_.statsSize,
-            sf::Color(228, 234, 248),
-            false);
-
-        drawText(
-            "Moves: " + std::to_string(moves_),
-            sf::Vector2f(layout_.hudArea.position.x + 410.0F * layout_.scale, layout_.hudArea.position.y + 92.0F * layout_.scale),
-            layout_.statsSize,
-            sf::Color(228, 234, 248),
-            false);
-
-        drawText(
-            "New Game",
-            sf::Vector2f(
-                layout_.newGameButton.position.x + layout_.newGameButton.size.x * 0.5F,
-                layout_.newGameButton.position.y + layout_.newGameButton.size.y * 0.5F),
-            layout_.buttonSize,
-            sf::Color::White,
-            true);
-    }
-
-    if (won_)
-    {
-        sf::RectangleShape overlay(layout_.playArea.size);
-        overlay.setPosition(layout_.playArea.position);
-        overlay.setFillColor(sf::Color(0, 0, 0, 125));
-        window_.draw(overlay);
-
-        if (fontLoaded_)
+        if ((pending & kSnapshotUnseen) == 0U)
         {
-            drawText(
-                "You Won!",
-                sf::Vector2f(
-                    layout_.playArea.position.x + layout_.playArea.size.x * 0.5F,
-                    layout_.playArea.position.y + layout_.playArea.size.y * 0.46F),
-                layout_.overlaySize,
-                sf::Color(255, 250, 197),
-                true);
-
-            drawText(
-                "Final Time: " + formatElapsedTime() + "   Moves: " + std::to_string(moves_),
-                sf::Vector2f(
-                    layout_.playArea.position.x + layout_.playArea.size.x * 0.5F,
-                    layout_.playArea.position.y + layout_.playArea.size.y * 0.54F),
-                layout_.statsSize,
-                sf::Color(236, 240, 253),
-                true);
+            unseenCards_.push_back(index);
         }
+        pending = static_cast<std::uint8_t>((1U << kSnapshotSlots) - 1U) | kSnapshotUnseen;
     }
 
-    window_.display();
-}
-
-void MemoryGame::recomputeLayout()
-{
-    const sf::Vector2u windowSize = window_.getSize();
-    const float width = static_cast<float>(windowSize.x);
-    const float height = static_cast<float>(windowSize.y);
-
-    layout_.scale = std::min(width / kVirtualWidth, height / kVirtualHeight);
-    if (layout_.scale <= 0.0F)
+    const std::size_t slot = snapshots_.backIndex();
+    RenderSnapshot& snapshot = snapshots_.back();
+    const std::size_t cardCount = cardsPerInstance_ * instances_.size();
+    if (snapshot.state.size() != cardCount)
     {
-        layout_.scale = 1.0F;
+        snapshot.instances.resize(instances_.size());
+        snapshot.characterIndex.resize(cardCount);
+        snapshot.state.resize(cardCount);
+        snapshot.flipProgress.resize(cardCount);
+        snapshot.removeProgress.resize(cardCount);
+        snapshot.previousPoses.resize(cardCount);
+        snapshot.animating.reserve(cardCount);
+        snapshot.dirty.reserve(cardCount);
     }
-
-    const sf::Vector2f playSize{kVirtualWidth * layout_.scale, kVirtualHeight * layout_.scale};
-    const sf::Vector2f playPos{
-        (width - playSize.x) * 0.5F,
-        (height - playSize.y) * 0.5F,
-    };
-
-    layout_.playArea = sf::FloatRect(playPos, playSize);
-
-    const float hudHeight = playSize.y * 0.18F;
-    layout_.hudArea = sf::FloatRect(playPos, sf::Vector2f(playSize.x, hudHeight));
-
-    const float outerPad = 26.0F * layout_.scale;
-    const float gridY = layout_.hudArea.position.y + layout_.hudArea.size.y + outerPad;
-    const float gridHeight = (layout_.playArea.position.y + layout_.playArea.size.y) - gridY - outerPad;
-    layout_.gridArea = sf::FloatRect(
-        sf::Vector2f(layout_.playArea.position.x + outerPad, gridY),
-        sf::Vector2f(layout_.playArea.size.x - outerPad * 2.0F, gridHeight));
-
-    const float gap = 14.0F * layout_.scale;
-    const float maxWidthFromGrid = (layout_.gridArea.size.x - gap * static_cast<float>(kColumns - 1)) / static_cast<float>(kColumns);
-    const float maxHeightFromGrid = (layout_.gridArea.size.y - gap * static_cast<float>(kRows - 1)) / static_cast<float>(kRows);
-
-    float cardWidth = maxWidthFromGrid;
-    float cardHeight = cardWidth / kCardAspectRatio;
-    if (cardHeight > maxHeightFromGrid)
+    for (const std::int32_t index : slotPending_[slot])
     {
-        cardHeight = maxHeightFromGrid;
-        cardWidth = cardHeight * kCardAspectRatio;
+        const std::size_t card = static_cast<std::size_t>(index);
+        const GameInstance& instance = instances_[card / cardsPerInstance_];
+        const std::size_t local = card % cardsPerInstance_;
+        snapshot.characterIndex[card] =
+            static_cast<std::int32_t>(decks_[instance.deck].firstCharacter) + instance.board.characterIndex[local];
+        snapshot.state[card] = instance.board.state[local];
+        snapshot.flipProgress[card] = instance.board.flipProgress[local];
+        snapshot.removeProgress[card] = instance.board.removeProgress[local];
+        snapshot.previousPoses[card] = instance.previousPoses[local];
+        snapshotPending_[card] &= static_cast<std::uint8_t>(~(1U << slot));
     }
+    slotPending_[slot].clear();
+
+    const bool layoutChanged = snapshot.layoutVersion != layoutVersion_;
+    snapshot.layoutVersion = layoutVersion_;
+    snapshot.tick = simulationTick_;
+    snapshot.blend = clamp01(accumulatorSeconds_ / kSimulationStepSeconds);
+    snapshot.animating.clear();
+    snapshot.hoveredCard = -1;
+    for (std::size_t instanceIndex = 0; instanceIndex < instances_.size(); ++instanceIndex)
+    {
+        const GameInstance& instance = instances_[instanceIndex];
+        const int firstCard = static_cast<int>(instanceIndex * cardsPerInstance_);
+        const auto toSlot = [firstCard](int card) { return card >= 0 ? firstCard + card : -1; };
+        for (const std::int32_t index : instance.board.animating)
+        {
+            snapshot.animating.push_back(firstCard + index);
+        }
+        if (instance.hoveredCard >= 0)
+        {
+            snapshot.hoveredCard = firstCard + instance.hoveredCard;
+        }
 
-    const float totalGridWidth = cardWidth * static_cast<float>(kColumns) + gap * static_cast<float>(kColumns - 1);
-    const float totalGridHeight = cardHeight * static_cast<float>(kRows) + gap * static_cast<float>(kRows - 1);
-    const float startX = layout_.gridArea.position.x + (layout_.gridArea.size.x - totalGridWidth) * 0.5F;
-    const float startY = layout_.gridArea.position.y + (layout_.gridArea.size.y - totalGridHeight) * 0.5F;
-
-    for (int row = 0; row < kRows; ++row)
+        InstanceView& view = snapshot.instances[instanceIndex];
+        if (layoutChanged)
+        {
+            view.layout = instance.layout;
+        }
+        view.firstSelected = toSlot(instance.board.firstSelected);
+        view.secondSelected = toSlot(instance.board.secondSelected);
+        view.moves = instance.board.moves;
+        view.elapsedSeconds = instance.board.elapsedSeconds;
+        view.won = instance.board.won;
+        view.deck = instance.deck;
+        view.versusComputer = instance.opponent != nullptr;
+        view.turn = instance.turn;
+        view.scores = instance.scores;
+    }
+    snapshot.dirty.assign(unseenCards_.begin(), unseenCards_.end());
+    snapshot.profilerOverlayVisible = profilerOverlayVisible_;
+    snapshot.simulationZones = simulationZones_;
+    const std::optional<FrameProfiler::Clock::time_point> inputReceivedAt = unseenInputAt_ ? unseenInputAt_ : newInputAt_;
+    snapshot.inputReceivedAt = inputReceivedAt;
+
+    // Once the renderer has taken the previous snapshot it only lacks what
+    // changed for this one; until then the unseen list keeps growing.
+    const bool previousSeen = snapshots_.publish();
+    unseenInputAt_ = previousSeen ? newInputAt_ : inputReceivedAt;
+    newInputAt_.reset();
+    if (previousSeen)
     {
-        for (int column = 0; column < kColumns; ++column)
+        for (const std::int32_t index : unseenCards_)
+        {
+            snapshotPending_[static_cast<std::size_t>(index)] &= static_cast<std::uint8_t>(~kSnapshotUnseen);
+        }
+        unseenCards_.clear();
+        for (const std::int32_t index : changedCards_)
         {
-            const int index = row * kColumns + column;
-            const sf::Vector2f cardPos{
-                startX + static_cast<float>(column) * (cardWidth + gap),
-                startY + static_cast<float>(row) * (cardHeight + gap),
-            };
-            layout_.cardBounds[static_cast<std::size_t>(index)] = sf::FloatRect(cardPos, sf::Vector2f(cardWidth, cardHeight));
+            snapshotPending_[static_cast<std::size_t>(index)] |= kSnapshotUnseen;
+            unseenCards_.push_back(index);
         }
     }
-
-    const sf::Vector2f buttonSize{230.0F * layout_.scale, 70.0F * layout_.scale};
-    const sf::Vector2f buttonPos{
-        layout_.hudArea.position.x + layout_.hudArea.size.x - buttonSize.x - 24.0F * layout_.scale,
-        layout_.hudArea.position.y + 26.0F * layout_.scale,
-    };
-    layout_.newGameButton = sf::FloatRect(buttonPos, buttonSize);
-
-    layout_.outlineThickness = std::max(1.0F, 2.0F * layout_.scale);
-    layout_.titleSize = static_cast<unsigned int>(std::max(20.0F, std::round(48.0F * layout_.scale)));
-    layout_.statsSize = static_cast<unsigned int>(std::max(14.0F, std::round(30.0F * layout_.scale)));
-    layout_.buttonSize = static_cast<unsigned int>(std::max(14.0F, std::round(28.0F * layout_.scale)));
-    layout_.cardLabelSize = static_cast<unsigned int>(std::max(12.0F, std::round(24.0F * layout_.scale)));
-    layout_.overlaySize = static_cast<unsigned int>(std::max(22.0F, std::round(56.0F * layout_.scale)));
-
-    updateCardBoundsFromLayout();
-    layoutDirty_ = false;
 }
 
-void MemoryGame::resetGame()
+void MemoryGame::renderLoop()
 {
-    std::vector<int> shuffledCharacters;
-    shuffledCharacters.reserve(kCardCount);
-
-    for (int i = 0; i < kPairCount; ++i)
+    (void)window_.setActive(true);
+    for (;;)
     {
-        shuffledCharacters.push_back(i);
-        shuffledCharacters.push_back(i);
-    }
+        // Read the count before checking for shutdown: run() stops rendering
+        // and then wakes, so one of the two is always seen.
+        const std::uint64_t seen = snapshots_.publishCount();
+        if (!rendering_.load(std::memory_order_acquire))
+        {
+            break;
+        }
+        const bool fresh = snapshots_.acquire();
+        if (!fresh && frame_ != nullptr && textureLoaders_.empty())
+        {
+            snapshots_.waitForPublish(seen);
+            continue;
+        }
+        frame_ = &snapshots_.front();
+
+        renderAllocations_.begin();
+        frameArena_.reset();
+        textRebuilt_ = false;
+        bool steady = textureLoaders_.empty();
+        profiler_.beginFrame();
+        for (std::size_t zone = 0; zone < kProfileZoneCount; ++zone)
+        {
+            const FrameProfiler::Clock::duration total = frame_->simulationZones.elapsed[zone];
+            profiler_.addZoneTime(static_cast<ProfileZone>(zone), total - chargedZones_.elapsed[zone]);
+            chargedZones_.elapsed[zone] = total;
+        }
 
-    std::shuffle(shuffledCharacters.begin(), shuffledCharacters.end(), random_);
+        if (frame_->layoutVersion != renderedLayoutVersion_)
+        {
+            // Art is loaded here, once the card size is known, and again
+            // when a resize makes another resolution tier the better fit.
+            const float cardHeight = frame_->instances.front().layout.cardSize.y;
+            if (textureTierChanged(cardHeight))
+            {
+                loadCharacterTextures(cardHeight);
+            }
+            const sf::Vector2f size = frame_->instances.front().layout.windowSize;
+            window_.setView(sf::View(sf::FloatRect(sf::Vector2f(0.0F, 0.0F), size)));
+            rebuildChromeMesh();
+            gpuGeometryDirty_ = true;
+            redrawAllCards_ = true;
+            renderedLayoutVersion_ = frame_->layoutVersion;
+            steady = false;
+        }
+        if (assetReloadPending_.exchange(false, std::memory_order_acquire))
+        {
+            applyAssetReloads();
+            steady = false;
+        }
+        if (updateTextureResidency())
+        {
+            steady = false;
+        }
+        pollTextureLoads();
 
-    for (int cardIndex = 0; cardIndex < kCardCount; ++cardIndex)
+        render();
+        // display() is the driver's business and stays outside the check.
+        renderAllocations_.end(steady && !textRebuilt_);
+        {
+            const ProfileScope scope(profiler_, ProfileZone::Display);
+            window_.display();
+        }
+        if (fresh && frame_->inputReceivedAt)
+        {
+            profiler_.recordInputLatency(FrameProfiler::Clock::now() - *frame_->inputReceivedAt);
+        }
+        profiler_.endFrame();
+        if (telemetry_.enabled())
+        {
+            recordFrameTime();
+        }
+    }
+    if (telemetry_.enabled() && frameTimesSince_ != FrameProfiler::Clock::time_point{})
     {
-        Card& card = cards_[static_cast<std::size_t>(cardIndex)];
-        card.slotIndex = cardIndex;
-        card.characterIndex = shuffledCharacters[static_cast<std::size_t>(cardIndex)];
-        card.state = CardState::FaceDown;
-        card.bounds = layout_.cardBounds[static_cast<std::size_t>(cardIndex)];
-        card.frontVisible = false;
-        card.flipFaceSwapped = false;
-        card.flipProgress = 0.0F;
-        card.removeProgress = 0.0F;
+        frameTimes_.micros = telemetry_.micros();
+        telemetry_.record(TelemetryProducer::Render, frameTimes_);
     }
-
-    firstSelected_ = -1;
-    secondSelected_ = -1;
-    pairPhase_ = PairPhase::Idle;
-    revealRemaining_ = 0.0F;
-    matchedPairs_ = 0;
-    moves_ = 0;
-    elapsedSeconds_ = 0.0F;
-    timerRunning_ = false;
-    won_ = false;
+    (void)window_.setActive(false);
 }
 
-void MemoryGame::handleLeftClick(sf::Vector2f point)
+// Frame times go out as a histogram every kTelemetryFrameWindow of drawing
+// rather than one event per frame.
+void MemoryGame::recordFrameTime()
 {
-    if (layoutDirty_)
+    const FrameProfiler::Clock::time_point now = FrameProfiler::Clock::now();
+    if (frameTimesSince_ == FrameProfiler::Clock::time_point{})
     {
-        recomputeLayout();
+        frameTimesSince_ = now;
     }
-
-    if (containsPoint(layout_.newGameButton, point))
+    const std::uint32_t frameMicros = static_cast<std::uint32_t>(profiler_.lastFrameMs() * 1000.0F);
+    frameTimes_.values[memory::telemetryFrameBucket(frameMicros)] += 1U;
+    if (now - frameTimesSince_ < kTelemetryFrameWindow)
     {
-        resetGame();
         return;
     }
+    frameTimes_.micros = telemetry_.micros();
+    telemetry_.record(TelemetryProducer::Render, frameTimes_);
+    frameTimes_.values = {};
+    frameTimesSince_ = {};
+}
 
-    if (won_ || pairPhase_ != PairPhase::Idle)
+void MemoryGame::processEvents()
+{
+    while (const std::optional event = window_.pollEvent())
     {
-        return;
+        handleEvent(*event);
     }
+}
 
-    int clickedIndex = -1;
-    for (int index = 0; index < kCardCount; ++index)
+void MemoryGame::handleEvent(const sf::Event& event)
+{
+    if (event.is<sf::Event::Closed>())
     {
-        const Card& card = cards_[static_cast<std::size_t>(index)];
-        if (!containsPoint(card.bounds, point))
-        {
-            continue;
-        }
+        quit_ = true;
+        return;
+    }
 
-        if (!isCardClickable(card))
+    if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
+    {
+        if (replay_)
         {
+            // Only allow aborting a replay; any other live key would diverge from the log.
+            if (keyPressed->code == sf::Keyboard::Key::Escape)
+            {
+                quit_ = true;
+            }
             return;
         }
 
-        clickedIndex = index;
-        break;
+        recordInput(memory::InputRecord{simulationTick_, memory::InputKind::Key, 0.0F, 0.0F, static_cast<int>(keyPressed->code)});
+        handleKeyPress(keyPressed->code);
+        return;
     }
 
-    if (clickedIndex < 0)
+    if (event.is<sf::Event::Resized>())
     {
+        // The render thread resets its view when the new layout arrives.
+        layoutDirty_ = true;
+        redrawRequested_ = true;
         return;
     }
 
-    if (!timerRunning_)
+    if (event.is<sf::Event::FocusGained>())
     {
-        timerRunning_ = true;
+        redrawRequested_ = true;
+        return;
     }
 
-    startFlipToFront(clickedIndex);
-
-    if (firstSelected_ < 0)
+    if (const auto* mouseMoved = event.getIf<sf::Event::MouseMoved>())
     {
-        firstSelected_ = clickedIndex;
+        if (!replay_)
+        {
+            updateHover(sf::Vector2f(static_cast<float>(mouseMoved->position.x), static_cast<float>(mouseMoved->position.y)));
+        }
         return;
     }
 
-    if (secondSelected_ < 0 && clickedIndex != firstSelected_)
+    if (const auto* mousePressed = event.getIf<sf::Event::MouseButtonPressed>())
     {
-        secondSelected_ = clickedIndex;
-        moves_ += 1;
-        pairPhase_ = PairPhase::WaitingForSecondFlip;
+        if (mousePressed->button == sf::Mouse::Button::Left && !replay_)
+        {
+            queueClick(sf::Vector2f(
+                static_cast<float>(mousePressed->position.x),
+                static_cast<float>(mousePressed->position.y)));
+        }
     }
 }
 
-void MemoryGame::startFlipToFront(int index)
+void MemoryGame::handleKeyPress(sf::Keyboard::Key key)
 {
-    Card& card = cards_[static_cast<std::size_t>(index)];
-    if (card.state != CardState::FaceDown)
+    if (key == sf::Keyboard::Key::Escape)
     {
-        return;
+        quit_ = true;
+    }
+    else if (key == sf::Keyboard::Key::F3)
+    {
+        profilerOverlayVisible_ = !profilerOverlayVisible_;
+        redrawRequested_ = true;
     }
-
-    card.state = CardState::FlippingToFront;
-    card.flipProgress = 0.0F;
-    card.flipFaceSwapped = false;
 }
 
-void MemoryGame::startFlipToBack(int index)
+void MemoryGame::recordInput(const memory::InputRecord& record)
 {
-    Card& card = cards_[static_cast<std::size_t>(index)];
-    if (card.state != CardState::FaceUp)
+    if (recorder_)
     {
-        return;
+        recorder_->write(record);
     }
-
-    card.state = CardState::FlippingToBack;
-    card.flipProgress = 0.0F;
-    card.flipFaceSwapped = false;
 }
 
-void MemoryGame::resolveCurrentPair()
+void MemoryGame::applyReplayInputs()
 {
-    if (firstSelected_ < 0 || secondSelected_ < 0)
+    if (!replay_)
     {
         return;
     }
 
-    Card& first = cards_[static_cast<std::size_t>(firstSelected_)];
-    Card& second = cards_[static_cast<std::size_t>(secondSelected_)];
-
-    if (first.characterIndex == second.characterIndex)
+    const std::vector<memory::InputRecord>& records = replay_->records;
+    while (replayCursor_ < records.size() && records[replayCursor_].tick <= simulationTick_)
     {
-        first.state = CardState::Matched;
-        second.state = CardState::Matched;
-        first.removeProgress = 0.0F;
-        second.removeProgress = 0.0F;
-        first.frontVisible = true;
-        second.frontVisible = true;
+        const memory::InputRecord& record = records[replayCursor_++];
+        switch (record.kind)
+        {
+            case memory::InputKind::Click:
+                if (layoutDirty_)
+                {
+                    recomputeLayout();
+                }
+                handleLeftClick(instances_.front(), fromVirtual(instances_.front().layout, sf::Vector2f(record.x, record.y)), record.lateSeconds);
+                break;
+            case memory::InputKind::Key:
+                handleKeyPress(static_cast<sf::Keyboard::Key>(record.key));
+                break;
+            case memory::InputKind::End:
+                std::cout << "Replay finished at tick " << simulationTick_ << "\n";
+                quit_ = true;
+                break;
+            default:
+                break;
+        }
+        redrawRequested_ = true;
     }
-    else
+
+    if (replayCursor_ >= records.size() && !quit_)
     {
-        startFlipToBack(firstSelected_);
-        startFlipToBack(secondSelected_);
+        // A log without an End record (e.g. from a crashed session) hands
+        // control back to live input once exhausted.
+        std::cout << "Replay input exhausted at tick " << simulationTick_ << "\n";
+        replay_.reset();
     }
-
-    pairPhase_ = PairPhase::Resolving;
 }
 
-bool MemoryGame::isCardClickable(const Card& card) const
+void MemoryGame::queueClick(sf::Vector2f point)
 {
-    return card.state == CardState::FaceDown;
-}
+    if (layoutDirty_)
+    {
+        recomputeLayout();
+    }
 
-bool MemoryGame::areSelectedCardsStableFaceUp() const
-{
-    if (firstSelected_ < 0 || secondSelected_ < 0)
+    const int instance = instanceAt(point);
+    if (instance < 0)
     {
-        return false;
+        return;
     }
 
-    const Card& first = cards_[static_cast<std::size_t>(firstSelected_)];
-    const Card& second = cards_[static_cast<std::size_t>(secondSelected_)];
-    return first.state == CardState::FaceUp && second.state == CardState::FaceUp;
+    // The click lands this far past the last simulated tick; the boundary
+    // after it is the first one that has already happened by then.
+    const float sinceTick = accumulatorSeconds_ + std::min(frameClock_.getElapsedTime().asSeconds(), kMaxFrameSeconds);
+    const float ticksAhead = std::floor(sinceTick / kSimulationStepSeconds) + 1.0F;
+    pendingClicks_.push_back(PendingClick{
+        toVirtual(instances_[static_cast<std::size_t>(instance)].layout, point),
+        simulationTick_ + static_cast<std::uint64_t>(ticksAhead),
+        ticksAhead * kSimulationStepSeconds - sinceTick,
+        FrameProfiler::Clock::now(),
+        static_cast<std::size_t>(instance)});
 }
 
-bool MemoryGame::selectedCardsMatch() const
+void MemoryGame::applyPendingClicks()
 {
-    if (firstSelected_ < 0 || secondSelected_ < 0)
+    std::size_t applied = 0;
+    while (applied < pendingClicks_.size() && pendingClicks_[applied].dueTick <= simulationTick_)
     {
-        return false;
+        const PendingClick& click = pendingClicks_[applied++];
+        memory::InputRecord record{simulationTick_, memory::InputKind::Click, click.virtualPoint.x, click.virtualPoint.y};
+        record.lateSeconds = click.lateSeconds;
+        recordInput(record);
+
+        GameInstance& instance = instances_[click.instance];
+        handleLeftClick(instance, fromVirtual(instance.layout, click.virtualPoint), click.lateSeconds);
+        if (!newInputAt_)
+        {
+            newInputAt_ = click.receivedAt;
+        }
+        redrawRequested_ = true;
     }
+    pendingClicks_.erase(pendingClicks_.begin(), pendingClicks_.begin() + static_cast<std::ptrdiff_t>(applied));
+}
 
-    const Card& first = cards_[static_cast<std::size_t>(firstSelected_)];
-    const Card& second = cards_[static_cast<std::size_t>(secondSelected_)];
-    return first.characterIndex == second.characterIndex;
+bool MemoryGame::isBoardIdle() const
+{
+    return !layoutDirty_ && pendingClicks_.empty() &&
+           std::none_of(
+               instances_.begin(),
+               instances_.end(),
+               [](const GameInstance& instance)
+               {
+                   // The computer's picks arrive on ticks, not as events.
+                   return memory::isAnimating(instance.board) ||
+                          (instance.opponent && instance.turn == kComputerSeat && !instance.board.won);
+               });
 }
 
-bool MemoryGame::areSelectedCardsResolved() const
+void MemoryGame::waitForActivity()
 {
-    if (firstSelected_ < 0 || secondSelected_ < 0)
+    // Nothing animates, so block until input arrives. With the timer running
+    // the HUD clock still has to tick, so wake just after the next whole second.
+    // In kiosk mode that is the soonest second on any board with a clock.
+    sf::Time timeout = sf::Time::Zero;
+    bool timerRunning = false;
+    float untilNextSecond = 1.0F;
+    for (const GameInstance& instance : instances_)
     {
-        return false;
+        const memory::BoardState& board = instance.board;
+        if (board.timerRunning && !board.won)
+        {
+            timerRunning = true;
+            untilNextSecond = std::min(untilNextSecond, std::floor(board.elapsedSeconds) + 1.0F - board.elapsedSeconds);
+        }
+    }
+    if (timerRunning)
+    {
+        timeout = sf::seconds(std::max(untilNextSecond, 0.0F) + kIdleWakeSlackSeconds);
+    }
+    // Watched files are only looked at between waits.
+    if (watcher_ && (timeout == sf::Time::Zero || timeout > sf::seconds(kHotReloadPollSeconds)))
+    {
+        timeout = sf::seconds(kHotReloadPollSeconds);
     }
 
-    const Card& first = cards_[static_cast<std::size_t>(firstSelected_)];
-    const Card& second = cards_[static_cast<std::size_t>(secondSelected_)];
+    const std::optional event = window_.waitEvent(timeout);
 
-    if (selectedCardsMatch())
+    // Simulate the blocked interval here, unclamped and before the waking
+    // event is handled, so it only advances the timer and a click that ends
+    // the wait does not see the whole idle gap as animation time. Without the
+    // timer nothing would change, so the interval is simply dropped.
+    const float idleSeconds = frameClock_.restart().asSeconds();
+    if (timerRunning)
     {
-        return first.state == CardState::Removed && second.state == CardState::Removed;
+        advanceSimulation(idleSeconds);
     }
 
-    return first.state == CardState::FaceDown && second.state == CardState::FaceDown;
+    if (event)
+    {
+        handleEvent(*event);
+    }
 }
 
-float MemoryGame::computeFlipScaleX(const Card& card) const
+void MemoryGame::waitForNextTick()
 {
-    if (card.state != CardState::FlippingToFront && card.state != CardState::FlippingToBack)
+    // Something is animating: sleep until the next tick is due, but wake for
+    // input at once so a click is applied within the current tick.
+    const float speed = replay_ ? replaySpeed_ : 1.0F;
+    const float untilTick = (kSimulationStepSeconds - accumulatorSeconds_) / speed - frameClock_.getElapsedTime().asSeconds();
+    if (untilTick <= 0.0F)
     {
-        return 1.0F;
+        return;
     }
 
-    const float progress = clamp01(card.flipProgress);
-    if (progress < 0.5F)
+    if (const std::optional event = window_.waitEvent(sf::seconds(untilTick)))
     {
-        return std::max(0.02F, 1.0F - progress * 2.0F);
+        handleEvent(*event);
     }
-    return std::max(0.02F, (progress - 0.5F) * 2.0F);
 }
 
-bool MemoryGame::shouldRenderFrontFace(const Card& card) const
+void MemoryGame::advanceSimulation(float seconds)
 {
-    switch (card.state)
+    accumulatorSeconds_ += seconds;
+    while (accumulatorSeconds_ >= kSimulationStepSeconds && !quit_)
     {
-        case CardState::FaceDown:
-            return false;
-        case CardState::FlippingToFront:
-            return card.flipProgress >= 0.5F;
-        case CardState::FaceUp:
-            return true;
-        case CardState::FlippingToBack:
-            return card.flipProgress < 0.5F;
-        case CardState::Matched:
-            return true;
-        case CardState::Removed:
-            return false;
-        default:
-            return false;
+        applyReplayInputs();
+        update(kSimulationStepSeconds);
+        updateOpponents(kSimulationStepSeconds);
+        if (telemetry_.enabled())
+        {
+            reportBoardEvents();
+        }
+        accumulatorSeconds_ -= kSimulationStepSeconds;
+        ++simulationTick_;
+        applyPendingClicks();
     }
 }
 
-void MemoryGame::drawText(const std::string& value, sf::Vector2f position, unsigned int size, sf::Color color, bool centered)
+void MemoryGame::update(float deltaSeconds)
 {
-    if (!fontLoaded_)
+    const ProfileScope scope(simulationZones_, ProfileZone::Update);
+    if (!workers_)
     {
+        for (GameInstance& instance : instances_)
+        {
+            stepInstance(instance, deltaSeconds);
+        }
         return;
     }
 
-    sf::Text text(font_, value, size);
-    text.setFillColor(color);
+    // Boards share nothing while they step, so each is a job of its own.
+    auto job = [this, deltaSeconds](std::size_t index) { stepInstance(instances_[index], deltaSeconds); };
+    workers_->run(instances_.size(), job);
+}
 
-    if (centered)
+void MemoryGame::stepInstance(GameInstance& instance, float deltaSeconds)
+{
+    const memory::BoardState& board = instance.board;
+    for (const std::int32_t index : board.animating)
     {
-        const sf::FloatRect bounds = text.getLocalBounds();
-        text.setOrigin(
-            sf::Vector2f(
-                bounds.position.x + bounds.size.x * 0.5F,
-                bounds.position.y + bounds.size.y * 0.5F));
+        const std::size_t slot = static_cast<std::size_t>(index);
+        instance.previousPoses[slot] = CardPose{
+            simulationTick_, board.state[slot], board.flipProgress[slot], board.removeProgress[slot]};
     }
+    memory::step(instance.board, deltaSeconds);
+}
 
-    text.setPosition(position);
-    window_.draw(text);
+// Pairs resolve and games are won inside step(), which kiosk boards run on
+// worker threads; the simulation thread reports them afterwards, so it stays
+// the only producer on its queue. A pair takes several ticks to resolve, so
+// looking once per tick sees every one.
+void MemoryGame::reportBoardEvents()
+{
+    for (std::size_t index = 0; index < instances_.size(); ++index)
+    {
+        GameInstance& instance = instances_[index];
+        const memory::BoardState& board = instance.board;
+        if (board.pairPhase == memory::PairPhase::Resolving && instance.reportedPhase != memory::PairPhase::Resolving)
+        {
+            const std::size_t first = static_cast<std::size_t>(board.firstSelected);
+            const std::size_t second = static_cast<std::size_t>(board.secondSelected);
+            const bool matched = board.characterIndex[first] == board.characterIndex[second];
+            telemetry_.record(
+                TelemetryProducer::Simulation,
+                matched ? memory::TelemetryEventType::Match : memory::TelemetryEventType::Mismatch,
+                index,
+                {static_cast<std::uint32_t>(first),
+                 static_cast<std::uint32_t>(second),
+                 static_cast<std::uint32_t>(board.characterIndex[first]),
+                 static_cast<std::uint32_t>(board.moves)});
+        }
+        instance.reportedPhase = board.pairPhase;
+
+        if (board.won && !instance.reportedWon)
+        {
+            telemetry_.record(
+                TelemetryProducer::Simulation,
+                memory::TelemetryEventType::Win,
+                index,
+                {static_cast<std::uint32_t>(board.moves), static_cast<std::uint32_t>(board.elapsedSeconds * 1000.0F)});
+        }
+        instance.reportedWon = board.won;
+    }
 }
 
-void MemoryGame::drawCard(const Card& card)
+// The computer plays its turn here, on the simulation thread, so its picks
+// go through the same rules and bookkeeping as a click.
+void MemoryGame::updateOpponents(float deltaSeconds)
 {
-    if (card.state == CardState::Removed)
+    for (GameInstance& instance : instances_)
     {
-        return;
+        if (!instance.opponent)
+        {
+            continue;
+        }
+        const int index = instance.opponent->update(instance.board, instance.turn == kComputerSeat, deltaSeconds);
+        if (index >= 0)
+        {
+            notePick(instance, index, memory::applyPick(instance.board, index));
+        }
     }
+}
 
-    float vanishScale = 1.0F;
-    std::uint8_t alpha = 255U;
-    if (card.state == CardState::Matched)
+Card MemoryGame::presentedCard(std::size_t index) const
+{
+    Card card;
+    card.characterIndex = frame_->characterIndex[index];
+    card.state = frame_->state[index];
+    card.flipProgress = frame_->flipProgress[index];
+    card.removeProgress = frame_->removeProgress[index];
+
+    // Only blend within one animation; a pose from an older tick or a state
+    // change during the last tick (flip started or finished) snaps.
+    const CardPose& previous = frame_->previousPoses[index];
+    if (!memory::isCardAnimating(card) || previous.tick + 1U != frame_->tick || previous.state != card.state)
+    {
+        return card;
+    }
+
+    const float alpha = frame_->blend;
+    card.flipProgress = previous.flipProgress + (card.flipProgress - previous.flipProgress) * alpha;
+    card.removeProgress = previous.removeProgress + (card.removeProgress - previous.removeProgress) * alpha;
+    return card;
+}
+
+sf::FloatRect MemoryGame::cardBounds(std::size_t index) const
+{
+    return frame_->instances[index / cardsPerInstance_].layout.cardBounds(index % cardsPerInstance_);
+}
+
+void MemoryGame::render()
+{
+    const ProfileScope scope(profiler_, ProfileZone::Render);
+    // Every board has the same card size and style; only their positions differ.
+    const Layout& shared = frame_->instances.front().layout;
+    const std::size_t instanceCount = frame_->instances.size();
+    window_.clear(sf::Color(10, 13, 20));
+
+    if (useGpuCards_)
+    {
+        uploadGpuCards();
+    }
+    else
     {
-        const float t = clamp01(card.removeProgress);
-        vanishScale = 1.0F - (0.40F * t);
-        alpha = static_cast<std::uint8_t>(std::lround(255.0F * (1.0F - t)));
+        uploadDirtyCards();
     }
 
-    const float flipScale = computeFlipScaleX(card);
-    const float scaleX = std::max(0.02F, flipScale * vanishScale);
-    const float scaleY = std::max(0.02F, vanishScale);
-    const bool showFront = shouldRenderFrontFace(card);
+    drawMesh(chromeBuffer_, chromeVertices_, 0U, kChromeQuadCount * kVerticesPerQuad * instanceCount);
+    if (useGpuCards_)
+    {
+        GpuCardStyle style;
+        style.halfSize = sf::Vector2f(shared.cardSize.x * 0.5F, shared.cardSize.y * 0.5F);
+        style.outlineThickness = shared.outlineThickness;
+        style.hoveredCard = frame_->hoveredCard;
+        style.blend = frame_->blend;
+        style.outlineFront = kCardOutlineFrontColor;
+        style.outlineBack = kCardOutlineBackColor;
+        style.outlineHover = kCardOutlineHoverColor;
+        style.backTint = atlas_.backRegion ? sf::Color::White : kCardBackFallbackColor;
+        gpuCards_.draw(window_, atlas_.texture, style);
+        profiler_.countDraw(&atlas_.texture);
+    }
+    else
+    {
+        drawMesh(cardBuffer_, cardVertices_, 0U, cardVertices_.size());
+    }
 
-    sf::RectangleShape body(card.bounds.size);
-    body.setOrigin(sf::Vector2f(card.bounds.size.x * 0.5F, card.bounds.size.y * 0.5F));
-    body.setPosition(sf::Vector2f(
-        card.bounds.position.x + card.bounds.size.x * 0.5F,
-        card.bounds.position.y + card.bounds.size.y * 0.5F));
-    body.setScale(sf::Vector2f(scaleX, scaleY));
-    body.setOutlineThickness(layout_.outlineThickness);
+    // Only selected or animating cards can show a face, so labels never scan the board.
+    for (const std::int32_t index : frame_->animating)
+    {
+        const std::size_t slot = static_cast<std::size_t>(index);
+        drawCardLabel(presentedCard(slot), cardBounds(slot));
+    }
 
-    if (showFront)
+    for (std::size_t instance = 0; instance < instanceCount; ++instance)
     {
-        if (const sf::Texture* texture = textureForCharacter(card.characterIndex))
+        const InstanceView& view = frame_->instances[instance];
+        const Layout& layout = view.layout;
+        for (const int index : {view.firstSelected, view.secondSelected})
+        {
+            const std::size_t slot = static_cast<std::size_t>(index);
+            if (index >= 0 && !memory::isCardAnimating(presentedCard(slot)))
+            {
+                drawCardLabel(presentedCard(slot), cardBounds(slot));
+            }
+        }
+
+        if (fontLoaded_)
+        {
+            drawHudText(
+                instance,
+                HudRole::Title,
+                "Star Wars Memory",
+                sf::Vector2f(layout.hudArea.position.x + 26.0F * layout.scale, layout.hudArea.position.y + 24.0F * layout.scale),
+                layout.titleSize,
+                sf::Color(245, 226, 121),
+                false);
+
+            drawHudText(
+                instance,
+                HudRole::Time,
+                HudString().append("Time: ").append(formatElapsedTime(view.elapsedSeconds).view()).view(),
+                sf::Vector2f(layout.hudArea.position.x + 30.0F * layout.scale, layout.hudArea.position.y + 92.0F * layout.scale),
+                layout.statsSize,
+                sf::Color(228, 234, 248),
+                false);
+
+            // Against the computer the pairs each seat holds replace the move count.
+            HudString moves;
+            if (view.versusComputer)
+            {
+                moves.append("You: ").append(view.scores[kPlayerSeat]).append("   CPU: ").append(view.scores[kComputerSeat]);
+                moves.append(view.turn == kPlayerSeat ? "   (your turn)" : "   (CPU's turn)");
+            }
+            else
+            {
+                moves.append("Moves: ").append(view.moves);
+            }
+            drawHudText(
+                instance,
+                HudRole::Moves,
+                moves.view(),
+                sf::Vector2f(layout.hudArea.position.x + 410.0F * layout.scale, layout.hudArea.position.y + 92.0F * layout.scale),
+                layout.statsSize,
+                sf::Color(228, 234, 248),
+                false);
+
+            drawHudText(
+                instance,
+                HudRole::NewGame,
+                "New Game",
+                sf::Vector2f(
+                    layout.newGameButton.position.x + layout.newGameButton.size.x * 0.5F,
+                    layout.newGameButton.position.y + layout.newGameButton.size.y * 0.5F),
+                layout.buttonSize,
+                sf::Color::White,
+                true);
+        }
+
+        if (!view.won)
         {
-            body.setTexture(texture, true);
-            body.setFillColor(sf::Color(255, 255, 255, alpha));
+            continue;
         }
-        else
+
+        // Win overlays follow all the base chrome, one quad per board.
+        drawMesh(chromeBuffer_, chromeVertices_, (kChromeQuadCount * instanceCount + instance) * kVerticesPerQuad, kVerticesPerQuad);
+        if (fontLoaded_)
         {
-            body.setTexture(nullptr, true);
-            sf::Color color = kCharacters[static_cast<std::size_t>(card.characterIndex)].fallbackColor;
-            color.a = alpha;
-            body.setFillColor(color);
+            const int lead = view.scores[kPlayerSeat] - view.scores[kComputerSeat];
+            drawHudText(
+                instance,
+                HudRole::WinTitle,
+                !view.versusComputer || lead > 0 ? "You Won!" : (lead < 0 ? "CPU Won!" : "Draw!"),
+                sf::Vector2f(
+                    layout.playArea.position.x + layout.playArea.size.x * 0.5F,
+                    layout.playArea.position.y + layout.playArea.size.y * 0.46F),
+                layout.overlaySize,
+                sf::Color(255, 250, 197),
+                true);
+
+            HudString stats;
+            stats.append("Final Time: ").append(formatElapsedTime(view.elapsedSeconds).view());
+            if (view.versusComputer)
+            {
+                stats.append("   Pairs: ").append(view.scores[kPlayerSeat]).append(" - ").append(view.scores[kComputerSeat]);
+            }
+            else
+            {
+                stats.append("   Moves: ").append(view.moves);
+            }
+            drawHudText(
+                instance,
+                HudRole::WinStats,
+                stats.view(),
+                sf::Vector2f(
+                    layout.playArea.position.x + layout.playArea.size.x * 0.5F,
+                    layout.playArea.position.y + layout.playArea.size.y * 0.54F),
+                layout.statsSize,
+                sf::Color(236, 240, 253),
+                true);
         }
-        body.setOutlineColor(sf::Color(20, 22, 30, alpha));
     }
-    else
+
+    if (frame_->profilerOverlayVisible)
     {
-        body.setTexture(nullptr, true);
-        body.setFillColor(sf::Color(30, 49, 86, alpha));
-        body.setOutlineColor(sf::Color(175, 201, 238, alpha));
+        drawProfilerOverlay();
     }
+}
 
-    window_.draw(body);
+void MemoryGame::recomputeLayout()
+{
+    const ProfileScope scope(simulationZones_, ProfileZone::RecomputeLayout);
+    const sf::Vector2u windowSize = window_.getSize();
+    const sf::Vector2f size(static_cast<float>(windowSize.x), static_cast<float>(windowSize.y));
+
+    // Resizes are coalesced into this one call per loop iteration; a drag
+    // that ends where it started, or a focus change, leaves nothing to redo.
+    layoutDirty_ = false;
+    if (windowSize_ == size && layoutVersion_ > 0U && !layoutConfigChanged_)
+    {
+        return;
+    }
+    windowSize_ = size;
+    layoutConfigChanged_ = false;
 
-    if (showFront && !textureForCharacter(card.characterIndex) && fontLoaded_)
+    // Kiosk boards tile the window evenly, each laid out as if it were alone.
+    const sf::Vector2f tile(size.x / static_cast<float>(kioskGrid_.x), size.y / static_cast<float>(kioskGrid_.y));
+    for (std::size_t index = 0; index < instances_.size(); ++index)
     {
-        drawText(
-            makeInitials(kCharacters[static_cast<std::size_t>(card.characterIndex)].name),
-            sf::Vector2f(
-                card.bounds.position.x + card.bounds.size.x * 0.5F,
-                card.bounds.position.y + card.bounds.size.y * 0.5F),
-            layout_.cardLabelSize,
-            sf::Color(10, 12, 20, alpha),
-            true);
+        GameInstance& instance = instances_[index];
+        const int column = static_cast<int>(index) % kioskGrid_.x;
+        const int row = static_cast<int>(index) / kioskGrid_.x;
+        const sf::FloatRect area(
+            sf::Vector2f(tile.x * static_cast<float>(column), tile.y * static_cast<float>(row)),
+            tile);
+        const int columns = instance.board.config.columns;
+        const int rows = instance.board.config.rows;
+        instance.layout = computeLayout(size, area, columns, rows, layoutConfig_);
+        instance.hitTest.setRegularGrid(instance.layout.gridOrigin, instance.layout.cardSize, instance.layout.cardPitch, columns, rows);
     }
+
+    // No cards are marked dirty: the render thread redraws them all when it
+    // sees the new version, so the snapshots copy no card data for a resize.
+    ++layoutVersion_;
 }
 
-std::string MemoryGame::formatElapsedTime() const
+void MemoryGame::loadLayoutConfig()
 {
-    const int totalSeconds = static_cast<int>(std::floor(elapsedSeconds_));
-    const int hours = totalSeconds / 3600;
-    const int minutes = (totalSeconds % 3600) / 60;
-    const int seconds = totalSeconds % 60;
-
-    std::ostringstream stream;
-    stream << std::setfill('0');
-    if (hours > 0)
+    std::string error;
+    const std::optional<LayoutConfig> config = readLayoutConfig(kLayoutConfigPath, error);
+    if (!config)
     {
-        stream << std::setw(2) << hours << ":";
+        // The last good config stays in effect, so a half-edited file is harmless.
+        std::cerr << "Warning: ignoring layout config: " << error << "\n";
+        return;
     }
-    stream << std::setw(2) << minutes << ":" << std::setw(2) << seconds;
-    return stream.str();
+    layoutConfig_ = *config;
+    layoutConfigChanged_ = true;
+    layoutDirty_ = true;
 }
 
-std::string MemoryGame::makeInitials(const std::string& name) const
+// Layout changes apply here, as a relayout at the new version; art and fonts
+// belong to the render thread, which picks them up with its next frame.
+void MemoryGame::applyFileChanges()
 {
-    std::string output;
-    bool takeNext = true;
-
-    for (char c : name)
+    watcher_->poll(changedFiles_);
+    bool assetsChanged = false;
+    for (const fs::path& path : changedFiles_)
     {
-        const bool separator = (c == ' ' || c == '-');
-        if (takeNext && std::isalnum(static_cast<unsigned char>(c)) != 0)
+        if (path == fs::path(kLayoutConfigPath))
         {
-            output.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
-            if (output.size() >= 3)
-            {
-                break;
-            }
+            std::cout << "Reloading " << path.string() << "\n";
+            loadLayoutConfig();
+        }
+        else if (path.parent_path() == fs::path(kProcessedDirectory) || path.parent_path() == fs::path(kFontDirectory))
+        {
+            const std::lock_guard lock(assetReloadMutex_);
+            assetReloads_.push_back(path);
+            assetsChanged = true;
         }
-        takeNext = separator;
     }
+    if (assetsChanged)
+    {
+        assetReloadPending_.store(true, std::memory_order_release);
+        redrawRequested_ = true; // publishing wakes an idle render thread
+    }
+}
 
-    if (output.empty())
+int MemoryGame::instanceAt(sf::Vector2f point) const
+{
+    if (point.x < 0.0F || point.y < 0.0F || point.x >= windowSize_.x || point.y >= windowSize_.y)
     {
-        return "???";
+        return -1;
     }
-    return output;
+
+    const int column = std::min(static_cast<int>(point.x / windowSize_.x * static_cast<float>(kioskGrid_.x)), kioskGrid_.x - 1);
+    const int row = std::min(static_cast<int>(point.y / windowSize_.y * static_cast<float>(kioskGrid_.y)), kioskGrid_.y - 1);
+    return row * kioskGrid_.x + column;
 }
 
-const sf::Texture* MemoryGame::textureForCharacter(int characterIndex) const
+void MemoryGame::resetGame(GameInstance& instance)
 {
-    const auto iter = characterTextures_.find(characterIndex);
-    if (iter == characterTextures_.end())
+    const bool abandoned = instance.board.moves > 0 && !instance.board.won;
+    const std::uint32_t abandonedMoves = static_cast<std::uint32_t>(instance.board.moves);
+    const std::uint32_t abandonedMillis = static_cast<std::uint32_t>(instance.board.elapsedSeconds * 1000.0F);
+
+    // Clearing a board moves it on to the next deck; restarting mid-game keeps it.
+    if (instance.board.won && decks_.size() > 1U)
     {
-        return nullptr;
+        instance.deck = (instance.deck + 1U) % decks_.size();
+        instance.board.config.characterCount = decks_[instance.deck].characterCount;
     }
-    return &iter->second;
+    memory::resetBoard(instance.board, instance.random);
+    instance.previousPoses.assign(static_cast<std::size_t>(instance.board.cardCount()), CardPose{});
+    instance.hoveredCard = -1;
+    instance.reportedPhase = memory::PairPhase::Idle;
+    instance.reportedWon = false;
+    instance.turn = kPlayerSeat;
+    instance.scores = {};
+    if (instance.opponent)
+    {
+        instance.opponent->reset(instance.board);
+    }
+
+    const memory::BoardConfig& config = instance.board.config;
+    telemetry_.record(
+        TelemetryProducer::Simulation,
+        abandoned ? memory::TelemetryEventType::GameReset : memory::TelemetryEventType::GameStart,
+        static_cast<std::size_t>(&instance - instances_.data()),
+        {static_cast<std::uint32_t>(instance.deck),
+         static_cast<std::uint32_t>(config.columns),
+         static_cast<std::uint32_t>(config.rows),
+         abandoned ? abandonedMoves : 0U,
+         abandoned ? abandonedMillis : 0U});
 }
 
-void MemoryGame::loadFont()
+void MemoryGame::handleLeftClick(GameInstance& instance, sf::Vector2f point, float lateSeconds)
 {
-    const std::array<fs::path, 8> candidates{{
-        fs::path("assets/fonts/PressStart2P-Regular.ttf"),
-        fs::path("assets/fonts/VT323-Regular.ttf"),
-        fs::path("assets/fonts/font.ttf"),
-        fs::path("/System/Library/Fonts/Supplemental/Arial.ttf"),
-        fs::path("/System/Library/Fonts/Supplemental/Arial Unicode.ttf"),
-        fs::path("/Library/Fonts/Arial.ttf"),
-        fs::path("C:/Windows/Fonts/arial.ttf"),
-        fs::path("C:/Windows/Fonts/segoeui.ttf"),
-    }};
+    if (layoutDirty_)
+    {
+        recomputeLayout();
+    }
 
-    for (const fs::path& candidate : candidates)
+    if (containsPoint(instance.layout.newGameButton, point))
     {
-        if (!fs::exists(candidate))
+        resetGame(instance);
+        return;
+    }
+
+    memory::BoardState& board = instance.board;
+    if (board.won || board.pairPhase != memory::PairPhase::Idle || instance.turn != kPlayerSeat)
+    {
+        return;
+    }
+
+    const int index = instance.hitTest.pick(point);
+    if (index < 0)
+    {
+        return;
+    }
+    notePick(instance, index, memory::applyPick(board, index, lateSeconds));
+}
+
+// Bookkeeping shared by both seats' picks. Against the computer a matched
+// pair scores for the seat that turned it and keeps the turn; a miss passes it.
+void MemoryGame::notePick(GameInstance& instance, int index, memory::PickResult result)
+{
+    if (result == memory::PickResult::Rejected)
+    {
+        return;
+    }
+    telemetry_.record(
+        TelemetryProducer::Simulation,
+        memory::TelemetryEventType::Pick,
+        static_cast<std::size_t>(&instance - instances_.data()),
+        {static_cast<std::uint32_t>(index), result == memory::PickResult::FirstCard ? 1U : 2U});
+
+    if (!instance.opponent)
+    {
+        return;
+    }
+    instance.opponent->observe(instance.board, index);
+    if (result == memory::PickResult::SecondCard)
+    {
+        const memory::BoardState& board = instance.board;
+        if (board.characterIndex[static_cast<std::size_t>(board.firstSelected)] ==
+            board.characterIndex[static_cast<std::size_t>(board.secondSelected)])
         {
-            continue;
+            instance.scores[static_cast<std::size_t>(instance.turn)] += 1;
         }
-        if (font_.openFromFile(candidate.string()))
+        else
         {
-            fontLoaded_ = true;
-            std::cout << "Loaded font: " << candidate.string() << "\n";
-            return;
+            instance.turn = kComputerSeat - instance.turn;
         }
     }
-
-    std::cerr << "Warning: no usable font found. UI text will not be rendered.\n";
 }
 
-void MemoryGame::loadCharacterTextures()
+void MemoryGame::updateHover(sf::Vector2f point)
 {
-    characterTextures_.clear();
-
-    for (int index = 0; index < kPairCount; ++index)
+    if (layoutDirty_)
     {
-        const CharacterInfo& info = kCharacters[static_cast<std::size_t>(index)];
-        const fs::path path = fs::path("assets/processed") / (info.slug + ".png");
+        recomputeLayout();
+    }
 
-        if (!fs::exists(path))
+    // The pointer hovers at most one card on one board.
+    const int hoveredInstance = instanceAt(point);
+    for (std::size_t index = 0; index < instances_.size(); ++index)
+    {
+        GameInstance& instance = instances_[index];
+        const int card = static_cast<int>(index) == hoveredInstance ? instance.hitTest.pick(point) : -1;
+        if (card == instance.hoveredCard)
         {
             continue;
         }
 
-        sf::Texture texture;
-        if (!texture.loadFromFile(path.string()))
+        for (const int changed : {instance.hoveredCard, card})
         {
-            std::cerr << "Warning: failed to load texture: " << path.string() << "\n";
-            continue;
+            if (changed >= 0 && changed < instance.board.cardCount())
+            {
+                memory::markCardDirty(instance.board, changed);
+            }
         }
+        instance.hoveredCard = card;
+        redrawRequested_ = true;
+    }
+}
 
-        texture.setSmooth(false);
-        characterTextures_.emplace(index, std::move(texture));
+bool MemoryGame::shouldRenderFrontFace(const Card& card) const
+{
+    switch (card.state)
+    {
+        case CardState::FaceDown:
+            return false;
+        case CardState::FlippingToFront:
+            return card.flipProgress >= 0.5F;
+        case CardState::FaceUp:
+            return true;
+        case CardState::FlippingToBack:
+            return card.flipProgress < 0.5F;
+        case CardState::Matched:
+            return true;
+        case CardState::Removed:
+            return false;
+        default:
+            return false;
     }
 }
 
-void MemoryGame::updateCardBoundsFromLayout()
+void MemoryGame::drawText(CachedText& cache, std::string_view value, sf::Vector2f position, unsigned int size, sf::Color color, bool centered)
 {
-    for (int index = 0; index < kCardCount; ++index)
+    if (!fontLoaded_)
+    {
+        return;
+    }
+
+    if (!cache.text)
+    {
+        cache.text.emplace(font_, "", size);
+        cache.size = size;
+        cache.value.clear();
+    }
+
+    sf::Text& text = *cache.text;
+    bool relayout = false;
+    if (cache.value != value)
+    {
+        cache.value.assign(value);
+        text.setString(cache.value);
+        relayout = true;
+    }
+    if (cache.size != size)
+    {
+        cache.size = size;
+        text.setCharacterSize(size);
+        relayout = true;
+    }
+    if (cache.centered != centered)
+    {
+        cache.centered = centered;
+        relayout = true;
+    }
+
+    if (relayout)
     {
-        cards_[static_cast<std::size_t>(index)].bounds = layout_.cardBounds[static_cast<std::size_t>(index)];
+        textRebuilt_ = true;
+        sf::Vector2f origin{0.0F, 0.0F};
+        if (centered)
+        {
+            const sf::FloatRect bounds = text.getLocalBounds();
+            origin = sf::Vector2f(
+                bounds.position.x + bounds.size.x * 0.5F,
+                bounds.position.y + bounds.size.y * 0.5F);
+        }
+        text.setOrigin(origin);
     }
+
+    text.setFillColor(color);
+    text.setPosition(position);
+    window_.draw(text);
+    profiler_.countDraw(&font_.getTexture(size));
 }
 
-} // namespace
+void MemoryGame::drawHudText(std::size_t instance, HudRole role, std::string_view value, sf::Vector2f position, unsigned int size, sf::Color color, bool centered)
+{
+    drawText(hudTexts_[instance][static_cast<std::size_t>(role)], value, position, size, color, centered);
+}
 
-int main()
+void MemoryGame::drawCard(const Card& card, const memory::CardPoseBatch& poses, std::size_t lane, const sf::FloatRect& bounds, bool hovered, sf::Vertex* vertices) const
 {
-    MemoryGame game;
+    CardArt art;
+    art.solidRegion = atlas_.solidRegion;
+    art.backRegion = atlas_.backRegion ? &*atlas_.backRegion : nullptr;
+    art.faceRegion = faceRegionForCharacter(card.characterIndex);
+    art.faceFallback = characterFor(card.characterIndex).fallbackColor;
+    writeCardVertices(card, poses, lane, bounds, frame_->instances.front().layout.outlineThickness, hovered, art, vertices);
+}
+
+void MemoryGame::drawCardLabel(const Card& card, const sf::FloatRect& bounds)
+{
+    if (card.state == CardState::Removed || !fontLoaded_)
+    {
+        return;
+    }
+
+    if (!shouldRenderFrontFace(card) || faceRegionForCharacter(card.characterIndex) != nullptr)
+    {
+        return;
+    }
+
+    std::uint8_t alpha = 255U;
+    if (card.state == CardState::Matched)
+    {
+        alpha = static_cast<std::uint8_t>(std::lround(255.0F * (1.0F - clamp01(card.removeProgress))));
+    }
+
+    const std::size_t characterIndex = static_cast<std::size_t>(card.characterIndex) % characters_.size();
+    drawText(
+        cardLabels_[characterIndex],
+        characters_[characterIndex].initials,
+        sf::Vector2f(
+            bounds.position.x + bounds.size.x * 0.5F,
+            bounds.position.y + bounds.size.y * 0.5F),
+        frame_->instances.front().layout.cardLabelSize,
+        sf::Color(10, 12, 20, alpha),
+        true);
+}
+
+const sf::FloatRect* MemoryGame::faceRegionForCharacter(int characterIndex) const
+{
+    if (characterIndex < 0 || static_cast<std::size_t>(characterIndex) >= atlas_.faceRegions.size())
+    {
+        return nullptr;
+    }
+
+    const std::optional<sf::FloatRect>& region = atlas_.faceRegions[static_cast<std::size_t>(characterIndex)];
+    return region ? &*region : nullptr;
+}
+
+const CharacterInfo& MemoryGame::characterFor(int characterIndex) const
+{
+    // A replay recorded with a larger deck still draws; its extra characters wrap.
+    return characters_[static_cast<std::size_t>(characterIndex) % characters_.size()];
+}
+
+void MemoryGame::openAssetPack()
+{
+    // The pack is optional: without it the game falls back to loose files.
+    std::string error;
+    assetPack_ = memory::AssetPack::open(kAssetPackPath, error);
+    if (assetPack_)
+    {
+        std::cout << "Loaded asset pack: " << kAssetPackPath << " (" << assetPack_->entries().size() << " entries)\n";
+    }
+    else if (fs::exists(kAssetPackPath))
+    {
+        std::cerr << "Warning: ignoring asset pack: " << error << "\n";
+    }
+}
+
+memory::BoardConfig MemoryGame::loadDeck(const LaunchOptions& options)
+{
+    memory::BoardConfig config;
+    characters_.clear();
+    decks_.clear();
+    if (options.decksPath)
+    {
+        if (const std::optional<memory::BoardConfig> board = loadDeckDirectory(*options.decksPath))
+        {
+            config = *board;
+        }
+    }
+
+    if (decks_.empty())
+    {
+        std::string error;
+        std::optional<memory::CardManifest> manifest;
+        const memory::AssetPackEntry* packed = assetPack_ ? assetPack_->find("manifest") : nullptr;
+        if (packed != nullptr && packed->kind == memory::AssetKind::Data)
+        {
+            manifest = memory::parseCardManifest(
+                std::string_view(reinterpret_cast<const char*>(packed->data.data()), packed->data.size()),
+                error);
+        }
+        else
+        {
+            manifest = memory::readCardManifest(kManifestPath, error);
+        }
+
+        if (manifest)
+        {
+            config = manifest->board;
+            appendDeck(*manifest, "cards");
+        }
+        else
+        {
+            std::cerr << "Warning: cannot read card manifest (" << error << "). Using the built-in deck.\n";
+            characters_.assign(kDefaultCharacters.begin(), kDefaultCharacters.end());
+            for (CharacterInfo& character : characters_)
+            {
+                character.processed = fs::path(kProcessedDirectory) / (character.slug + ".png");
+            }
+            decks_.push_back(Deck{"built-in", 0U, static_cast<int>(characters_.size())});
+            config.characterCount = static_cast<int>(characters_.size());
+        }
+    }
+
+    if (options.boardColumns > 0 && options.boardRows > 0)
+    {
+        config.columns = options.boardColumns;
+        config.rows = options.boardRows;
+    }
+    if (!memory::isValidConfig(config))
+    {
+        std::cerr << "Warning: invalid board size " << config.columns << "x" << config.rows << ". Using "
+                  << memory::kDefaultColumns << "x" << memory::kDefaultRows << ".\n";
+        config.columns = memory::kDefaultColumns;
+        config.rows = memory::kDefaultRows;
+    }
+    return config;
+}
+
+std::optional<memory::BoardConfig> MemoryGame::loadDeckDirectory(const fs::path& directory)
+{
+    // Only the manifests are read up front; their art streams in once a
+    // board deals from them.
+    std::vector<fs::path> manifests;
+    std::error_code error;
+    for (fs::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+    {
+        if (it->path().extension() == ".json")
+        {
+            manifests.push_back(it->path());
+        }
+    }
+    if (error)
+    {
+        std::cerr << "Warning: cannot read deck directory " << directory.string() << ": " << error.message() << "\n";
+        return std::nullopt;
+    }
+    std::sort(manifests.begin(), manifests.end());
+
+    // Every board keeps one layout, so the first deck's board size holds for all.
+    std::optional<memory::BoardConfig> board;
+    for (const fs::path& path : manifests)
+    {
+        std::string manifestError;
+        const std::optional<memory::CardManifest> manifest = memory::readCardManifest(path, manifestError);
+        if (!manifest)
+        {
+            std::cerr << "Warning: skipping deck: " << manifestError << "\n";
+            continue;
+        }
+        if (!board)
+        {
+            board = manifest->board;
+        }
+        appendDeck(*manifest, path.stem().string());
+    }
+
+    if (decks_.empty())
+    {
+        std::cerr << "Warning: no usable decks in " << directory.string() << ". Using the default deck.\n";
+        return std::nullopt;
+    }
+    std::cout << "Loaded " << decks_.size() << " decks (" << characters_.size() << " characters) from " << directory.string() << "\n";
+    return board;
+}
+
+void MemoryGame::appendDeck(const memory::CardManifest& manifest, std::string name)
+{
+    const std::size_t first = characters_.size();
+    characters_.reserve(first + manifest.cards.size());
+    for (const memory::CardManifestEntry& entry : manifest.cards)
+    {
+        const auto known = std::find_if(
+            kDefaultCharacters.begin(),
+            kDefaultCharacters.end(),
+            [&entry](const CharacterInfo& character) { return character.slug == entry.slug; });
+
+        // Spread unknown characters over muted colours so neighbours stay distinguishable.
+        const unsigned int palette = static_cast<unsigned int>(characters_.size());
+        const sf::Color fallback = known != kDefaultCharacters.end()
+            ? known->fallbackColor
+            : sf::Color(
+                  static_cast<std::uint8_t>(96U + (palette * 53U) % 128U),
+                  static_cast<std::uint8_t>(96U + (palette * 97U) % 128U),
+                  static_cast<std::uint8_t>(96U + (palette * 29U) % 128U));
+        characters_.push_back(CharacterInfo{entry.name, entry.slug, fallback, {}, fs::path(entry.processed)});
+    }
+    decks_.push_back(Deck{std::move(name), first, static_cast<int>(manifest.cards.size())});
+}
+
+void MemoryGame::loadFont()
+{
+    if (assetPack_)
+    {
+        const memory::AssetPackEntry* entry = assetPack_->find("font");
+        if (entry != nullptr && entry->kind == memory::AssetKind::Font
+            && font_.openFromMemory(entry->data.data(), entry->data.size()))
+        {
+            fontLoaded_ = true;
+            return;
+        }
+    }
+
+    const std::array<fs::path, 8> candidates{{
+        fs::path("assets/fonts/PressStart2P-Regular.ttf"),
+        fs::path("assets/fonts/VT323-Regular.ttf"),
+        fs::path("assets/fonts/font.ttf"),
+        fs::path("/System/Library/Fonts/Supplemental/Arial.ttf"),
+        fs::path("/System/Library/Fonts/Supplemental/Arial Unicode.ttf"),
+        fs::path("/Library/Fonts/Arial.ttf"),
+        fs::path("C:/Windows/Fonts/arial.ttf"),
+        fs::path("C:/Windows/Fonts/segoeui.ttf"),
+    }};
+
+    for (const fs::path& candidate : candidates)
+    {
+        if (!fs::exists(candidate))
+        {
+            continue;
+        }
+        if (font_.openFromFile(candidate.string()))
+        {
+            fontLoaded_ = true;
+            std::cout << "Loaded font: " << candidate.string() << "\n";
+            return;
+        }
+    }
+
+    std::cerr << "Warning: no usable font found. UI text will not be rendered.\n";
+}
+
+void MemoryGame::applyAssetReloads()
+{
+    {
+        const std::lock_guard lock(assetReloadMutex_);
+        reloadedFiles_.swap(assetReloads_);
+    }
+
+    std::vector<ImageLoadRequest> requests;
+    for (const fs::path& path : reloadedFiles_)
+    {
+        const fs::path extension = path.extension();
+        if (path.parent_path() == fs::path(kFontDirectory) && (extension == ".ttf" || extension == ".otf"))
+        {
+            reloadFont(path);
+        }
+        else if (path.parent_path() == fs::path(kProcessedDirectory) && extension == ".png")
+        {
+            queueTextureReload(path, requests);
+        }
+    }
+    reloadedFiles_.clear();
+
+    // Decoded off-thread like any other face; the old art stays up until
+    // pollTextureLoads() swaps the new pixels in at a frame boundary.
+    if (!requests.empty())
+    {
+        textureLoaders_.push_back(std::make_unique<AsyncImageLoader>(std::move(requests)));
+    }
+}
+
+void MemoryGame::reloadFont(const fs::path& path)
+{
+    sf::Font font;
+    if (!font.openFromFile(path))
+    {
+        std::cerr << "Warning: cannot reload font: " << path.string() << "\n";
+        return;
+    }
+    std::cout << "Reloaded font: " << path.string() << "\n";
+
+    // Texts only lay their glyphs out again when their string or size
+    // changes, so every cached one is rebuilt against the new font.
+    for (std::array<CachedText, static_cast<std::size_t>(HudRole::Count)>& texts : hudTexts_)
+    {
+        texts.fill(CachedText{});
+    }
+    std::fill(cardLabels_.begin(), cardLabels_.end(), CachedText{});
+    profilerText_ = CachedText{};
+    font_ = std::move(font);
+    fontLoaded_ = true;
+    redrawAllCards_ = true;
+}
+
+void MemoryGame::queueTextureReload(const fs::path& path, std::vector<ImageLoadRequest>& requests)
+{
+    // Before the first tier is chosen nothing is loaded yet, so the new
+    // file is simply what loads.
+    const bool loaded = atlas_.cardHeight > 0.0F;
+    const fs::path wanted = path.lexically_normal();
+    if (wanted == fs::path(kCardBackPath))
+    {
+        looseBack_ = true;
+        if (loaded)
+        {
+            requests.push_back(ImageLoadRequest{-1, path, atlas_.cardHeight});
+        }
+    }
+
+    for (std::size_t face = 0; face < characters_.size(); ++face)
+    {
+        if (characters_[face].processed.lexically_normal() != wanted)
+        {
+            continue;
+        }
+        looseFaces_[face] = 1U;
+        if (!loaded)
+        {
+            continue;
+        }
+
+        // Absent faces pick the new file up when they are next requested.
+        switch (residency_.state(face))
+        {
+            case TextureResidency::State::Resident:
+            case TextureResidency::State::Loading:
+                requests.push_back(ImageLoadRequest{static_cast<int>(face), path, atlas_.cardHeight});
+                break;
+            case TextureResidency::State::Failed:
+                if (residency_.pinned(face))
+                {
+                    residency_.setLoading(face);
+                    requests.push_back(ImageLoadRequest{static_cast<int>(face), path, atlas_.cardHeight});
+                }
+                else
+                {
+                    residency_.setAbsent(face);
+                }
+                break;
+            case TextureResidency::State::Absent:
+                break;
+        }
+    }
+}
+
+bool MemoryGame::textureTierChanged(float cardHeight) const
+{
+    if (atlas_.cardHeight <= 0.0F)
+    {
+        return true;
+    }
+    return memory::chooseTextureDivisor(atlas_.sourceHeight, cardHeight)
+        != memory::chooseTextureDivisor(atlas_.sourceHeight, atlas_.cardHeight);
+}
+
+void MemoryGame::loadCharacterTextures(float cardHeight)
+{
+    // Reloading starts from an empty atlas, so only one tier is ever resident.
+    // Faces come back deck by deck through updateTextureResidency().
+    textureLoaders_.clear();
+    initTextureAtlas();
+    atlas_.cardHeight = cardHeight;
+
+    // Every card shows the back, so it loads with the tier rather than a deck.
+    if (looseBack_ || !loadPackedImage(-1, "card_back"))
+    {
+        std::vector<ImageLoadRequest> requests;
+        requests.push_back(ImageLoadRequest{-1, fs::path(kCardBackPath), cardHeight});
+        textureLoaders_.push_back(std::make_unique<AsyncImageLoader>(std::move(requests)));
+    }
+}
+
+bool MemoryGame::updateTextureResidency()
+{
+    if (atlas_.cardHeight <= 0.0F)
+    {
+        return false;
+    }
+
+    // The decks on screen, plus the next deck of every board showing its win
+    // overlay, so that deck's art is in by the time the next game is dealt.
+    wantedDecks_.clear();
+    for (const InstanceView& view : frame_->instances)
+    {
+        wantedDecks_.push_back(view.deck);
+        if (view.won && decks_.size() > 1U)
+        {
+            wantedDecks_.push_back((view.deck + 1U) % decks_.size());
+        }
+    }
+    std::sort(wantedDecks_.begin(), wantedDecks_.end());
+    wantedDecks_.erase(std::unique(wantedDecks_.begin(), wantedDecks_.end()), wantedDecks_.end());
+    if (wantedDecks_ == pinnedDecks_)
+    {
+        return false;
+    }
+
+    // Pinning the new set before unpinning the old keeps a deck that is in
+    // both off the eviction list.
+    const auto pinDecks = [this](const std::vector<std::size_t>& decks, bool pin)
+    {
+        for (const std::size_t deck : decks)
+        {
+            const Deck& info = decks_[deck];
+            for (std::size_t face = info.firstCharacter; face < info.firstCharacter + static_cast<std::size_t>(info.characterCount); ++face)
+            {
+                pin ? residency_.pin(face) : residency_.unpin(face);
+            }
+        }
+    };
+    pinDecks(wantedDecks_, true);
+    pinDecks(pinnedDecks_, false);
+    pinnedDecks_.swap(wantedDecks_);
+
+    // Boards in play before prefetches, so a full budget favours what is on screen.
+    for (const InstanceView& view : frame_->instances)
+    {
+        requestFaces(view.deck);
+    }
+    for (const std::size_t deck : pinnedDecks_)
+    {
+        requestFaces(deck);
+    }
+    refreshMipmaps();
+    return true;
+}
+
+void MemoryGame::requestFaces(std::size_t deck)
+{
+    // Decoding runs on worker threads, so cards show their fallback colour
+    // until pollTextureLoads() uploads the art.
+    const Deck& info = decks_[deck];
+    std::vector<ImageLoadRequest> requests;
+    for (std::size_t face = info.firstCharacter; face < info.firstCharacter + static_cast<std::size_t>(info.characterCount); ++face)
+    {
+        if (residency_.state(face) != TextureResidency::State::Absent)
+        {
+            continue;
+        }
+        residency_.setLoading(face);
+        if (looseFaces_[face] != 0U || !loadPackedImage(static_cast<int>(face), characters_[face].slug))
+        {
+            requests.push_back(ImageLoadRequest{static_cast<int>(face), characters_[face].processed, atlas_.cardHeight});
+        }
+    }
+    if (!requests.empty())
+    {
+        textureLoaders_.push_back(std::make_unique<AsyncImageLoader>(std::move(requests)));
+    }
+}
+
+bool MemoryGame::loadPackedImage(int id, const std::string& name)
+{
+    const memory::AssetPackEntry* entry = assetPack_ ? assetPack_->find(name) : nullptr;
+    if (entry == nullptr || entry->kind != memory::AssetKind::Image)
+    {
+        return false;
+    }
+    atlas_.sourceHeight = std::max(atlas_.sourceHeight, entry->height);
+
+    // Pixels are already decoded RGBA8, so they go straight from the mapping
+    // to the atlas without touching the loose files. Packs from before the
+    // resolution tiers only hold full-size art, which is reduced here instead.
+    const unsigned int divisor = memory::chooseTextureDivisor(entry->height, atlas_.cardHeight);
+    const memory::AssetPackEntry* tier = assetPack_->find(memory::textureTierName(name, divisor));
+    if (tier != nullptr && tier->kind == memory::AssetKind::Image)
+    {
+        placeImage(id, tier->data.data(), sf::Vector2u(tier->width, tier->height), name);
+    }
+    else
+    {
+        const memory::RgbaImage reduced = memory::downsampleRgba(entry->data.data(), entry->width, entry->height, divisor);
+        placeImage(id, reduced.pixels.data(), sf::Vector2u(reduced.width, reduced.height), name);
+    }
+    return true;
+}
+
+void MemoryGame::placeImage(int id, const std::uint8_t* pixels, sf::Vector2u size, const std::string& name)
+{
+    if (id < 0)
+    {
+        // A reloaded back that still fits is rewritten where it is.
+        if (atlas_.backRegion && atlas_.backSlot.size.x >= static_cast<float>(size.x) && atlas_.backSlot.size.y >= static_cast<float>(size.y))
+        {
+            atlas_.texture.update(pixels, size, sf::Vector2u(atlas_.backSlot.position));
+            atlas_.backRegion = sf::FloatRect(atlas_.backSlot.position, sf::Vector2f(size));
+        }
+        else
+        {
+            if (atlas_.backRegion)
+            {
+                atlas_.freeRegions.push_back(atlas_.backSlot);
+            }
+            atlas_.backRegion = addToAtlas(pixels, size);
+            if (atlas_.backRegion)
+            {
+                atlas_.backSlot = *atlas_.backRegion;
+            }
+        }
+        if (!atlas_.backRegion)
+        {
+            std::cerr << "Warning: texture does not fit in atlas, using fallback card: " << name << "\n";
+        }
+        redrawAllCards_ = true;
+        gpuGeometryDirty_ = true;
+        atlas_.mipmapsStale = true;
+        return;
+    }
+
+    const std::size_t face = static_cast<std::size_t>(id);
+    const TextureResidency::State state = residency_.state(face);
+    if (state == TextureResidency::State::Absent)
+    {
+        // Evicted while a reload was decoding; it loads afresh when next needed.
+        return;
+    }
+    if (state == TextureResidency::State::Resident)
+    {
+        // A reload: only this face's region is uploaded again, in place when
+        // the new art fits, so nothing else in the atlas moves.
+        const sf::FloatRect current = atlas_.faceSlots[face];
+        if (current.size.x >= static_cast<float>(size.x) && current.size.y >= static_cast<float>(size.y))
+        {
+            atlas_.texture.update(pixels, size, sf::Vector2u(current.position));
+            atlas_.faceRegions[face] = sf::FloatRect(current.position, sf::Vector2f(size));
+            atlas_.mipmapsStale = true;
+            gpuGeometryDirty_ = true;
+            redrawCardsShowing(face);
+            return;
+        }
+        residency_.release(face);
+        atlas_.freeRegions.push_back(current);
+        atlas_.faceRegions[face].reset();
+    }
+
+    const std::optional<sf::FloatRect> region = reserveFaceRegion(size);
+    if (!region)
+    {
+        // Left absent, so the face is asked for again when the decks in use change.
+        residency_.setAbsent(face);
+        if (!atlas_.budgetWarned)
+        {
+            std::cerr << "Warning: texture budget of " << textureBudgetBytes_ / (1024U * 1024U)
+                      << " MB is full, some cards use their fallback colour\n";
+            atlas_.budgetWarned = true;
+        }
+        return;
+    }
+
+    atlas_.texture.update(pixels, size, sf::Vector2u(region->position));
+    atlas_.faceSlots[face] = *region;
+    atlas_.faceRegions[face] = sf::FloatRect(region->position, sf::Vector2f(size));
+    residency_.setResident(face);
+    atlas_.mipmapsStale = true;
+    gpuGeometryDirty_ = true;
+    redrawCardsShowing(face);
+}
+
+void MemoryGame::redrawCardsShowing(std::size_t face)
+{
+    for (std::size_t slot = 0; slot < frame_->characterIndex.size(); ++slot)
+    {
+        if (static_cast<std::size_t>(frame_->characterIndex[slot]) % characters_.size() == face)
+        {
+            textureRedraws_.push_back(static_cast<std::int32_t>(slot));
+        }
+    }
+}
+
+void MemoryGame::pollTextureLoads()
+{
+    if (textureLoaders_.empty())
+    {
+        return;
+    }
+
+    loadedImages_.clear();
+    for (const std::unique_ptr<AsyncImageLoader>& loader : textureLoaders_)
+    {
+        loader->poll(loadedImages_);
+    }
+
+    for (const ImageLoadResult& result : loadedImages_)
+    {
+        atlas_.sourceHeight = std::max(atlas_.sourceHeight, result.sourceHeight);
+        if (!result.image)
+        {
+            if (result.fileFound)
+            {
+                std::cerr << "Warning: failed to load texture: " << result.path.string() << "\n";
+            }
+            // A face that fails to reload keeps the art it already has.
+            if (result.id >= 0 && residency_.state(static_cast<std::size_t>(result.id)) != TextureResidency::State::Resident)
+            {
+                residency_.setFailed(static_cast<std::size_t>(result.id));
+            }
+            continue;
+        }
+        placeImage(result.id, result.image->getPixelsPtr(), result.image->getSize(), result.path.string());
+    }
+    refreshMipmaps();
+
+    std::erase_if(
+        textureLoaders_,
+        [](const std::unique_ptr<AsyncImageLoader>& loader) { return loader->finished(); });
+}
+
+void MemoryGame::refreshMipmaps()
+{
+    // Any upload leaves the higher mip levels stale.
+    if (atlas_.mipmapsStale && smoothTextures_)
+    {
+        (void)atlas_.texture.generateMipmap();
+    }
+    atlas_.mipmapsStale = false;
+}
+
+void MemoryGame::initTextureAtlas()
+{
+    atlas_ = TextureAtlas{};
+    atlas_.faceRegions.resize(characters_.size());
+    atlas_.faceSlots.resize(characters_.size());
+    residency_.reset(characters_.size());
+    pinnedDecks_.clear();
+    if (!atlas_.texture.resize(sf::Vector2u(kAtlasInitialSize, kAtlasInitialSize)))
+    {
+        std::cerr << "Warning: failed to create texture atlas. Using fallback cards.\n";
+        return;
+    }
+    atlas_.texture.setSmooth(smoothTextures_);
+
+    // A solid white tile, tinted for card backs, outlines and fallback faces.
+    const sf::Image solid(sf::Vector2u(kAtlasSolidTileSize, kAtlasSolidTileSize), sf::Color::White);
+    if (const std::optional<sf::FloatRect> region = addToAtlas(solid))
+    {
+        // Sample well inside the tile so neighbouring texels never bleed in.
+        atlas_.solidRegion = sf::FloatRect(
+            region->position + sf::Vector2f(1.0F, 1.0F),
+            region->size - sf::Vector2f(2.0F, 2.0F));
+    }
+}
+
+std::optional<sf::FloatRect> MemoryGame::addToAtlas(const sf::Image& image)
+{
+    return addToAtlas(image.getPixelsPtr(), image.getSize());
+}
+
+std::optional<sf::FloatRect> MemoryGame::addToAtlas(const std::uint8_t* pixels, sf::Vector2u size)
+{
+    const std::optional<sf::FloatRect> region = reserveAtlasRegion(size);
+    if (region)
+    {
+        atlas_.texture.update(pixels, size, sf::Vector2u(region->position));
+    }
+    return region;
+}
+
+std::optional<sf::FloatRect> MemoryGame::reserveAtlasRegion(sf::Vector2u size)
+{
+    const sf::Vector2u atlasSize = atlas_.texture.getSize();
+    if (atlasSize.x == 0U || size.x == 0U || size.y == 0U)
+    {
+        return std::nullopt;
+    }
+
+    if (atlas_.cursor.x + size.x > atlasSize.x && atlas_.cursor.x > 0U)
+    {
+        atlas_.cursor = sf::Vector2u(0U, atlas_.cursor.y + atlas_.shelfHeight);
+        atlas_.shelfHeight = 0U;
+    }
+
+    const sf::Vector2u required{atlas_.cursor.x + size.x, atlas_.cursor.y + size.y};
+    if ((required.x > atlasSize.x || required.y > atlasSize.y) && !growAtlas(required))
+    {
+        return std::nullopt;
+    }
+
+    const sf::Vector2u position = atlas_.cursor;
+    atlas_.cursor.x += size.x + kAtlasPadding;
+    atlas_.shelfHeight = std::max(atlas_.shelfHeight, size.y + kAtlasPadding);
+
+    return sf::FloatRect(sf::Vector2f(position), sf::Vector2f(size));
+}
+
+// Returns the whole region reserved, which a reused one can leave larger than `size`.
+std::optional<sf::FloatRect> MemoryGame::reserveFaceRegion(sf::Vector2u size)
+{
+    const sf::Vector2f wanted(size);
+    for (;;)
+    {
+        // Faces of one tier are usually all the same size, so a freed region
+        // almost always fits exactly.
+        for (std::size_t index = 0; index < atlas_.freeRegions.size(); ++index)
+        {
+            const sf::FloatRect region = atlas_.freeRegions[index];
+            if (region.size.x >= wanted.x && region.size.y >= wanted.y)
+            {
+                atlas_.freeRegions[index] = atlas_.freeRegions.back();
+                atlas_.freeRegions.pop_back();
+                return region;
+            }
+        }
+        if (const std::optional<sf::FloatRect> region = reserveAtlasRegion(size))
+        {
+            return region;
+        }
+
+        // Out of budget: give up the least recently used face nobody shows.
+        const std::optional<std::size_t> evicted = residency_.evict();
+        if (!evicted)
+        {
+            return std::nullopt;
+        }
+        atlas_.freeRegions.push_back(atlas_.faceSlots[*evicted]);
+        atlas_.faceRegions[*evicted].reset();
+    }
+}
+
+bool MemoryGame::growAtlas(sf::Vector2u minimumSize)
+{
+    const unsigned int maximum = sf::Texture::getMaximumSize();
+    sf::Vector2u grownSize = atlas_.texture.getSize();
+    while (grownSize.x < minimumSize.x)
+    {
+        grownSize.x *= 2U;
+    }
+    while (grownSize.y < minimumSize.y)
+    {
+        grownSize.y *= 2U;
+    }
+    // Mip levels add a third on top of the base level.
+    const std::size_t bytes = static_cast<std::size_t>(grownSize.x) * grownSize.y * 4U;
+    const std::size_t residentBytes = smoothTextures_ ? bytes + bytes / 3U : bytes;
+    if (grownSize.x > maximum || grownSize.y > maximum || residentBytes > textureBudgetBytes_)
+    {
+        return false;
+    }
+
+    sf::Texture grown;
+    if (!grown.resize(grownSize))
+    {
+        return false;
+    }
+    grown.update(atlas_.texture, sf::Vector2u(0U, 0U));
+    grown.setSmooth(smoothTextures_);
+    atlas_.texture = std::move(grown);
+    return true;
+}
+
+void MemoryGame::rebuildChromeMesh()
+{
+    const sf::FloatRect& solid = atlas_.solidRegion;
+    const std::size_t instanceCount = frame_->instances.size();
+    for (std::size_t instance = 0; instance < instanceCount; ++instance)
+    {
+        const Layout& layout = frame_->instances[instance].layout;
+        sf::Vertex* out = chromeVertices_.data() + instance * kChromeQuadCount * kVerticesPerQuad;
+
+        writeRect(out, layout.playArea, 0.0F, solid, sf::Color(18, 24, 40));
+        writeRect(out + kVerticesPerQuad, layout.hudArea, 0.0F, solid, sf::Color(26, 35, 58));
+        writeRect(out + kVerticesPerQuad * 2U, layout.gridArea, 0.0F, solid, sf::Color(20, 27, 46));
+        writeRect(out + kVerticesPerQuad * 3U, layout.newGameButton, layout.outlineThickness, solid, sf::Color(199, 216, 241));
+        writeRect(out + kVerticesPerQuad * 4U, layout.newGameButton, 0.0F, solid, sf::Color(78, 113, 170));
+
+        // Win overlays live after all the always-drawn chrome and are only drawn once a board is cleared.
+        writeRect(
+            chromeVertices_.data() + (kChromeQuadCount * instanceCount + instance) * kVerticesPerQuad,
+            layout.playArea,
+            0.0F,
+            solid,
+            sf::Color(0, 0, 0, 125));
+    }
+
+    if (useVertexBuffers_ && !chromeBuffer_.update(chromeVertices_.data()))
+    {
+        useVertexBuffers_ = false;
+    }
+}
+
+void MemoryGame::uploadDirtyCards()
+{
+    // Animating cards are rewritten every frame, not only after a tick,
+    // because the interpolated pose moves between ticks.
+    redrawCards_.clear();
+    if (redrawAllCards_)
+    {
+        for (std::size_t slot = 0; slot < frame_->characterIndex.size(); ++slot)
+        {
+            redrawCards_.push_back(static_cast<std::int32_t>(slot));
+        }
+    }
+    else
+    {
+        // A card can be on several of the lists (animating cards are usually
+        // dirty too); listing it once keeps redrawCards_ within its reserve.
+        const auto queue = [this](const std::vector<std::int32_t>& cards)
+        {
+            for (const std::int32_t index : cards)
+            {
+                std::uint8_t& queued = redrawQueued_[static_cast<std::size_t>(index)];
+                if (queued == 0U)
+                {
+                    queued = 1U;
+                    redrawCards_.push_back(index);
+                }
+            }
+        };
+        queue(frame_->dirty);
+        queue(textureRedraws_);
+        queue(frame_->animating);
+        for (const std::int32_t index : redrawCards_)
+        {
+            redrawQueued_[static_cast<std::size_t>(index)] = 0U;
+        }
+    }
+    redrawAllCards_ = false;
+    textureRedraws_.clear();
+    if (redrawCards_.empty())
+    {
+        return;
+    }
+    std::sort(redrawCards_.begin(), redrawCards_.end());
+
+    {
+        // Poses come from the batch kernel; only the vertex writes stay per card.
+        const ProfileScope scope(profiler_, ProfileZone::DrawCard);
+        std::array<Card, memory::kAnimationBatch> cards;
+        memory::CardPoseInput input;
+        memory::CardPoseBatch poses;
+        for (std::size_t base = 0; base < redrawCards_.size(); base += memory::kAnimationBatch)
+        {
+            const std::size_t count = std::min(memory::kAnimationBatch, redrawCards_.size() - base);
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                cards[lane] = presentedCard(static_cast<std::size_t>(redrawCards_[base + lane]));
+                input.state[lane] = cards[lane].state;
+                input.flipProgress[lane] = cards[lane].flipProgress;
+                input.removeProgress[lane] = cards[lane].removeProgress;
+            }
+            memory::computeCardPoses(input, count, poses);
+
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                const std::int32_t index = redrawCards_[base + lane];
+                const std::size_t slot = static_cast<std::size_t>(index);
+                drawCard(
+                    cards[lane],
+                    poses,
+                    lane,
+                    cardBounds(slot),
+                    index == frame_->hoveredCard,
+                    cardVertices_.data() + slot * kVerticesPerCard);
+                profiler_.countCardDrawn();
+            }
+        }
+    }
+
+    if (!useVertexBuffers_)
+    {
+        return;
+    }
+
+    // One upload per run of nearby dirty cards; clean cards inside a short gap
+    // are re-sent unchanged rather than splitting the run.
+    std::size_t runStart = 0;
+    for (std::size_t cursor = 1; cursor <= redrawCards_.size(); ++cursor)
+    {
+        if (cursor < redrawCards_.size() && redrawCards_[cursor] - redrawCards_[cursor - 1U] <= kMaxUploadGapCards)
+        {
+            continue;
+        }
+
+        const std::size_t offset = static_cast<std::size_t>(redrawCards_[runStart]) * kVerticesPerCard;
+        const std::size_t count = static_cast<std::size_t>(redrawCards_[cursor - 1U] - redrawCards_[runStart] + 1) * kVerticesPerCard;
+        if (!cardBuffer_.update(cardVertices_.data() + offset, count, static_cast<unsigned int>(offset)))
+        {
+            useVertexBuffers_ = false;
+            return;
+        }
+        runStart = cursor;
+    }
+}
+
+void MemoryGame::uploadGpuCards()
+{
+    const std::size_t cardCount = frame_->characterIndex.size();
+    if (gpuGeometryDirty_)
+    {
+        gpuCharacters_.assign(frame_->characterIndex.begin(), frame_->characterIndex.end());
+        for (std::size_t slot = 0; slot < cardCount; ++slot)
+        {
+            writeGpuGeometry(slot);
+        }
+        gpuCards_.uploadGeometry();
+    }
+
+    // Poses change only on simulation ticks; between ticks the shader blends
+    // from the previous pose, so frames without a tick touch no cards here.
+    redrawCards_.clear();
+    if (gpuGeometryDirty_)
+    {
+        for (std::size_t slot = 0; slot < cardCount; ++slot)
+        {
+            redrawCards_.push_back(static_cast<std::int32_t>(slot));
+        }
+    }
+    else
+    {
+        redrawCards_.assign(frame_->dirty.begin(), frame_->dirty.end());
+    }
+    gpuGeometryDirty_ = false;
+
+    bool geometryChanged = false;
+    for (const std::int32_t index : redrawCards_)
+    {
+        const std::size_t slot = static_cast<std::size_t>(index);
+        if (gpuCharacters_[slot] != frame_->characterIndex[slot])
+        {
+            // A new deal keeps the layout but moves the faces.
+            gpuCharacters_[slot] = frame_->characterIndex[slot];
+            writeGpuGeometry(slot);
+            geometryChanged = true;
+        }
+
+        const CardState state = frame_->state[slot];
+        const bool fading = state == CardState::Matched;
+        const float progress = fading ? frame_->removeProgress[slot] : frame_->flipProgress[slot];
+
+        const CardPose& previous = frame_->previousPoses[slot];
+        const bool blend = memory::isCardAnimating(presentedCard(slot)) && previous.tick + 1U == frame_->tick && previous.state == state;
+        const float previousProgress = fading ? previous.removeProgress : previous.flipProgress;
+        gpuCards_.setPose(slot, state, blend ? previousProgress : progress, progress);
+        profiler_.countCardDrawn();
+    }
+    if (geometryChanged)
+    {
+        gpuCards_.uploadGeometry();
+    }
+    gpuCards_.uploadPoses();
+}
+
+void MemoryGame::writeGpuGeometry(std::size_t slot)
+{
+    const sf::FloatRect backUv = atlas_.backRegion ? *atlas_.backRegion : atlas_.solidRegion;
+    const int character = gpuCharacters_[slot];
+    const sf::FloatRect* face = faceRegionForCharacter(character);
+    const sf::FloatRect bounds = cardBounds(slot);
+    gpuCards_.setGeometry(
+        slot,
+        sf::Vector2f(bounds.position.x + bounds.size.x * 0.5F, bounds.position.y + bounds.size.y * 0.5F),
+        atlas_.solidRegion,
+        backUv,
+        face != nullptr ? *face : atlas_.solidRegion,
+        face != nullptr ? sf::Color::White : characterFor(character).fallbackColor);
+}
+
+void MemoryGame::drawMesh(const sf::VertexBuffer& buffer, const std::vector<sf::Vertex>& vertices, std::size_t first, std::size_t count)
+{
+    const sf::RenderStates states(&atlas_.texture);
+    profiler_.countDraw(&atlas_.texture);
+    if (useVertexBuffers_)
+    {
+        window_.draw(buffer, first, count, states);
+        return;
+    }
+    window_.draw(vertices.data() + first, count, sf::PrimitiveType::Triangles, states);
+}
+
+void MemoryGame::drawProfilerOverlay()
+{
+    // Re-summarising is a sort over the window, so only refresh a few times per second.
+    if (profilerOverlayLength_ == 0U || profilerOverlayClock_.getElapsedTime().asSeconds() >= kProfilerOverlayRefreshSeconds)
+    {
+        profilerOverlayClock_.restart();
+        const FrameStats stats = profiler_.summarize(kProfilerOverlayWindow, &frameArena_);
+
+        int length = std::snprintf(
+            profilerOverlayBuffer_.data(),
+            profilerOverlayBuffer_.size(),
+            "frame p50 %.2f  p99 %.2f  max %.2f ms (%zu)\ndraws %.1f  binds %.1f\ninput to display p50 %.2f  max %.2f ms (%zu)\n",
+            static_cast<double>(stats.p50Ms),
+            static_cast<double>(stats.p99Ms),
+            static_cast<double>(stats.maxMs),
+            stats.sampleCount,
+            static_cast<double>(stats.meanDrawCalls),
+            static_cast<double>(stats.meanTextureBinds),
+            static_cast<double>(stats.inputLatencyP50Ms),
+            static_cast<double>(stats.inputLatencyMaxMs),
+            stats.inputSampleCount);
+
+        for (std::size_t zone = 0; zone < kProfileZoneCount && length > 0; ++zone)
+        {
+            const std::size_t used = std::min(static_cast<std::size_t>(length), profilerOverlayBuffer_.size());
+            length += std::snprintf(
+                profilerOverlayBuffer_.data() + used,
+                profilerOverlayBuffer_.size() - used,
+                "%s %.3f ms\n",
+                FrameProfiler::zoneName(static_cast<ProfileZone>(zone)),
+                static_cast<double>(stats.zoneMeanMs[zone]));
+        }
+
+        profilerOverlayLength_ = std::min(static_cast<std::size_t>(std::max(length, 0)), profilerOverlayBuffer_.size() - 1U);
+    }
+
+    const Layout& layout = frame_->instances.front().layout;
+    drawText(
+        profilerText_,
+        std::string_view(profilerOverlayBuffer_.data(), profilerOverlayLength_),
+        sf::Vector2f(
+            layout.gridArea.position.x,
+            layout.hudArea.position.y + layout.hudArea.size.y + 4.0F * layout.scale),
+        std::max(10U, layout.cardLabelSize / 2U),
+        sf::Color(120, 255, 140),
+        false);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    LaunchOptions options;
+    std::optional<float> opponentDecay;
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string_view argument = argv[index];
+        const bool hasValue = index + 1 < argc;
+
+        if (argument == "--record" && hasValue)
+        {
+            options.recordPath = fs::path(argv[++index]);
+        }
+        else if (argument == "--replay" && hasValue)
+        {
+            options.replayPath = fs::path(argv[++index]);
+        }
+        else if (argument == "--profile-csv" && hasValue)
+        {
+            options.profileCsvPath = fs::path(argv[++index]);
+        }
+        else if (argument == "--board" && hasValue)
+        {
+            const std::string_view value = argv[++index];
+            if (!memory::parseBoardSize(value, options.boardColumns, options.boardRows))
+            {
+                std::cerr << "Expected --board COLUMNSxROWS, got: " << value << "\n";
+                return 1;
+            }
+        }
+        else if (argument == "--kiosk" && hasValue)
+        {
+            const std::string_view value = argv[++index];
+            if (!memory::parseBoardSize(value, options.kioskColumns, options.kioskRows) ||
+                options.kioskColumns * options.kioskRows > kMaxKioskBoards)
+            {
+                std::cerr << "Expected --kiosk COLUMNSxROWS with at most " << kMaxKioskBoards << " boards, got: " << value << "\n";
+                return 1;
+            }
+        }
+        else if (argument == "--decks" && hasValue)
+        {
+            options.decksPath = fs::path(argv[++index]);
+        }
+        else if (argument == "--texture-budget" && hasValue)
+        {
+            const std::string_view value = argv[++index];
+            const auto result = std::from_chars(value.data(), value.data() + value.size(), options.textureBudgetMegabytes);
+            if (result.ec != std::errc() || result.ptr != value.data() + value.size() || options.textureBudgetMegabytes < kMinTextureBudgetMegabytes)
+            {
+                std::cerr << "Expected --texture-budget MEGABYTES of at least " << kMinTextureBudgetMegabytes << ", got: " << value << "\n";
+                return 1;
+            }
+        }
+        else if (argument == "--telemetry" && hasValue)
+        {
+            options.telemetry.file = fs::path(argv[++index]);
+        }
+        else if (argument == "--telemetry-udp" && hasValue)
+        {
+            const std::string_view value = argv[++index];
+            const std::size_t separator = value.rfind(':');
+            const std::string_view port = separator == std::string_view::npos ? std::string_view() : value.substr(separator + 1U);
+            const auto result = std::from_chars(port.data(), port.data() + port.size(), options.telemetry.udpPort);
+            if (separator == 0U || port.empty() || result.ec != std::errc() || result.ptr != port.data() + port.size() || options.telemetry.udpPort == 0U)
+            {
+                std::cerr << "Expected --telemetry-udp HOST:PORT, got: " << value << "\n";
+                return 1;
+            }
+            options.telemetry.udpHost = std::string(value.substr(0, separator));
+        }
+        else if (argument == "--telemetry-rotate" && hasValue)
+        {
+            const std::string_view value = argv[++index];
+            std::size_t megabytes = 0;
+            const auto result = std::from_chars(value.data(), value.data() + value.size(), megabytes);
+            if (result.ec != std::errc() || result.ptr != value.data() + value.size() || megabytes < kMinTelemetryRotateMegabytes)
+            {
+                std::cerr << "Expected --telemetry-rotate MEGABYTES of at least " << kMinTelemetryRotateMegabytes << ", got: " << value << "\n";
+                return 1;
+            }
+            options.telemetry.rotateBytes = megabytes * 1024U * 1024U;
+        }
+        else if (argument == "--opponent" && hasValue)
+        {
+            const std::string_view value = argv[++index];
+            memory::BeliefSettings settings;
+            if (!memory::parseOpponentLevel(value, settings))
+            {
+                std::cerr << "Expected --opponent easy, normal or hard, got: " << value << "\n";
+                return 1;
+            }
+            options.opponent = settings;
+        }
+        else if (argument == "--opponent-decay" && hasValue)
+        {
+            float decay = 0.0F;
+            try
+            {
+                decay = std::stof(argv[++index]);
+            }
+            catch (const std::exception&)
+            {
+                std::cerr << "Invalid --opponent-decay value: " << argv[index] << "\n";
+                return 1;
+            }
+            if (!(decay >= 0.0F && decay <= 1.0F))
+            {
+                std::cerr << "Expected --opponent-decay between 0 and 1, got: " << argv[index] << "\n";
+                return 1;
+            }
+            opponentDecay = decay;
+        }
+        else if (argument == "--hot-reload")
+        {
+            options.hotReload = true;
+        }
+        else if (argument == "--gpu-flip")
+        {
+            options.gpuAnimation = true;
+        }
+        else if (argument == "--smooth-textures")
+        {
+            options.smoothTextures = true;
+        }
+        else if (argument == "--replay-speed" && hasValue)
+        {
+            try
+            {
+                options.replaySpeed = std::stof(argv[++index]);
+            }
+            catch (const std::exception&)
+            {
+                std::cerr << "Invalid --replay-speed value: " << argv[index] << "\n";
+                return 1;
+            }
+        }
+        else
+        {
+            std::cerr << "Usage: memory_game [--board <columns>x<rows>] [--record <log>] [--replay <log> [--replay-speed <x>]] [--profile-csv <file>] [--gpu-flip] [--smooth-textures] [--kiosk <columns>x<rows>] [--decks <dir>] [--texture-budget <MB>] [--telemetry <file> [--telemetry-rotate <MB>]] [--telemetry-udp <host>:<port>] [--hot-reload] [--opponent easy|normal|hard [--opponent-decay <rate>]]\n";
+            return 1;
+        }
+    }
+
+    if (options.recordPath && options.replayPath)
+    {
+        std::cerr << "--record and --replay cannot be combined.\n";
+        return 1;
+    }
+    if ((options.recordPath || options.replayPath) && options.kioskColumns * options.kioskRows > 1)
+    {
+        // Input logs hold one board's clicks.
+        std::cerr << "--kiosk cannot be combined with --record or --replay.\n";
+        return 1;
+    }
+    if ((options.recordPath || options.replayPath) && options.decksPath)
+    {
+        // The log header records one deal, not the deck rotation.
+        std::cerr << "--decks cannot be combined with --record or --replay.\n";
+        return 1;
+    }
+
+    if (opponentDecay)
+    {
+        if (!options.opponent)
+        {
+            std::cerr << "--opponent-decay needs --opponent.\n";
+            return 1;
+        }
+        options.opponent->decayPerPick = *opponentDecay;
+    }
+    if (options.opponent && (options.recordPath || options.replayPath))
+    {
+        // Input logs hold clicks; the computer's picks depend on its own thinking.
+        std::cerr << "--opponent cannot be combined with --record or --replay.\n";
+        return 1;
+    }
+    if (options.opponent && options.kioskColumns * options.kioskRows > 1)
+    {
+        std::cerr << "--opponent cannot be combined with --kiosk.\n";
+        return 1;
+    }
+
+    MemoryGame game(options);
     game.run();
     return 0;
 }
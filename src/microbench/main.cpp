@@ -0,0 +1,648 @@
+#include "allocation_counter.hpp"
+#include "board_layout.hpp"
+#include "card_mesh.hpp"
+#include "core/animation_kernels.hpp"
+#include "core/memory_rules.hpp"
+#include "frame_arena.hpp"
+#include "frame_profiler.hpp"
+#include "hit_test.hpp"
+#include "hud_text.hpp"
+
+#include <SFML/Graphics.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr float kSimulationStepSeconds = 1.0F / 120.0F;
+constexpr std::uint64_t kMaxIterations = 1U << 30U;
+constexpr std::size_t kHitPointCount = 4096; // power of two, indexed with a mask
+constexpr std::size_t kProfilerWindow = 600U;
+constexpr std::size_t kFrameArenaBytes = 64U * 1024U;
+const sf::Vector2f kWindowSizes[] = {{1920.0F, 1080.0F}, {1280.0F, 720.0F}};
+
+// Written with every result so the optimiser cannot drop the measured work.
+volatile std::uint64_t sink = 0;
+
+struct Options
+{
+    std::vector<memory::BoardConfig> boards;
+    double minSeconds = 0.25; // per benchmark
+    std::string filter;
+    std::optional<fs::path> csvPath;
+    std::optional<fs::path> baselinePath;
+    double tolerance = 0.15; // allowed ns/op growth over the baseline
+    bool offscreen = true;
+};
+
+struct Result
+{
+    std::string name;
+    std::string board;
+    double nsPerOp = 0.0;
+    double allocationsPerOp = 0.0;
+    std::uint64_t iterations = 0;
+};
+
+void printUsage()
+{
+    std::cout <<
+        "Microbenchmarks for the game's per-frame hot paths.\n"
+        "\n"
+        "Usage:\n"
+        "  memory_game_benchmarks [--boards COLUMNSxROWS,...] [--min-time SECONDS]\n"
+        "                         [--filter TEXT] [--csv FILE] [--no-offscreen]\n"
+        "                         [--baseline FILE [--tolerance FRACTION]]\n"
+        "\n"
+        "Reports ns/op and heap allocations/op for every benchmark whose name\n"
+        "contains TEXT. With --baseline (a CSV written by --csv), exits with 1\n"
+        "when a benchmark got slower by more than FRACTION or allocates more.\n";
+}
+
+std::vector<std::string> splitList(std::string_view value, char separator)
+{
+    std::vector<std::string> items;
+    std::istringstream stream{std::string(value)};
+    std::string token;
+    while (std::getline(stream, token, separator))
+    {
+        if (!token.empty())
+        {
+            items.push_back(token);
+        }
+    }
+    return items;
+}
+
+bool parseBoards(std::string_view value, std::vector<memory::BoardConfig>& boards)
+{
+    boards.clear();
+    for (const std::string& item : splitList(value, ','))
+    {
+        const std::size_t separator = item.find('x');
+        if (separator == std::string::npos)
+        {
+            return false;
+        }
+        memory::BoardConfig config;
+        config.columns = std::stoi(item.substr(0, separator));
+        config.rows = std::stoi(item.substr(separator + 1U));
+        config.characterCount = std::max(1, config.pairCount());
+        if (!memory::isValidConfig(config))
+        {
+            return false;
+        }
+        boards.push_back(config);
+    }
+    return !boards.empty();
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string_view argument = argv[index];
+        const bool hasValue = index + 1 < argc;
+
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage();
+            return false;
+        }
+        if (argument == "--boards" && hasValue)
+        {
+            if (!parseBoards(argv[++index], options.boards))
+            {
+                std::cerr << "Expected --boards COLUMNSxROWS[,...] with even card counts, got: " << argv[index] << "\n";
+                return false;
+            }
+        }
+        else if (argument == "--min-time" && hasValue)
+        {
+            options.minSeconds = std::stod(argv[++index]);
+        }
+        else if (argument == "--filter" && hasValue)
+        {
+            options.filter = argv[++index];
+        }
+        else if (argument == "--csv" && hasValue)
+        {
+            options.csvPath = fs::path(argv[++index]);
+        }
+        else if (argument == "--baseline" && hasValue)
+        {
+            options.baselinePath = fs::path(argv[++index]);
+        }
+        else if (argument == "--tolerance" && hasValue)
+        {
+            options.tolerance = std::stod(argv[++index]);
+        }
+        else if (argument == "--no-offscreen")
+        {
+            options.offscreen = false;
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option: " << argument << "\n";
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string boardName(const memory::BoardConfig& config)
+{
+    return std::to_string(config.columns) + "x" + std::to_string(config.rows);
+}
+
+// Runs `operation` in growing batches until one batch takes at least
+// `minSeconds`, and reports that batch. One untimed call first sizes any
+// buffers the operation reuses, so steady-state allocations read as zero.
+template <typename Operation>
+Result measure(std::string name, std::string board, double minSeconds, Operation&& operation)
+{
+    operation();
+
+    std::uint64_t iterations = 1;
+    for (;;)
+    {
+        const std::uint64_t allocationsBefore = threadAllocationCount();
+        const Clock::time_point start = Clock::now();
+        for (std::uint64_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            operation();
+        }
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        const std::uint64_t allocations = threadAllocationCount() - allocationsBefore;
+
+        if (elapsed.count() >= minSeconds || iterations >= kMaxIterations)
+        {
+            const double count = static_cast<double>(iterations);
+            return Result{std::move(name), std::move(board), elapsed.count() * 1.0e9 / count, static_cast<double>(allocations) / count, iterations};
+        }
+
+        // Aim a little past the target so the next batch is usually the last.
+        const double growth = elapsed.count() > 0.0 ? minSeconds * 1.2 / elapsed.count() : 10.0;
+        iterations = std::min(kMaxIterations, static_cast<std::uint64_t>(static_cast<double>(iterations) * std::clamp(growth, 2.0, 10.0)));
+    }
+}
+
+class Runner
+{
+public:
+    explicit Runner(const Options& options) : options_(options) {}
+
+    // Skips the setup of filtered-out benchmarks as well as their timing.
+    bool wanted(std::string_view name) const
+    {
+        return options_.filter.empty() || name.find(options_.filter) != std::string_view::npos;
+    }
+
+    template <typename Operation>
+    void run(std::string name, std::string board, Operation&& operation)
+    {
+        if (!wanted(name))
+        {
+            return;
+        }
+        results_.push_back(measure(std::move(name), std::move(board), options_.minSeconds, operation));
+        const Result& result = results_.back();
+        std::cout << std::left << std::setw(28) << result.name << std::setw(10) << result.board << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(14) << result.nsPerOp << " ns/op"
+                  << std::setprecision(2) << std::setw(10) << result.allocationsPerOp << " allocs/op\n";
+    }
+
+    const std::vector<Result>& results() const { return results_; }
+
+private:
+    const Options& options_;
+    std::vector<Result> results_;
+};
+
+// Starts a flip on the first `count` resting cards, the same way applyPick()
+// does, so step() has exactly that many cards on its animating list.
+void startFlips(memory::BoardState& board, std::size_t count)
+{
+    for (std::size_t slot = 0; slot < count; ++slot)
+    {
+        memory::CardState& state = board.state[slot];
+        if (state != memory::CardState::FaceDown && state != memory::CardState::FaceUp)
+        {
+            continue;
+        }
+        state = state == memory::CardState::FaceDown ? memory::CardState::FlippingToFront : memory::CardState::FlippingToBack;
+        board.flipProgress[slot] = 0.0F;
+        board.flags[slot] = static_cast<std::uint8_t>((board.flags[slot] & ~memory::kCardFaceSwapped) | memory::kCardAnimating);
+        board.animating.push_back(static_cast<std::int32_t>(slot));
+    }
+}
+
+void benchmarkSimulation(Runner& runner, const memory::BoardConfig& config, std::mt19937& random)
+{
+    const std::string board = boardName(config);
+
+    memory::BoardState state;
+    state.config = config;
+    std::vector<std::int32_t> dirty;
+    dirty.reserve(static_cast<std::size_t>(config.cardCount()));
+
+    // A tick as MemoryGame::update() runs it: step, then hand the dirty
+    // cards over. Flips restart as soon as they all finish.
+    const auto tickWith = [&](std::size_t animating)
+    {
+        memory::resetBoard(state, random);
+        const auto tick = [&state, &dirty, animating]
+        {
+            if (state.animating.empty())
+            {
+                startFlips(state, animating);
+            }
+            memory::step(state, kSimulationStepSeconds);
+            memory::takeDirtyCards(state, dirty);
+            sink = sink + dirty.size();
+        };
+        return tick;
+    };
+
+    const std::size_t cardCount = static_cast<std::size_t>(config.cardCount());
+    if (runner.wanted("step/2_animating"))
+    {
+        runner.run("step/2_animating", board, tickWith(std::min<std::size_t>(2U, cardCount)));
+    }
+    if (runner.wanted("step/all_animating"))
+    {
+        runner.run("step/all_animating", board, tickWith(cardCount));
+    }
+
+    runner.run("reset_board", board, [&]
+    {
+        memory::resetBoard(state, random);
+        sink = sink + static_cast<std::uint64_t>(state.characterIndex.front());
+    });
+}
+
+void benchmarkInput(Runner& runner, const memory::BoardConfig& config, std::mt19937& random)
+{
+    const std::string board = boardName(config);
+    const Layout layout = computeLayout(kWindowSizes[0], config.columns, config.rows);
+
+    std::uniform_real_distribution<float> x(layout.playArea.position.x, layout.playArea.position.x + layout.playArea.size.x);
+    std::uniform_real_distribution<float> y(layout.playArea.position.y, layout.playArea.position.y + layout.playArea.size.y);
+    std::vector<sf::Vector2f> points(kHitPointCount);
+    for (sf::Vector2f& point : points)
+    {
+        point = sf::Vector2f(x(random), y(random));
+    }
+
+    std::size_t next = 0;
+    HitTestGrid grid;
+    const auto pickNext = [&]
+    {
+        sink = sink + static_cast<std::uint64_t>(grid.pick(points[next++ & (kHitPointCount - 1U)]) + 1);
+    };
+
+    if (runner.wanted("hit_test/regular"))
+    {
+        grid.setRegularGrid(layout.gridOrigin, layout.cardSize, layout.cardPitch, config.columns, config.rows);
+        runner.run("hit_test/regular", board, pickNext);
+    }
+    if (runner.wanted("hit_test/bucketed"))
+    {
+        std::vector<sf::FloatRect> bounds(static_cast<std::size_t>(config.cardCount()));
+        for (std::size_t slot = 0; slot < bounds.size(); ++slot)
+        {
+            bounds[slot] = layout.cardBounds(slot);
+        }
+        grid.setRects(bounds);
+        runner.run("hit_test/bucketed", board, pickNext);
+    }
+
+    // What a resize costs MemoryGame::recomputeLayout(); alternating sizes
+    // keeps every call doing the full computation.
+    std::size_t resize = 0;
+    runner.run("layout", board, [&]
+    {
+        const Layout next = computeLayout(kWindowSizes[resize++ & 1U], config.columns, config.rows);
+        grid.setRegularGrid(next.gridOrigin, next.cardSize, next.cardPitch, config.columns, config.rows);
+        sink = sink + static_cast<std::uint64_t>(next.cardSize.x);
+    });
+}
+
+void benchmarkRendering(Runner& runner, const memory::BoardConfig& config, std::mt19937& random, sf::RenderTexture* target)
+{
+    const std::string board = boardName(config);
+    const Layout layout = computeLayout(kWindowSizes[0], config.columns, config.rows);
+
+    // A board mid-game: some cards flipping either way, some fading out.
+    memory::BoardState state;
+    state.config = config;
+    memory::resetBoard(state, random);
+    const std::size_t cardCount = static_cast<std::size_t>(config.cardCount());
+    const std::array<memory::CardState, 4> mix{
+        memory::CardState::FaceDown,
+        memory::CardState::FlippingToFront,
+        memory::CardState::FlippingToBack,
+        memory::CardState::Matched,
+    };
+    for (std::size_t slot = 0; slot < cardCount; ++slot)
+    {
+        state.state[slot] = mix[slot % mix.size()];
+        state.flipProgress[slot] = static_cast<float>(slot % 7U) / 7.0F;
+        state.removeProgress[slot] = static_cast<float>(slot % 5U) / 5.0F;
+    }
+
+    const sf::FloatRect solid{{0.0F, 0.0F}, {1.0F, 1.0F}};
+    const sf::FloatRect face{{4.0F, 0.0F}, {96.0F, 128.0F}};
+    std::vector<sf::Vertex> vertices(cardCount * kVerticesPerCard);
+
+    // The redraw-all path of MemoryGame::uploadDirtyCards(): poses in
+    // batches, then both quads of every card. One op is the whole board.
+    const auto writeBoard = [&]
+    {
+        memory::CardPoseInput input;
+        memory::CardPoseBatch poses;
+        for (std::size_t base = 0; base < cardCount; base += memory::kAnimationBatch)
+        {
+            const std::size_t count = std::min(memory::kAnimationBatch, cardCount - base);
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                input.state[lane] = state.state[base + lane];
+                input.flipProgress[lane] = state.flipProgress[base + lane];
+                input.removeProgress[lane] = state.removeProgress[base + lane];
+            }
+            memory::computeCardPoses(input, count, poses);
+
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                const std::size_t slot = base + lane;
+                CardArt art;
+                art.solidRegion = solid;
+                art.faceRegion = (slot % 2U) == 0U ? &face : nullptr;
+                art.faceFallback = sf::Color(122, 194, 122);
+                writeCardVertices(
+                    memory::cardAt(state, static_cast<int>(slot)),
+                    poses,
+                    lane,
+                    layout.cardBounds(slot),
+                    layout.outlineThickness,
+                    slot == 0U,
+                    art,
+                    vertices.data() + slot * kVerticesPerCard);
+            }
+        }
+        sink = sink + static_cast<std::uint64_t>(vertices.back().color.a);
+    };
+    runner.run("card_vertices", board, writeBoard);
+
+    if (target != nullptr)
+    {
+        target->setView(sf::View(sf::FloatRect({0.0F, 0.0F}, kWindowSizes[0])));
+        runner.run("card_vertices+draw", board, [&]
+        {
+            writeBoard();
+            target->clear();
+            target->draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles);
+            target->display();
+        });
+    }
+}
+
+void benchmarkHud(Runner& runner)
+{
+    float seconds = 0.0F;
+    runner.run("format_elapsed_time", "-", [&]
+    {
+        seconds += 37.3F;
+        if (seconds > 20000.0F)
+        {
+            seconds = 0.0F;
+        }
+        sink = sink + formatElapsedTime(seconds).length;
+    });
+
+    // The profiler overlay's refresh, with its sort buffers in a frame arena.
+    if (runner.wanted("profiler_summarize"))
+    {
+        FrameProfiler profiler;
+        for (std::size_t frame = 0; frame < kProfilerWindow; ++frame)
+        {
+            profiler.beginFrame();
+            profiler.countDraw(&profiler);
+            profiler.endFrame();
+        }
+        FrameArena arena(kFrameArenaBytes);
+        runner.run("profiler_summarize", "-", [&]
+        {
+            arena.reset();
+            sink = sink + profiler.summarize(kProfilerWindow, &arena).sampleCount;
+        });
+    }
+
+    const std::array<std::string, 4> names{"Luke Skywalker", "Obi-Wan Kenobi", "R2-D2", "Emperor Palpatine"};
+    std::size_t next = 0;
+    runner.run("make_initials", "-", [&]
+    {
+        sink = sink + makeInitials(names[next++ % names.size()]).size();
+    });
+}
+
+std::optional<std::map<std::pair<std::string, std::string>, Result>> readBaseline(const fs::path& path)
+{
+    std::ifstream stream(path);
+    if (!stream)
+    {
+        return std::nullopt;
+    }
+
+    std::map<std::pair<std::string, std::string>, Result> baseline;
+    std::string line;
+    std::getline(stream, line); // header
+    while (std::getline(stream, line))
+    {
+        const std::vector<std::string> fields = splitList(line, ',');
+        if (fields.size() < 4U)
+        {
+            continue;
+        }
+        Result result{fields[0], fields[1], std::stod(fields[2]), std::stod(fields[3]), 0};
+        baseline[{result.name, result.board}] = result;
+    }
+    return baseline;
+}
+
+// The vector animation kernels against the scalar reference, bit for bit, over
+// every card state, the clamp edges and random progress in and out of [0, 1].
+bool checkAnimationKernels(std::mt19937& random)
+{
+    const std::array<float, 12> edges{-0.25F, -0.0F, 0.0F, 1e-7F, 0.1F, 0.4999999F, 0.5F, 0.5000001F, 0.9999999F, 1.0F, 1.0000001F, 1.25F};
+    std::uniform_real_distribution<float> spread(-0.5F, 1.5F);
+    constexpr std::size_t kStateCount = 6;
+    // The first samples pair every edge with every state in every lane.
+    const auto progressAt = [&](std::size_t sample, std::size_t lane)
+    {
+        return sample < edges.size() * kStateCount ? edges[(sample / kStateCount + lane) % edges.size()] : spread(random);
+    };
+
+    for (std::size_t sample = 0; sample < 4096U; ++sample)
+    {
+        const std::size_t count = sample % memory::kAnimationBatch + 1U;
+
+        memory::CardPoseInput input;
+        std::array<float, memory::kAnimationBatch> rate{};
+        for (std::size_t lane = 0; lane < memory::kAnimationBatch; ++lane)
+        {
+            input.state[lane] = static_cast<memory::CardState>((sample + lane) % kStateCount);
+            input.flipProgress[lane] = progressAt(sample, lane);
+            input.removeProgress[lane] = progressAt(sample, lane);
+            rate[lane] = spread(random) * 0.1F;
+        }
+
+        memory::CardPoseBatch vector;
+        memory::CardPoseBatch reference;
+        memory::computeCardPoses(input, count, vector);
+        memory::computeCardPosesReference(input, count, reference);
+
+        std::array<float, memory::kAnimationBatch> vectorProgress = input.flipProgress;
+        std::array<float, memory::kAnimationBatch> referenceProgress = input.flipProgress;
+        const memory::ProgressEvents vectorEvents = memory::advanceProgress(vectorProgress, rate, count);
+        const memory::ProgressEvents referenceEvents = memory::advanceProgressReference(referenceProgress, rate, count);
+
+        const std::size_t floatBytes = count * sizeof(float);
+        if (std::memcmp(vector.scaleX.data(), reference.scaleX.data(), floatBytes) != 0 ||
+            std::memcmp(vector.scaleY.data(), reference.scaleY.data(), floatBytes) != 0 ||
+            std::memcmp(vector.alpha.data(), reference.alpha.data(), count) != 0 ||
+            vector.showFront != reference.showFront ||
+            std::memcmp(vectorProgress.data(), referenceProgress.data(), floatBytes) != 0 ||
+            vectorEvents.reachedHalf != referenceEvents.reachedHalf ||
+            vectorEvents.finished != referenceEvents.finished)
+        {
+            std::cerr << "Animation kernel '" << memory::animationKernelName() << "' differs from the scalar reference (sample "
+                      << sample << ")\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writeCsv(const fs::path& path, const std::vector<Result>& results)
+{
+    std::ofstream stream(path, std::ios::trunc);
+    if (!stream)
+    {
+        return false;
+    }
+
+    stream << std::setprecision(8) << "benchmark,board,ns_per_op,allocations_per_op,iterations\n";
+    for (const Result& result : results)
+    {
+        stream << result.name << ',' << result.board << ',' << result.nsPerOp << ',' << result.allocationsPerOp << ',' << result.iterations << '\n';
+    }
+    return static_cast<bool>(stream);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        if (!parseOptions(argc, argv, options))
+        {
+            return 1;
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "Invalid option value: " << error.what() << "\n";
+        return 1;
+    }
+    if (options.boards.empty())
+    {
+        parseBoards("8x4,32x32,128x128", options.boards);
+    }
+
+    Runner runner(options);
+
+    // Needs a GL context; headless machines still run everything else.
+    std::optional<sf::RenderTexture> target;
+    if (options.offscreen && runner.wanted("card_vertices+draw"))
+    {
+        target.emplace();
+        if (!target->resize(sf::Vector2u(static_cast<unsigned int>(kWindowSizes[0].x), static_cast<unsigned int>(kWindowSizes[0].y))))
+        {
+            std::cerr << "Warning: no offscreen render target, skipping the draw benchmarks\n";
+            target.reset();
+        }
+    }
+
+    std::cout << "animation kernels: " << memory::animationKernelName() << "\n";
+    std::mt19937 random(1U);
+    if (!checkAnimationKernels(random))
+    {
+        return 1;
+    }
+    benchmarkHud(runner);
+    for (const memory::BoardConfig& config : options.boards)
+    {
+        benchmarkSimulation(runner, config, random);
+        benchmarkInput(runner, config, random);
+        benchmarkRendering(runner, config, random, target ? &*target : nullptr);
+    }
+
+    if (options.csvPath && !writeCsv(*options.csvPath, runner.results()))
+    {
+        std::cerr << "Warning: failed to write " << options.csvPath->string() << "\n";
+    }
+
+    if (!options.baselinePath)
+    {
+        return 0;
+    }
+    const auto baseline = readBaseline(*options.baselinePath);
+    if (!baseline)
+    {
+        std::cerr << "Cannot read baseline " << options.baselinePath->string() << "\n";
+        return 1;
+    }
+
+    int regressions = 0;
+    for (const Result& result : runner.results())
+    {
+        const auto found = baseline->find({result.name, result.board});
+        if (found == baseline->end())
+        {
+            continue;
+        }
+        const Result& before = found->second;
+        // Allocation counts are deterministic, so any growth is a regression.
+        if (result.nsPerOp > before.nsPerOp * (1.0 + options.tolerance) || result.allocationsPerOp > before.allocationsPerOp + 0.01)
+        {
+            std::cout << "REGRESSION " << result.name << " " << result.board << ": " << std::setprecision(1)
+                      << result.nsPerOp << " ns/op (baseline " << before.nsPerOp << "), " << std::setprecision(2)
+                      << result.allocationsPerOp << " allocs/op (baseline " << before.allocationsPerOp << ")\n";
+            ++regressions;
+        }
+    }
+    return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,426 @@
+#include "core/net_protocol.hpp"
+#include "core/remote_board.hpp"
+#include "core/seeded_random.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr int kMaxEvents = 256;
+constexpr std::size_t kReadChunkBytes = 16U * 1024U;
+constexpr float kFrameSeconds = 1.0F / 60.0F;
+
+struct Options
+{
+    std::string host = "127.0.0.1";
+    std::uint16_t port = memory::kDefaultServerPort;
+    std::size_t connections = 200;
+    float seconds = 10.0F;
+    float thinkSeconds = 0.1F; // pause before each pick
+    std::uint32_t seed = 1;
+};
+
+// One simulated player: picks a random legal card once it is its turn.
+struct Bot
+{
+    int fd = -1;
+    std::string input;
+    std::string output;
+    bool inMatch = false;
+    memory::RemoteBoard board;
+    float thinkRemaining = 0.0F;
+    std::vector<std::pair<std::uint32_t, Clock::time_point>> unacked;
+};
+
+struct Totals
+{
+    // Per bot: a match between two of these bots counts once for each seat.
+    // (Match ids repeat across server event loops, so they are not counted.)
+    std::uint64_t seatsStarted = 0;
+    std::uint64_t seatsFinished = 0;
+    std::uint64_t picks = 0;
+    std::uint64_t deltas = 0;
+    std::uint64_t bytesReceived = 0;
+    std::uint64_t disconnects = 0;
+    std::vector<float> ackMilliseconds;
+};
+
+void printUsage()
+{
+    std::cout <<
+        "Load generator for memory_server: every connection plays matches as a bot.\n"
+        "\n"
+        "Usage:\n"
+        "  memory_net_bot [--host H] [--port P] [--connections N] [--seconds S] [--think SECONDS] [--seed S]\n"
+        "\n"
+        "Connections are paired by the server, so N should be even. Reports the\n"
+        "match seats the bots played (a match between two of them is two seats)\n"
+        "and the time from sending a pick to the delta acknowledging it.\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string_view argument = argv[index];
+        const bool hasValue = index + 1 < argc;
+
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage();
+            return false;
+        }
+        if (argument == "--host" && hasValue)
+        {
+            options.host = argv[++index];
+        }
+        else if (argument == "--port" && hasValue)
+        {
+            options.port = static_cast<std::uint16_t>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--connections" && hasValue)
+        {
+            options.connections = std::stoul(argv[++index]);
+        }
+        else if (argument == "--seconds" && hasValue)
+        {
+            options.seconds = std::stof(argv[++index]);
+        }
+        else if (argument == "--think" && hasValue)
+        {
+            options.thinkSeconds = std::stof(argv[++index]);
+        }
+        else if (argument == "--seed" && hasValue)
+        {
+            options.seed = static_cast<std::uint32_t>(std::stoul(argv[++index]));
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option: " << argument << "\n";
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+int connectTo(const Options& options)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    const std::string port = std::to_string(options.port);
+    if (::getaddrinfo(options.host.c_str(), port.c_str(), &hints, &addresses) != 0)
+    {
+        return -1;
+    }
+
+    int fd = -1;
+    for (const addrinfo* address = addresses; address != nullptr && fd < 0; address = address->ai_next)
+    {
+        fd = ::socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd >= 0 && ::connect(fd, address->ai_addr, address->ai_addrlen) < 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ::freeaddrinfo(addresses);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    const int on = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+void flush(Bot& bot)
+{
+    std::size_t sent = 0;
+    while (sent < bot.output.size())
+    {
+        const ssize_t written = ::send(bot.fd, bot.output.data() + sent, bot.output.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0)
+        {
+            break; // picks are tiny; whatever did not fit goes out next frame
+        }
+        sent += static_cast<std::size_t>(written);
+    }
+    bot.output.erase(0, sent);
+}
+
+// Returns false once the connection should be dropped.
+bool handleFrame(Bot& bot, const memory::NetFrame& frame, memory::NetBoardDelta& delta, Totals& totals, float thinkSeconds)
+{
+    switch (frame.type)
+    {
+        case memory::NetMessageType::MatchStart:
+        {
+            memory::NetMatchStart start;
+            if (!memory::decodeMatchStart(frame.payload, start))
+            {
+                return false;
+            }
+            bot.board.start(start);
+            bot.inMatch = true;
+            bot.thinkRemaining = thinkSeconds;
+            bot.unacked.clear();
+            ++totals.seatsStarted;
+            return true;
+        }
+        case memory::NetMessageType::BoardDelta:
+        {
+            if (!bot.inMatch || !memory::decodeBoardDelta(frame.payload, bot.board.board().cardCount(), delta))
+            {
+                return false;
+            }
+            bot.board.applyDelta(delta);
+            ++totals.deltas;
+
+            const Clock::time_point now = Clock::now();
+            std::size_t kept = 0;
+            for (const auto& [sequence, sentAt] : bot.unacked)
+            {
+                if (sequence <= delta.ackedPick)
+                {
+                    totals.ackMilliseconds.push_back(std::chrono::duration<float, std::milli>(now - sentAt).count());
+                }
+                else
+                {
+                    bot.unacked[kept++] = {sequence, sentAt};
+                }
+            }
+            bot.unacked.resize(kept);
+            return true;
+        }
+        case memory::NetMessageType::MatchEnd:
+        {
+            memory::NetMatchEnd end;
+            if (!memory::decodeMatchEnd(frame.payload, end))
+            {
+                return false;
+            }
+            bot.inMatch = false;
+            ++totals.seatsFinished;
+            memory::appendHello(bot.output);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool readBot(Bot& bot, memory::NetBoardDelta& delta, Totals& totals, float thinkSeconds)
+{
+    std::array<char, kReadChunkBytes> chunk{};
+    for (;;)
+    {
+        const ssize_t received = ::recv(bot.fd, chunk.data(), chunk.size(), 0);
+        if (received > 0)
+        {
+            bot.input.append(chunk.data(), static_cast<std::size_t>(received));
+            totals.bytesReceived += static_cast<std::uint64_t>(received);
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        {
+            break;
+        }
+        return false;
+    }
+
+    std::size_t consumed = 0;
+    memory::NetFrame frame;
+    for (;;)
+    {
+        const memory::FrameStatus status = memory::peekFrame(std::string_view(bot.input).substr(consumed), frame);
+        if (status == memory::FrameStatus::Incomplete)
+        {
+            break;
+        }
+        if (status == memory::FrameStatus::Malformed || !handleFrame(bot, frame, delta, totals, thinkSeconds))
+        {
+            return false;
+        }
+        consumed += frame.size;
+    }
+    bot.input.erase(0, consumed);
+    return true;
+}
+
+void think(Bot& bot, float deltaSeconds, float thinkSeconds, std::mt19937& random, std::vector<int>& candidates, Totals& totals)
+{
+    bot.board.step(deltaSeconds);
+    bot.thinkRemaining -= deltaSeconds;
+    if (!bot.board.myTurn() || bot.board.pendingPicks() > 0U || bot.thinkRemaining > 0.0F)
+    {
+        return;
+    }
+
+    candidates.clear();
+    for (int slot = 0; slot < bot.board.board().cardCount(); ++slot)
+    {
+        if (bot.board.canPick(slot))
+        {
+            candidates.push_back(slot);
+        }
+    }
+    if (candidates.empty())
+    {
+        return;
+    }
+
+    if (const std::optional<memory::NetPick> pick = bot.board.pick(candidates[memory::uniformBelow(random, static_cast<std::uint32_t>(candidates.size()))]))
+    {
+        memory::appendPick(bot.output, *pick);
+        bot.unacked.emplace_back(pick->sequence, Clock::now());
+        bot.thinkRemaining = thinkSeconds;
+        ++totals.picks;
+    }
+}
+
+float percentile(std::vector<float>& values, float fraction)
+{
+    if (values.empty())
+    {
+        return 0.0F;
+    }
+    const std::size_t index = std::min(values.size() - 1U, static_cast<std::size_t>(fraction * static_cast<float>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        if (!parseOptions(argc, argv, options))
+        {
+            return 1;
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "Invalid option value: " << error.what() << "\n";
+        return 1;
+    }
+
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    const int epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<Bot> bots(options.connections);
+    for (std::size_t index = 0; index < bots.size(); ++index)
+    {
+        Bot& bot = bots[index];
+        bot.fd = connectTo(options);
+        if (bot.fd < 0)
+        {
+            std::cerr << "Cannot connect to " << options.host << ":" << options.port << " (connection " << index
+                      << "): " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = index;
+        ::epoll_ctl(epoll, EPOLL_CTL_ADD, bot.fd, &event);
+        memory::appendHello(bot.output);
+        flush(bot);
+    }
+    std::cout << "Connected " << bots.size() << " bots to " << options.host << ":" << options.port << "\n";
+
+    Totals totals;
+    memory::NetBoardDelta delta;
+    std::mt19937 random(options.seed);
+    std::vector<int> candidates;
+    std::array<epoll_event, kMaxEvents> events{};
+    const Clock::time_point start = Clock::now();
+    Clock::time_point lastFrame = start;
+    while (std::chrono::duration<float>(Clock::now() - start).count() < options.seconds)
+    {
+        const int count = ::epoll_wait(epoll, events.data(), kMaxEvents, static_cast<int>(kFrameSeconds * 1000.0F));
+        for (int index = 0; index < count; ++index)
+        {
+            Bot& bot = bots[static_cast<std::size_t>(events[static_cast<std::size_t>(index)].data.u64)];
+            if (bot.fd >= 0 && !readBot(bot, delta, totals, options.thinkSeconds))
+            {
+                ::close(bot.fd);
+                bot.fd = -1;
+                ++totals.disconnects;
+            }
+        }
+
+        const Clock::time_point now = Clock::now();
+        const float elapsed = std::chrono::duration<float>(now - lastFrame).count();
+        if (elapsed < kFrameSeconds)
+        {
+            continue;
+        }
+        lastFrame = now;
+        for (Bot& bot : bots)
+        {
+            if (bot.fd < 0)
+            {
+                continue;
+            }
+            if (bot.inMatch)
+            {
+                think(bot, elapsed, options.thinkSeconds, random, candidates, totals);
+            }
+            if (!bot.output.empty())
+            {
+                flush(bot);
+            }
+        }
+    }
+
+    const float seconds = std::chrono::duration<float>(Clock::now() - start).count();
+    std::cout << "Bots started " << totals.seatsStarted << " match seats, finished " << totals.seatsFinished << " ("
+              << static_cast<float>(totals.seatsFinished) / seconds << "/s), " << totals.picks << " picks, "
+              << totals.deltas << " deltas, " << totals.bytesReceived / 1024U << " KB received, "
+              << totals.disconnects << " disconnects\n";
+    std::cout << "Pick acknowledged after p50 " << percentile(totals.ackMilliseconds, 0.50F) << " ms, p99 "
+              << percentile(totals.ackMilliseconds, 0.99F) << " ms\n";
+
+    for (const Bot& bot : bots)
+    {
+        if (bot.fd >= 0)
+        {
+            ::close(bot.fd);
+        }
+    }
+    ::close(epoll);
+    return totals.disconnects == 0U ? 0 : 1;
+}
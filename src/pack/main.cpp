@@ -0,0 +1,106 @@
+#include "core/asset_pack.hpp"
+#include "core/card_manifest.hpp"
+#include "pack/pack_contents.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+struct Options
+{
+    fs::path root = ".";
+    fs::path output = "assets/memory_game.pack";
+};
+
+void printUsage()
+{
+    std::cout <<
+        "Builds the runtime asset pack from assets/manifest/cards.json, the processed\n"
+        "card art and the bundled font. The manifest itself is packed as well, and\n"
+        "every image also gets half and quarter resolution tiers (name@2, name@4).\n"
+        "\n"
+        "Usage:\n"
+        "  memory_pack [--root DIR] [--output FILE]\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string_view argument = argv[index];
+        const bool hasValue = index + 1 < argc;
+
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage();
+            return false;
+        }
+        if (argument == "--root" && hasValue)
+        {
+            options.root = argv[++index];
+        }
+        else if (argument == "--output" && hasValue)
+        {
+            options.output = argv[++index];
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option: " << argument << "\n";
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+
+    const fs::path manifestPath = options.root / "assets/manifest/cards.json";
+    std::string error;
+    const std::optional<memory::CardManifest> manifest = memory::readCardManifest(manifestPath, error);
+    if (!manifest)
+    {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+
+    memory::AssetPackWriter writer;
+    addPackManifest(writer, manifestPath);
+    std::size_t imageCount = 0;
+    if (addPackImageFile(writer, "card_back", options.root / "assets/processed/card_back.png"))
+    {
+        ++imageCount;
+    }
+    for (const memory::CardManifestEntry& entry : manifest->cards)
+    {
+        if (addPackImageFile(writer, entry.slug, options.root / entry.processed))
+        {
+            ++imageCount;
+        }
+    }
+    const bool fontPacked = addPackFont(writer, options.root);
+
+    if (!writer.write(options.output, error))
+    {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
+
+    std::cout << "Wrote " << options.output.string() << ": " << imageCount << " images"
+              << (fontPacked ? ", 1 font" : ", no font") << "\n";
+    return 0;
+}
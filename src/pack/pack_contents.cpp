@@ -0,0 +1,88 @@
+#include "pack/pack_contents.hpp"
+
+#include "core/texture_tiers.hpp"
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+bool addPackManifest(memory::AssetPackWriter& writer, const fs::path& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        return false;
+    }
+    const std::vector<std::uint8_t> bytes{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+    writer.addData("manifest", bytes);
+    return true;
+}
+
+// The game picks one tier per image to match its card size, so packing the
+// smaller ones costs disk space only, never VRAM.
+void addPackImage(memory::AssetPackWriter& writer, const std::string& name, std::uint32_t width, std::uint32_t height, std::span<const std::uint8_t> rgba)
+{
+    writer.addImage(name, width, height, rgba);
+    for (const unsigned int divisor : memory::kTextureTierDivisors)
+    {
+        if (divisor == 1U || width / divisor == 0U || height / divisor == 0U)
+        {
+            continue;
+        }
+        const memory::RgbaImage tier = memory::downsampleRgba(rgba.data(), width, height, divisor);
+        writer.addImage(memory::textureTierName(name, divisor), tier.width, tier.height, tier.pixels);
+    }
+}
+
+// Missing art is not an error: the game draws a tinted fallback for it.
+bool addPackImageFile(memory::AssetPackWriter& writer, const std::string& name, const fs::path& path)
+{
+    if (!fs::exists(path))
+    {
+        std::cerr << "Warning: missing " << path.string() << ", card will use its fallback colour.\n";
+        return false;
+    }
+
+    sf::Image image;
+    if (!image.loadFromFile(path))
+    {
+        std::cerr << "Warning: failed to decode " << path.string() << "\n";
+        return false;
+    }
+
+    const sf::Vector2u size = image.getSize();
+    const std::size_t byteCount = static_cast<std::size_t>(size.x) * size.y * 4U;
+    addPackImage(writer, name, size.x, size.y, std::span<const std::uint8_t>(image.getPixelsPtr(), byteCount));
+    return true;
+}
+
+// System fonts are left to the game's fallback probing; only the bundled ones are packed.
+bool addPackFont(memory::AssetPackWriter& writer, const fs::path& root)
+{
+    const std::array<fs::path, 3> candidates{{
+        fs::path("assets/fonts/PressStart2P-Regular.ttf"),
+        fs::path("assets/fonts/VT323-Regular.ttf"),
+        fs::path("assets/fonts/font.ttf"),
+    }};
+
+    for (const fs::path& candidate : candidates)
+    {
+        std::ifstream stream(root / candidate, std::ios::binary);
+        if (!stream)
+        {
+            continue;
+        }
+
+        const std::vector<std::uint8_t> bytes{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+        writer.addFont("font", bytes);
+        std::cout << "Packed font: " << candidate.string() << "\n";
+        return true;
+    }
+    return false;
+}
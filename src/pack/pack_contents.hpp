@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/asset_pack.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+
+// What goes into the runtime pack and under which names, shared by
+// memory_pack (from the processed PNGs) and memory_assets (straight from
+// the tiles it has just made).
+
+// The manifest is packed verbatim as "manifest"; false if it cannot be read.
+bool addPackManifest(memory::AssetPackWriter& writer, const std::filesystem::path& path);
+
+// Adds the image and its reduced resolution tiers (name@2, name@4).
+void addPackImage(memory::AssetPackWriter& writer, const std::string& name, std::uint32_t width, std::uint32_t height, std::span<const std::uint8_t> rgba);
+
+// Decodes `path` and adds it like addPackImage(); warns and returns false if
+// it is missing or undecodable.
+bool addPackImageFile(memory::AssetPackWriter& writer, const std::string& name, const std::filesystem::path& path);
+
+// The first bundled font under `root`, as "font"; false if there is none.
+bool addPackFont(memory::AssetPackWriter& writer, const std::filesystem::path& root);
@@ -0,0 +1,200 @@
+#include "core/memory_rules.hpp"
+#include "core/net_protocol.hpp"
+#include "server/match_server.hpp"
+
+#include <csignal>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/resource.h>
+
+namespace
+{
+struct Options
+{
+    MatchServerOptions server;
+    unsigned int threads = 1;
+    std::uint32_t seed = 0; // 0: random
+};
+
+void printUsage()
+{
+    std::cout <<
+        "Authoritative server for head-to-head memory matches.\n"
+        "\n"
+        "Usage:\n"
+        "  memory_server [--port P] [--threads N] [--board COLUMNSxROWS] [--characters N]\n"
+        "                [--reveal SECONDS] [--tick-rate HZ] [--report SECONDS] [--seed S]\n"
+        "\n"
+        "Clients are paired in the order they connect. Each thread runs its own\n"
+        "event loop on the shared port, so --threads should not exceed the cores.\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    float tickRate = 1.0F / options.server.tickSeconds;
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string_view argument = argv[index];
+        const bool hasValue = index + 1 < argc;
+
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage();
+            return false;
+        }
+        if (argument == "--port" && hasValue)
+        {
+            options.server.port = static_cast<std::uint16_t>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--threads" && hasValue)
+        {
+            options.threads = static_cast<unsigned int>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--board" && hasValue)
+        {
+            if (!memory::parseBoardSize(argv[++index], options.server.board.columns, options.server.board.rows))
+            {
+                std::cerr << "Expected --board COLUMNSxROWS, got: " << argv[index] << "\n";
+                return false;
+            }
+        }
+        else if (argument == "--characters" && hasValue)
+        {
+            if (!memory::parsePositiveInt(argv[++index], options.server.board.characterCount))
+            {
+                std::cerr << "Expected --characters N, got: " << argv[index] << "\n";
+                return false;
+            }
+        }
+        else if (argument == "--reveal" && hasValue)
+        {
+            options.server.board.revealSeconds = std::stof(argv[++index]);
+        }
+        else if (argument == "--tick-rate" && hasValue)
+        {
+            tickRate = std::stof(argv[++index]);
+        }
+        else if (argument == "--report" && hasValue)
+        {
+            options.server.reportSeconds = std::stof(argv[++index]);
+        }
+        else if (argument == "--seed" && hasValue)
+        {
+            options.seed = static_cast<std::uint32_t>(std::stoul(argv[++index]));
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option: " << argument << "\n";
+            printUsage();
+            return false;
+        }
+    }
+
+    if (!memory::isValidConfig(options.server.board))
+    {
+        std::cerr << "Invalid board: " << options.server.board.columns << "x" << options.server.board.rows << "\n";
+        return false;
+    }
+    if (!(tickRate >= 1.0F && tickRate <= 1000.0F) || options.threads == 0U)
+    {
+        std::cerr << "--tick-rate must be within 1..1000 and --threads at least 1\n";
+        return false;
+    }
+    options.server.tickSeconds = 1.0F / tickRate;
+    return true;
+}
+
+// Every connection is a descriptor, and the default soft limit is often 1024.
+void raiseDescriptorLimit()
+{
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        if (!parseOptions(argc, argv, options))
+        {
+            return 1;
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "Invalid option value: " << error.what() << "\n";
+        return 1;
+    }
+    raiseDescriptorLimit();
+
+    // Block the stop signals before any loop thread starts, so they all
+    // inherit the mask and only sigwait() below ever sees them.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    const std::uint32_t seed = options.seed != 0U ? options.seed : std::random_device{}();
+    std::vector<std::unique_ptr<MatchServer>> servers;
+    for (unsigned int loop = 0; loop < options.threads; ++loop)
+    {
+        auto server = std::make_unique<MatchServer>(options.server, seed + loop, static_cast<int>(loop));
+        std::string error;
+        if (!server->listen(error))
+        {
+            std::cerr << "Cannot serve on port " << options.server.port << ": " << error << "\n";
+            return 1;
+        }
+        servers.push_back(std::move(server));
+    }
+
+    std::vector<std::thread> threads;
+    for (const std::unique_ptr<MatchServer>& server : servers)
+    {
+        threads.emplace_back([&server] { server->run(); });
+    }
+    std::cout << "memory_server listening on port " << options.server.port << " with " << options.threads << " event loop(s), "
+              << options.server.board.columns << "x" << options.server.board.rows << " boards" << std::endl;
+
+    int received = 0;
+    sigwait(&signals, &received);
+    for (const std::unique_ptr<MatchServer>& server : servers)
+    {
+        server->stop();
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    MatchServerStats total;
+    for (const std::unique_ptr<MatchServer>& server : servers)
+    {
+        const MatchServerStats& stats = server->stats();
+        total.connections += stats.connections;
+        total.matchesStarted += stats.matchesStarted;
+        total.matchesFinished += stats.matchesFinished;
+        total.picks += stats.picks;
+        total.deltas += stats.deltas;
+        total.bytesSent += stats.bytesSent;
+    }
+    std::cout << "Served " << total.connections << " connections, " << total.matchesStarted << " matches ("
+              << total.matchesFinished << " finished), " << total.picks << " picks, " << total.deltas << " deltas, "
+              << total.bytesSent << " bytes\n";
+    return 0;
+}
@@ -0,0 +1,684 @@
+#include "server/match_server.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr std::uint64_t kListenToken = ~std::uint64_t{0};
+constexpr std::uint64_t kTimerToken = kListenToken - 1U;
+constexpr std::uint64_t kWakeToken = kListenToken - 2U;
+constexpr int kMaxEvents = 256;
+constexpr int kListenBacklog = 4096;
+constexpr std::uint64_t kMaxCatchUpTicks = 4; // an overloaded loop slows the game instead
+constexpr std::size_t kReadChunkBytes = 16U * 1024U;
+constexpr std::size_t kMaxInputBytes = memory::kNetFrameHeaderBytes + memory::kMaxNetPayloadBytes;
+
+std::uint64_t connectionToken(std::uint32_t index, std::uint32_t generation)
+{
+    return (static_cast<std::uint64_t>(generation) << 32U) | index;
+}
+
+std::string systemError(const char* what)
+{
+    return std::string(what) + ": " + std::strerror(errno);
+}
+} // namespace
+
+MatchServer::MatchServer(const MatchServerOptions& options, std::uint32_t seed, int loopIndex) :
+    options_(options),
+    loopIndex_(loopIndex),
+    random_(seed)
+{
+}
+
+MatchServer::~MatchServer()
+{
+    for (const Connection& connection : connections_)
+    {
+        if (connection.fd >= 0)
+        {
+            ::close(connection.fd);
+        }
+    }
+    for (const int fd : {listener_, timer_, wake_, epoll_})
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+}
+
+bool MatchServer::listen(std::string& error)
+{
+    epoll_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_ < 0)
+    {
+        error = systemError("epoll_create1");
+        return false;
+    }
+
+    listener_ = ::socket(AF_INET6, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener_ < 0)
+    {
+        error = systemError("socket");
+        return false;
+    }
+    const int on = 1;
+    const int off = 0;
+    ::setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    ::setsockopt(listener_, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+    ::setsockopt(listener_, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+
+    sockaddr_in6 address{};
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_any;
+    address.sin6_port = htons(options_.port);
+    if (::bind(listener_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listener_, kListenBacklog) < 0)
+    {
+        error = systemError("listen");
+        return false;
+    }
+
+    timer_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    wake_ = ::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (timer_ < 0 || wake_ < 0)
+    {
+        error = systemError("timerfd/eventfd");
+        return false;
+    }
+    const long tickNanos = std::max(1L, std::lround(static_cast<double>(options_.tickSeconds) * 1.0e9));
+    itimerspec interval{};
+    interval.it_interval.tv_sec = tickNanos / 1000000000L;
+    interval.it_interval.tv_nsec = tickNanos % 1000000000L;
+    interval.it_value = interval.it_interval;
+    ::timerfd_settime(timer_, 0, &interval, nullptr);
+
+    for (const auto& [fd, token] : {std::pair{listener_, kListenToken}, std::pair{timer_, kTimerToken}, std::pair{wake_, kWakeToken}})
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = token;
+        if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            error = systemError("epoll_ctl");
+            return false;
+        }
+    }
+    return true;
+}
+
+void MatchServer::run()
+{
+    std::array<epoll_event, kMaxEvents> events{};
+    while (epoll_ >= 0 && !stopping_.load(std::memory_order_acquire))
+    {
+        const int count = ::epoll_wait(epoll_, events.data(), kMaxEvents, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << "Warning: epoll_wait failed: " << std::strerror(errno) << "\n";
+            return;
+        }
+
+        for (int index = 0; index < count; ++index)
+        {
+            const epoll_event& event = events[static_cast<std::size_t>(index)];
+            const std::uint64_t token = event.data.u64;
+            if (token == kListenToken)
+            {
+                acceptConnections();
+                continue;
+            }
+            if (token == kWakeToken)
+            {
+                continue;
+            }
+            if (token == kTimerToken)
+            {
+                std::uint64_t expirations = 0;
+                if (::read(timer_, &expirations, sizeof(expirations)) == static_cast<ssize_t>(sizeof(expirations)))
+                {
+                    for (std::uint64_t tick = 0; tick < std::min(expirations, kMaxCatchUpTicks); ++tick)
+                    {
+                        this->tick();
+                    }
+                }
+                continue;
+            }
+
+            // An earlier event in this batch may have closed the connection
+            // and a newer one reused its slot; the generation tells them apart.
+            const std::uint32_t connection = static_cast<std::uint32_t>(token);
+            if (connection >= connections_.size() || connections_[connection].generation != static_cast<std::uint32_t>(token >> 32U) ||
+                connections_[connection].fd < 0)
+            {
+                continue;
+            }
+            if ((event.events & (EPOLLERR | EPOLLHUP)) != 0U)
+            {
+                closeConnection(connection);
+                continue;
+            }
+            if ((event.events & EPOLLOUT) != 0U)
+            {
+                flushConnection(connection);
+            }
+            if ((event.events & (EPOLLIN | EPOLLRDHUP)) != 0U && connections_[connection].fd >= 0)
+            {
+                readConnection(connection);
+            }
+        }
+        flushConnections();
+    }
+}
+
+void MatchServer::stop()
+{
+    stopping_.store(true, std::memory_order_release);
+    if (wake_ >= 0)
+    {
+        const std::uint64_t one = 1U;
+        (void)::write(wake_, &one, sizeof(one));
+    }
+}
+
+void MatchServer::acceptConnections()
+{
+    for (;;)
+    {
+        const int fd = ::accept4(listener_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED)
+            {
+                std::cerr << "Warning: accept failed: " << std::strerror(errno) << "\n";
+            }
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            return;
+        }
+        const int on = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        std::uint32_t index = 0;
+        if (!freeConnections_.empty())
+        {
+            index = freeConnections_.back();
+            freeConnections_.pop_back();
+        }
+        else
+        {
+            index = static_cast<std::uint32_t>(connections_.size());
+            connections_.emplace_back();
+        }
+        Connection& connection = connections_[index];
+        connection.fd = fd;
+        connection.input.clear();
+        connection.output.clear();
+        connection.outputSent = 0;
+        connection.match = kNone;
+        connection.seat = memory::kNoSeat;
+        connection.flushQueued = false;
+        connection.writeBlocked = false;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = connectionToken(index, connection.generation);
+        if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            closeConnection(index);
+            continue;
+        }
+        ++stats_.connections;
+    }
+}
+
+void MatchServer::readConnection(std::uint32_t index)
+{
+    std::array<char, kReadChunkBytes> chunk{};
+    for (;;)
+    {
+        const ssize_t received = ::recv(connections_[index].fd, chunk.data(), chunk.size(), 0);
+        if (received > 0)
+        {
+            connections_[index].input.append(chunk.data(), static_cast<std::size_t>(received));
+            if (static_cast<std::size_t>(received) < chunk.size())
+            {
+                break;
+            }
+            continue;
+        }
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        closeConnection(index);
+        return;
+    }
+
+    const std::string& input = connections_[index].input;
+    std::size_t consumed = 0;
+    for (;;)
+    {
+        memory::NetFrame frame;
+        const memory::FrameStatus status = memory::peekFrame(std::string_view(input).substr(consumed), frame);
+        if (status == memory::FrameStatus::Incomplete)
+        {
+            break;
+        }
+        if (status == memory::FrameStatus::Malformed || !handleFrame(index, frame))
+        {
+            closeConnection(index);
+            return;
+        }
+        consumed += frame.size;
+    }
+
+    connections_[index].input.erase(0, consumed);
+    if (input.size() >= kMaxInputBytes)
+    {
+        closeConnection(index);
+    }
+}
+
+bool MatchServer::handleFrame(std::uint32_t index, const memory::NetFrame& frame)
+{
+    switch (frame.type)
+    {
+        case memory::NetMessageType::Hello:
+        {
+            std::uint16_t version = 0;
+            if (!memory::decodeHello(frame.payload, version) || version != memory::kNetProtocolVersion)
+            {
+                return false;
+            }
+            joinLobby(index);
+            return true;
+        }
+        case memory::NetMessageType::Pick:
+        {
+            memory::NetPick pick;
+            if (!memory::decodePick(frame.payload, pick))
+            {
+                return false;
+            }
+            handlePick(index, pick);
+            return true;
+        }
+        default:
+            // Server-to-client messages have no business arriving here.
+            return false;
+    }
+}
+
+void MatchServer::closeConnection(std::uint32_t index)
+{
+    Connection& connection = connections_[index];
+    if (connection.fd < 0)
+    {
+        return;
+    }
+
+    ::epoll_ctl(epoll_, EPOLL_CTL_DEL, connection.fd, nullptr);
+    ::close(connection.fd);
+    connection.fd = -1;
+    ++connection.generation;
+    if (waiting_ == index)
+    {
+        waiting_ = kNone;
+    }
+    if (connection.match != kNone)
+    {
+        const std::uint32_t match = connection.match;
+        const std::uint8_t seat = connection.seat;
+        connection.match = kNone;
+        matches_[match].seats[seat] = kNone;
+        endMatch(match, static_cast<std::uint8_t>(seat ^ 1U), memory::NetEndReason::OpponentLeft);
+    }
+    freeConnections_.push_back(index);
+}
+
+void MatchServer::queueFlush(std::uint32_t index)
+{
+    Connection& connection = connections_[index];
+    if (!connection.flushQueued && !connection.writeBlocked)
+    {
+        connection.flushQueued = true;
+        flushQueue_.push_back(index);
+    }
+}
+
+void MatchServer::flushConnections()
+{
+    // Closing a connection here can queue its opponent's MatchEnd, so the
+    // queue may grow while it is walked.
+    for (std::size_t position = 0; position < flushQueue_.size(); ++position)
+    {
+        const std::uint32_t index = flushQueue_[position];
+        connections_[index].flushQueued = false;
+        if (connections_[index].fd >= 0)
+        {
+            flushConnection(index);
+        }
+    }
+    flushQueue_.clear();
+}
+
+void MatchServer::flushConnection(std::uint32_t index)
+{
+    Connection& connection = connections_[index];
+    while (connection.outputSent < connection.output.size())
+    {
+        const ssize_t sent = ::send(
+            connection.fd,
+            connection.output.data() + connection.outputSent,
+            connection.output.size() - connection.outputSent,
+            MSG_NOSIGNAL);
+        if (sent > 0)
+        {
+            connection.outputSent += static_cast<std::size_t>(sent);
+            stats_.bytesSent += static_cast<std::uint64_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            if (connection.output.size() - connection.outputSent > options_.maxOutputBytes)
+            {
+                closeConnection(index);
+                return;
+            }
+            watchWrites(index, true);
+            return;
+        }
+        closeConnection(index);
+        return;
+    }
+
+    connection.output.clear();
+    connection.outputSent = 0;
+    watchWrites(index, false);
+}
+
+void MatchServer::watchWrites(std::uint32_t index, bool enabled)
+{
+    Connection& connection = connections_[index];
+    if (connection.writeBlocked == enabled)
+    {
+        return;
+    }
+    connection.writeBlocked = enabled;
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP | (enabled ? EPOLLOUT : 0U);
+    event.data.u64 = connectionToken(index, connection.generation);
+    ::epoll_ctl(epoll_, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+void MatchServer::joinLobby(std::uint32_t index)
+{
+    if (connections_[index].match != kNone || waiting_ == index)
+    {
+        return;
+    }
+    if (waiting_ == kNone)
+    {
+        waiting_ = index;
+        return;
+    }
+
+    const std::uint32_t first = waiting_;
+    waiting_ = kNone;
+    startMatch(first, index);
+}
+
+void MatchServer::startMatch(std::uint32_t first, std::uint32_t second)
+{
+    std::uint32_t index = 0;
+    if (!freeMatches_.empty())
+    {
+        index = freeMatches_.back();
+        freeMatches_.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(matches_.size());
+        matches_.emplace_back();
+    }
+
+    // Finished matches are recycled, so their arrays keep their capacity.
+    Match& match = matches_[index];
+    match.id = nextMatchId_++;
+    match.board.config = options_.board;
+    memory::resetBoard(match.board, random_);
+    memory::takeDirtyCards(match.board, match.dirty);
+    match.sent.assign(match.board.state.size(), memory::CardState::FaceDown);
+    match.seats = {first, second};
+    match.ackedPick = {};
+    match.ackChanged = {};
+    match.scores = {};
+    match.turn = 0;
+    match.countersChanged = false;
+    match.activeIndex = kNotActive;
+    ++stats_.matchesStarted;
+    ++stats_.liveMatches;
+
+    for (std::uint8_t seat = 0; seat < memory::kSeatCount; ++seat)
+    {
+        Connection& connection = connections_[match.seats[seat]];
+        connection.match = index;
+        connection.seat = seat;
+        memory::appendMatchStart(connection.output, memory::NetMatchStart{match.id, seat, match.board.config});
+        queueFlush(match.seats[seat]);
+    }
+}
+
+void MatchServer::handlePick(std::uint32_t index, const memory::NetPick& pick)
+{
+    const Connection& connection = connections_[index];
+    if (connection.match == kNone)
+    {
+        return;
+    }
+
+    Match& match = matches_[connection.match];
+    const std::uint8_t seat = connection.seat;
+    ++stats_.picks;
+    if (pick.sequence > match.ackedPick[seat])
+    {
+        match.ackedPick[seat] = pick.sequence;
+        match.ackChanged[seat] = true;
+    }
+    if (seat == match.turn && memory::applyPick(match.board, pick.slot) == memory::PickResult::SecondCard)
+    {
+        match.countersChanged = true;
+    }
+
+    // Answered straight away rather than on the next tick: the ack settles
+    // the prediction (a refused pick rolls back) and the face arrives before
+    // the client's flip reaches its half way.
+    publish(match);
+    activate(connection.match);
+}
+
+void MatchServer::activate(std::uint32_t match)
+{
+    Match& state = matches_[match];
+    if (state.activeIndex == kNotActive)
+    {
+        state.activeIndex = active_.size();
+        active_.push_back(match);
+    }
+}
+
+void MatchServer::tick()
+{
+    ++tick_;
+    ++stats_.ticks;
+    std::size_t position = 0;
+    while (position < active_.size())
+    {
+        const std::uint32_t index = active_[position];
+        Match& match = matches_[index];
+        memory::BoardState& board = match.board;
+
+        const bool pairing = board.pairPhase != memory::PairPhase::Idle;
+        const int matchedBefore = board.matchedPairs;
+        memory::step(board, options_.tickSeconds);
+        if (pairing && board.pairPhase == memory::PairPhase::Idle)
+        {
+            // A found pair keeps the turn; a miss hands it to the other seat.
+            if (board.matchedPairs > matchedBefore)
+            {
+                ++match.scores[match.turn];
+            }
+            else
+            {
+                match.turn ^= 1U;
+            }
+            match.countersChanged = true;
+        }
+        publish(match);
+
+        // Both swap another match into this position.
+        if (board.won)
+        {
+            const std::uint8_t winner = match.scores[0] == match.scores[1]
+                ? memory::kNoSeat
+                : static_cast<std::uint8_t>(match.scores[0] > match.scores[1] ? 0U : 1U);
+            endMatch(index, winner, memory::NetEndReason::BoardCleared);
+            continue;
+        }
+        if (!memory::isAnimating(board))
+        {
+            deactivate(index);
+            continue;
+        }
+        ++position;
+    }
+
+    if (options_.reportSeconds > 0.0F &&
+        static_cast<float>(++ticksSinceReport_) * options_.tickSeconds >= options_.reportSeconds)
+    {
+        report();
+        ticksSinceReport_ = 0;
+    }
+}
+
+void MatchServer::publish(Match& match)
+{
+    memory::BoardState& board = match.board;
+    memory::takeDirtyCards(board, match.dirty);
+    std::sort(match.dirty.begin(), match.dirty.end());
+
+    // Flip and fade progress is left to the clients; only state changes travel.
+    delta_.cards.clear();
+    for (const std::int32_t index : match.dirty)
+    {
+        const std::size_t card = static_cast<std::size_t>(index);
+        const memory::CardState state = board.state[card];
+        if (state != match.sent[card])
+        {
+            match.sent[card] = state;
+            delta_.cards.push_back(memory::NetCardChange{index, state, memory::showsFace(state) ? board.characterIndex[card] : -1});
+        }
+    }
+
+    delta_.tick = tick_;
+    delta_.turn = match.turn;
+    delta_.moves = board.moves;
+    delta_.matchedPairs = board.matchedPairs;
+    delta_.scores = match.scores;
+    for (std::size_t seat = 0; seat < memory::kSeatCount; ++seat)
+    {
+        const std::uint32_t connection = match.seats[seat];
+        if (connection == kNone || (delta_.cards.empty() && !match.countersChanged && !match.ackChanged[seat]))
+        {
+            continue;
+        }
+        delta_.ackedPick = match.ackedPick[seat];
+        memory::appendBoardDelta(connections_[connection].output, delta_);
+        queueFlush(connection);
+        match.ackChanged[seat] = false;
+        ++stats_.deltas;
+    }
+    match.countersChanged = false;
+}
+
+void MatchServer::deactivate(std::uint32_t index)
+{
+    Match& match = matches_[index];
+    if (match.activeIndex == kNotActive)
+    {
+        return;
+    }
+
+    // Swap-remove; the last active match takes over the position.
+    const std::uint32_t moved = active_.back();
+    active_[match.activeIndex] = moved;
+    matches_[moved].activeIndex = match.activeIndex;
+    active_.pop_back();
+    match.activeIndex = kNotActive;
+}
+
+void MatchServer::endMatch(std::uint32_t index, std::uint8_t winner, memory::NetEndReason reason)
+{
+    deactivate(index);
+    Match& match = matches_[index];
+    for (const std::uint32_t seat : match.seats)
+    {
+        if (seat == kNone)
+        {
+            continue;
+        }
+        Connection& connection = connections_[seat];
+        memory::appendMatchEnd(connection.output, memory::NetMatchEnd{winner, reason});
+        connection.match = kNone;
+        connection.seat = memory::kNoSeat;
+        queueFlush(seat);
+    }
+    freeMatches_.push_back(index);
+    ++stats_.matchesFinished;
+    --stats_.liveMatches;
+}
+
+void MatchServer::report()
+{
+    stats_.activeMatches = active_.size();
+    const float seconds = static_cast<float>(ticksSinceReport_) * options_.tickSeconds;
+    std::ostringstream line;
+    line << "[loop " << loopIndex_ << "] live matches " << stats_.liveMatches << ", active " << stats_.activeMatches
+         << ", connections " << (connections_.size() - freeConnections_.size())
+         << ", picks/s " << static_cast<double>(stats_.picks - reported_.picks) / seconds
+         << ", matches done/s " << static_cast<double>(stats_.matchesFinished - reported_.matchesFinished) / seconds
+         << ", KB/s out " << static_cast<double>(stats_.bytesSent - reported_.bytesSent) / 1024.0 / seconds << "\n";
+    std::cout << line.str() << std::flush;
+    reported_ = stats_;
+}
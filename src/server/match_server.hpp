@@ -0,0 +1,138 @@
+#pragma once
+
+#include "core/memory_rules.hpp"
+#include "core/net_protocol.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+struct MatchServerOptions
+{
+    std::uint16_t port = memory::kDefaultServerPort;
+    memory::BoardConfig board;
+    float tickSeconds = 1.0F / 30.0F;
+    // Print a status line this often; 0 disables it.
+    float reportSeconds = 0.0F;
+    // A client whose unsent output grows past this is too slow and dropped.
+    std::size_t maxOutputBytes = 256U * 1024U;
+};
+
+struct MatchServerStats
+{
+    std::uint64_t connections = 0;
+    std::uint64_t matchesStarted = 0;
+    std::uint64_t matchesFinished = 0;
+    std::uint64_t picks = 0;
+    std::uint64_t deltas = 0;
+    std::uint64_t bytesSent = 0;
+    std::uint64_t ticks = 0;
+    std::size_t liveMatches = 0;
+    std::size_t activeMatches = 0;
+};
+
+// One epoll event loop hosting any number of matches; no thread per match or
+// connection. Several servers can listen on the same port (SO_REUSEPORT), one
+// per core, and the kernel spreads new connections between them. Each tick
+// only steps matches with something animating, and a match sends a delta
+// only when a card state, a counter or a pick acknowledgement changed. All
+// the deltas of a tick go out in one write per connection.
+//
+// Linux only (epoll, timerfd, eventfd).
+class MatchServer
+{
+public:
+    MatchServer(const MatchServerOptions& options, std::uint32_t seed, int loopIndex);
+    ~MatchServer();
+
+    MatchServer(const MatchServer&) = delete;
+    MatchServer& operator=(const MatchServer&) = delete;
+
+    // Opens the listening socket and event loop; false with `error` filled on failure.
+    bool listen(std::string& error);
+    // Runs until stop(); returns at once if listen() failed.
+    void run();
+    // Safe from any thread.
+    void stop();
+
+    const MatchServerStats& stats() const { return stats_; }
+
+private:
+    static constexpr std::uint32_t kNone = 0xFFFFFFFFU;
+
+    struct Connection
+    {
+        int fd = -1;
+        std::uint32_t generation = 0;
+        std::string input;
+        std::string output;
+        std::size_t outputSent = 0;
+        std::uint32_t match = kNone;
+        std::uint8_t seat = memory::kNoSeat;
+        bool flushQueued = false;
+        bool writeBlocked = false;
+    };
+
+    struct Match
+    {
+        std::uint32_t id = 0;
+        memory::BoardState board;
+        std::array<std::uint32_t, memory::kSeatCount> seats{};
+        std::array<std::uint32_t, memory::kSeatCount> ackedPick{};
+        std::array<bool, memory::kSeatCount> ackChanged{};
+        std::array<std::int32_t, memory::kSeatCount> scores{};
+        std::uint8_t turn = 0;
+        bool countersChanged = false;
+        std::vector<memory::CardState> sent; // state each card was last sent in
+        std::vector<std::int32_t> dirty;     // takeDirtyCards() target, reused
+        std::size_t activeIndex = kNotActive;
+    };
+    static constexpr std::size_t kNotActive = static_cast<std::size_t>(-1);
+
+    void acceptConnections();
+    void readConnection(std::uint32_t index);
+    bool handleFrame(std::uint32_t index, const memory::NetFrame& frame);
+    void closeConnection(std::uint32_t index);
+    void queueFlush(std::uint32_t index);
+    void flushConnections();
+    void flushConnection(std::uint32_t index);
+    void watchWrites(std::uint32_t index, bool enabled);
+
+    void joinLobby(std::uint32_t index);
+    void startMatch(std::uint32_t first, std::uint32_t second);
+    void handlePick(std::uint32_t index, const memory::NetPick& pick);
+    void activate(std::uint32_t match);
+    void deactivate(std::uint32_t match);
+    void tick();
+    void publish(Match& match);
+    void endMatch(std::uint32_t match, std::uint8_t winner, memory::NetEndReason reason);
+    void report();
+
+    MatchServerOptions options_;
+    int loopIndex_ = 0;
+    std::mt19937 random_;
+    int epoll_ = -1;
+    int listener_ = -1;
+    int timer_ = -1;
+    int wake_ = -1;
+    std::atomic<bool> stopping_{false};
+
+    std::vector<Connection> connections_;
+    std::vector<std::uint32_t> freeConnections_;
+    std::vector<std::uint32_t> flushQueue_;
+    std::vector<Match> matches_;
+    std::vector<std::uint32_t> freeMatches_;
+    std::vector<std::uint32_t> active_; // matches stepped every tick
+    std::uint32_t waiting_ = kNone;     // connection queued for the next match
+    std::uint32_t nextMatchId_ = 1;
+    std::uint32_t tick_ = 0;
+    memory::NetBoardDelta delta_;       // reused while publishing
+
+    MatchServerStats stats_;
+    MatchServerStats reported_;
+    std::uint32_t ticksSinceReport_ = 0;
+};
@@ -0,0 +1,325 @@
+#include "core/bitboard.hpp"
+#include "core/fixed_board.hpp"
+#include "core/memory_players.hpp"
+#include "core/memory_rules.hpp"
+#include "core/optimal_solver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+constexpr int kMaxMovesPerGame = 100000;
+
+struct Options
+{
+    std::uint64_t games = 100000;
+    std::uint32_t seed = 1;
+    std::string player = "random";
+    std::vector<int> script;
+    int columns = memory::kDefaultColumns;
+    int rows = memory::kDefaultRows;
+    int characters = 0; // 0: one character per pair
+    bool generic = false; // skip the compile-time cabinet boards
+    bool bitboard = false; // decision-level engine without animation timing
+};
+
+struct RunStats
+{
+    std::uint64_t finished = 0;
+    std::uint64_t totalMoves = 0;
+    int minMoves = std::numeric_limits<int>::max();
+    int maxMoves = 0;
+    double totalSeconds = 0.0;
+
+    void add(int moves, float elapsedSeconds)
+    {
+        finished += 1;
+        totalMoves += static_cast<std::uint64_t>(moves);
+        minMoves = std::min(minMoves, moves);
+        maxMoves = std::max(maxMoves, moves);
+        totalSeconds += elapsedSeconds;
+    }
+};
+
+void printUsage()
+{
+    std::cout <<
+        "Headless memory game playouts.\n"
+        "\n"
+        "Usage:\n"
+        "  memory_sim [--games N] [--seed S] [--player random|perfect|optimal|scripted] [--script i,j,...]\n"
+        "             [--board COLUMNSxROWS] [--characters N] [--generic] [--bitboard]\n"
+        "\n"
+        "4x4, 6x6 and 8x4 boards run on compile-time specialised boards unless\n"
+        "--generic is given; both engines produce identical games for a seed.\n"
+        "--bitboard plays boards of up to 64 cards on the 32-byte bitboard state,\n"
+        "which has no animation timing; the optimal player always uses it and the\n"
+        "exact expected move count is printed alongside.\n";
+}
+
+std::vector<int> parseScript(const std::string& value)
+{
+    std::vector<int> script;
+    std::istringstream stream(value);
+    std::string token;
+    while (std::getline(stream, token, ','))
+    {
+        if (!token.empty())
+        {
+            script.push_back(std::stoi(token));
+        }
+    }
+    return script;
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string_view argument = argv[index];
+        const bool hasValue = index + 1 < argc;
+
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage();
+            return false;
+        }
+        if (argument == "--games" && hasValue)
+        {
+            options.games = std::stoull(argv[++index]);
+        }
+        else if (argument == "--seed" && hasValue)
+        {
+            options.seed = static_cast<std::uint32_t>(std::stoul(argv[++index]));
+        }
+        else if (argument == "--player" && hasValue)
+        {
+            options.player = argv[++index];
+        }
+        else if (argument == "--board" && hasValue)
+        {
+            if (!memory::parseBoardSize(argv[++index], options.columns, options.rows))
+            {
+                std::cerr << "Expected --board COLUMNSxROWS, got: " << argv[index] << "\n";
+                return false;
+            }
+        }
+        else if (argument == "--characters" && hasValue)
+        {
+            if (!memory::parsePositiveInt(argv[++index], options.characters))
+            {
+                std::cerr << "Expected --characters N, got: " << argv[index] << "\n";
+                return false;
+            }
+        }
+        else if (argument == "--generic")
+        {
+            options.generic = true;
+        }
+        else if (argument == "--bitboard")
+        {
+            options.bitboard = true;
+        }
+        else if (argument == "--script" && hasValue)
+        {
+            options.script = parseScript(argv[++index]);
+            options.player = "scripted";
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option: " << argument << "\n";
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int Columns, int Rows>
+RunStats runFixed(const Options& options, bool perfectMemory, std::mt19937& random)
+{
+    memory::Board<Columns, Rows> board;
+    RunStats stats;
+    for (std::uint64_t game = 0; game < options.games; ++game)
+    {
+        if (memory::playFixedGame(board, perfectMemory, random, kMaxMovesPerGame))
+        {
+            stats.add(board.moves(), board.elapsedSeconds());
+        }
+    }
+    return stats;
+}
+
+// Picks a compile-time board for the cabinet formats; std::nullopt means the
+// runtime board has to be used.
+std::optional<RunStats> runSpecialized(const Options& options, const memory::BoardConfig& config, std::mt19937& random)
+{
+    const bool perfectMemory = options.player == "perfect";
+    if (options.generic || (!perfectMemory && options.player != "random") || config.characterCount < config.pairCount())
+    {
+        return std::nullopt;
+    }
+
+    if (config.columns == 4 && config.rows == 4)
+    {
+        return runFixed<4, 4>(options, perfectMemory, random);
+    }
+    if (config.columns == 6 && config.rows == 6)
+    {
+        return runFixed<6, 6>(options, perfectMemory, random);
+    }
+    if (config.columns == 8 && config.rows == 4)
+    {
+        return runFixed<8, 4>(options, perfectMemory, random);
+    }
+    return std::nullopt;
+}
+
+RunStats runBitboard(const Options& options, const memory::BoardConfig& config, const memory::OptimalSolver& solver, std::mt19937& random)
+{
+    memory::BitboardPlayer player = memory::BitboardPlayer::Random;
+    if (options.player == "perfect")
+    {
+        player = memory::BitboardPlayer::PerfectMemory;
+    }
+    else if (options.player == "optimal")
+    {
+        player = memory::BitboardPlayer::Optimal;
+    }
+
+    memory::BitboardState state;
+    RunStats stats;
+    for (std::uint64_t game = 0; game < options.games; ++game)
+    {
+        const memory::BitboardDeal deal = memory::dealBitboard(config.pairCount(), random);
+        if (memory::playBitboardGame(deal, state, player, random, kMaxMovesPerGame, &solver))
+        {
+            stats.add(state.moves, 0.0F);
+        }
+    }
+    return stats;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        if (!parseOptions(argc, argv, options))
+        {
+            return 1;
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "Invalid option value: " << error.what() << "\n";
+        return 1;
+    }
+
+    std::unique_ptr<memory::Player> player;
+    if (options.player == "scripted")
+    {
+        player = std::make_unique<memory::ScriptedPlayer>(options.script);
+    }
+    else if (options.player == "optimal")
+    {
+        options.bitboard = true;
+    }
+    else
+    {
+        player = memory::makePlayer(options.player);
+    }
+
+    if (!player && !options.bitboard)
+    {
+        std::cerr << "Unknown player: " << options.player << "\n";
+        return 1;
+    }
+
+    memory::BoardState board;
+    board.config.columns = options.columns;
+    board.config.rows = options.rows;
+    board.config.characterCount = options.characters > 0 ? options.characters : board.config.pairCount();
+    if (!memory::isValidConfig(board.config))
+    {
+        std::cerr << "Invalid board: " << options.columns << "x" << options.rows
+                  << " (needs an even card count, at most " << memory::kMaxBoardSide << " per side)\n";
+        return 1;
+    }
+    if (options.bitboard &&
+        (board.config.cardCount() > memory::kBitboardMaxCards || board.config.characterCount < board.config.pairCount() ||
+         options.player == "scripted"))
+    {
+        std::cerr << "--bitboard needs at most " << memory::kBitboardMaxCards
+                  << " cards, one character per pair and a random, perfect or optimal player\n";
+        return 1;
+    }
+
+    std::mt19937 random(options.seed);
+    std::optional<memory::OptimalSolver> solver;
+    if (options.bitboard)
+    {
+        solver.emplace(board.config.pairCount());
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::optional<RunStats> stats;
+    if (solver)
+    {
+        stats = runBitboard(options, board.config, *solver, random);
+    }
+    else
+    {
+        stats = runSpecialized(options, board.config, random);
+    }
+    const bool specialized = stats.has_value();
+    if (!stats)
+    {
+        stats.emplace();
+        for (std::uint64_t game = 0; game < options.games; ++game)
+        {
+            if (memory::playGame(board, *player, random, kMaxMovesPerGame))
+            {
+                stats->add(board.moves, board.elapsedSeconds);
+            }
+        }
+    }
+    const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+    const std::uint64_t finished = stats->finished;
+
+    std::cout << "player:        " << options.player << "\n";
+    std::cout << "board:         " << board.config.columns << "x" << board.config.rows << ", "
+              << board.config.characterCount << " characters ("
+              << (solver ? "bitboard" : specialized ? "compile-time board" : "runtime board") << ")\n";
+    std::cout << "games:         " << finished << " / " << options.games << " finished\n";
+    if (finished > 0)
+    {
+        std::cout << "moves:         mean " << static_cast<double>(stats->totalMoves) / static_cast<double>(finished)
+                  << ", min " << stats->minMoves << ", max " << stats->maxMoves << "\n";
+        if (!solver)
+        {
+            std::cout << "game time:     mean " << stats->totalSeconds / static_cast<double>(finished) << " s\n";
+        }
+    }
+    if (solver)
+    {
+        const int pairs = board.config.pairCount();
+        std::cout << "expected:      optimal " << solver->expectedMoves(pairs, 0)
+                  << ", perfect memory " << solver->expectedGreedyMoves(pairs, 0) << " moves\n";
+    }
+    std::cout << "throughput:    " << static_cast<double>(options.games) / std::max(wall.count(), 1.0e-9)
+              << " games/s (" << wall.count() << " s wall)\n";
+    return finished == options.games ? 0 : 2;
+}
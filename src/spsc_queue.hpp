@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded single-producer, single-consumer ring. Each side owns one index and
+// only reads the other's, so a push or pop is a pair of atomic loads and a
+// store; a push to a full ring fails instead of waiting. Capacity must be a
+// power of two.
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0U && (Capacity & (Capacity - 1U)) == 0U, "capacity must be a power of two");
+
+public:
+    // Producer.
+    bool tryPush(const T& value)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        slots_[tail & (Capacity - 1U)] = value;
+        tail_.store(tail + 1U, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer.
+    bool tryPop(T& value)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        value = slots_[head & (Capacity - 1U)];
+        head_.store(head + 1U, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // Kept on separate cache lines so the two sides do not share one.
+    static constexpr std::size_t kLine = 64U;
+
+    alignas(kLine) std::atomic<std::size_t> head_{0U};
+    alignas(kLine) std::atomic<std::size_t> tail_{0U};
+    alignas(kLine) std::array<T, Capacity> slots_{};
+};
@@ -0,0 +1,198 @@
+#include "telemetry_exporter.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <span>
+#include <system_error>
+
+namespace
+{
+constexpr std::chrono::milliseconds kFlushInterval{250};
+
+std::filesystem::path rotatedPath(const std::filesystem::path& path, unsigned int generation)
+{
+    std::filesystem::path rotated = path;
+    rotated += "." + std::to_string(generation);
+    return rotated;
+}
+} // namespace
+
+bool TelemetryExporter::start(const TelemetryOptions& options)
+{
+    options_ = options;
+    if (options_.file)
+    {
+        file_.open(*options_.file, std::ios::binary | std::ios::app);
+        if (!file_)
+        {
+            std::cerr << "Warning: cannot open telemetry file: " << options_.file->string() << "\n";
+        }
+        std::error_code error;
+        const std::uintmax_t size = std::filesystem::file_size(*options_.file, error);
+        fileBytes_ = error ? 0U : static_cast<std::size_t>(size);
+    }
+    if (options_.udpHost)
+    {
+        udpAddress_ = sf::IpAddress::resolve(*options_.udpHost);
+        if (!udpAddress_)
+        {
+            std::cerr << "Warning: cannot resolve telemetry host: " << *options_.udpHost << "\n";
+        }
+    }
+    if (!file_.is_open() && !udpAddress_)
+    {
+        return false;
+    }
+
+    std::random_device random;
+    session_ = (static_cast<std::uint64_t>(random()) << 32U) | random();
+    sessionStart_ = Clock::now();
+    queues_ = std::make_unique<Queues>();
+    pending_.reserve(kQueueCapacity * queues_->size());
+    thread_ = std::jthread([this](const std::stop_token& stopToken) { exportLoop(stopToken); });
+    std::cout << "Telemetry session " << std::hex << session_ << std::dec << "\n";
+    return true;
+}
+
+std::uint64_t TelemetryExporter::micros() const
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - sessionStart_).count());
+}
+
+void TelemetryExporter::record(TelemetryProducer producer, memory::TelemetryEventType type, std::size_t board, std::initializer_list<std::uint32_t> values)
+{
+    if (!queues_)
+    {
+        return;
+    }
+    memory::TelemetryEvent event;
+    event.micros = micros();
+    event.type = type;
+    event.board = static_cast<std::uint8_t>(board);
+    std::copy_n(values.begin(), std::min(values.size(), event.values.size()), event.values.begin());
+    record(producer, event);
+}
+
+void TelemetryExporter::record(TelemetryProducer producer, const memory::TelemetryEvent& event)
+{
+    if (!queues_)
+    {
+        return;
+    }
+    const std::size_t index = static_cast<std::size_t>(producer);
+    if (!(*queues_)[index].tryPush(event))
+    {
+        dropped_[index].fetch_add(1U, std::memory_order_relaxed);
+    }
+}
+
+void TelemetryExporter::exportLoop(const std::stop_token& stopToken)
+{
+    while (!stopToken.stop_requested())
+    {
+        {
+            std::unique_lock lock(wakeMutex_);
+            wake_.wait_for(lock, stopToken, kFlushInterval, [] { return false; });
+        }
+        drain();
+    }
+    // Whatever the producers pushed before shutdown still goes out.
+    drain();
+}
+
+void TelemetryExporter::drain()
+{
+    for (auto& queue : *queues_)
+    {
+        memory::TelemetryEvent event;
+        while (queue.tryPop(event))
+        {
+            pending_.push_back(event);
+        }
+    }
+    std::uint64_t dropped = 0;
+    for (std::atomic<std::uint64_t>& count : dropped_)
+    {
+        dropped += count.exchange(0U, std::memory_order_relaxed);
+    }
+    if (pending_.empty() && dropped == 0U)
+    {
+        return;
+    }
+
+    // Each ring is in order on its own; interleave them by time.
+    std::stable_sort(
+        pending_.begin(),
+        pending_.end(),
+        [](const memory::TelemetryEvent& left, const memory::TelemetryEvent& right) { return left.micros < right.micros; });
+
+    std::size_t offset = 0;
+    do
+    {
+        const std::size_t count = std::min(kBatchEvents, pending_.size() - offset);
+        batch_.clear();
+        memory::appendTelemetryBatch(
+            batch_,
+            memory::TelemetryBatchHeader{session_, sequence_++, offset == 0U ? dropped : 0U},
+            std::span<const memory::TelemetryEvent>(pending_.data() + offset, count));
+        write(batch_);
+        offset += count;
+    } while (offset < pending_.size());
+    pending_.clear();
+
+    if (file_.is_open())
+    {
+        file_.flush();
+    }
+}
+
+void TelemetryExporter::write(const std::string& batch)
+{
+    if (udpAddress_)
+    {
+        // Best effort, like the transport: a lost datagram is a lost batch.
+        (void)socket_.send(batch.data(), batch.size(), *udpAddress_, options_.udpPort);
+    }
+    if (!file_.is_open())
+    {
+        return;
+    }
+
+    // The file is a sequence of u32 length-prefixed batches.
+    const std::uint32_t length = static_cast<std::uint32_t>(batch.size());
+    const std::array<char, 4> prefix{
+        static_cast<char>(length & 0xFFU),
+        static_cast<char>((length >> 8U) & 0xFFU),
+        static_cast<char>((length >> 16U) & 0xFFU),
+        static_cast<char>((length >> 24U) & 0xFFU)};
+    file_.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+    file_.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+    fileBytes_ += prefix.size() + batch.size();
+    if (fileBytes_ >= options_.rotateBytes)
+    {
+        rotate();
+    }
+}
+
+void TelemetryExporter::rotate()
+{
+    const std::filesystem::path& path = *options_.file;
+    file_.close();
+    std::error_code error;
+    if (options_.keepFiles > 0U)
+    {
+        std::filesystem::remove(rotatedPath(path, options_.keepFiles), error);
+        for (unsigned int generation = options_.keepFiles; generation > 1U; --generation)
+        {
+            std::filesystem::rename(rotatedPath(path, generation - 1U), rotatedPath(path, generation), error);
+        }
+        std::filesystem::rename(path, rotatedPath(path, 1U), error);
+    }
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    fileBytes_ = 0;
+    if (!file_)
+    {
+        std::cerr << "Warning: cannot reopen telemetry file: " << path.string() << "\n";
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "core/telemetry_format.hpp"
+#include "spsc_queue.hpp"
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class TelemetryProducer : std::uint8_t
+{
+    Simulation,
+    Render,
+    Count
+};
+
+struct TelemetryOptions
+{
+    std::optional<std::filesystem::path> file;
+    // The file is rotated to file.1 (file.1 to file.2, ...) once it reaches this size.
+    std::size_t rotateBytes = 16U * 1024U * 1024U;
+    unsigned int keepFiles = 3U;
+    std::optional<std::string> udpHost;
+    unsigned short udpPort = 0;
+};
+
+// Telemetry for one session. Each producing thread has its own SPSC ring, so
+// record() is a copy into preallocated memory: it never locks, allocates or
+// touches a file, and an event that finds its ring full is dropped (and
+// counted in the next batch). A background thread wakes a few times a
+// second, batches whatever arrived and writes it out.
+class TelemetryExporter
+{
+public:
+    TelemetryExporter() = default;
+
+    TelemetryExporter(const TelemetryExporter&) = delete;
+    TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+    // Starts the export thread. False (with a warning printed) when neither
+    // destination can be opened; record() is then a no-op.
+    bool start(const TelemetryOptions& options);
+
+    bool enabled() const { return thread_.joinable(); }
+
+    // Only ever called from the thread that `producer` names.
+    void record(TelemetryProducer producer, memory::TelemetryEventType type, std::size_t board, std::initializer_list<std::uint32_t> values);
+    void record(TelemetryProducer producer, const memory::TelemetryEvent& event);
+
+    std::uint64_t micros() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t kQueueCapacity = 4096U;
+    static constexpr std::size_t kBatchEvents = 64U;
+
+    void exportLoop(const std::stop_token& stopToken);
+    void drain();
+    void write(const std::string& batch);
+    void rotate();
+
+    using Queues = std::array<SpscQueue<memory::TelemetryEvent, kQueueCapacity>, static_cast<std::size_t>(TelemetryProducer::Count)>;
+
+    Clock::time_point sessionStart_{};
+    // Heap-allocated: the rings are half a megabyte and the game object lives on the stack.
+    std::unique_ptr<Queues> queues_;
+    std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(TelemetryProducer::Count)> dropped_{};
+
+    // Export thread only.
+    TelemetryOptions options_;
+    std::uint64_t session_ = 0;
+    std::uint64_t sequence_ = 0;
+    std::vector<memory::TelemetryEvent> pending_;
+    std::string batch_;
+    std::ofstream file_;
+    std::size_t fileBytes_ = 0;
+    sf::UdpSocket socket_;
+    std::optional<sf::IpAddress> udpAddress_;
+
+    std::mutex wakeMutex_;
+    std::condition_variable_any wake_;
+    // Declared last so the thread stops before the state it uses goes away.
+    std::jthread thread_;
+};
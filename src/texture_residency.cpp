@@ -0,0 +1,124 @@
+#include "texture_residency.hpp"
+
+void TextureResidency::reset(std::size_t faceCount)
+{
+    state_.assign(faceCount, State::Absent);
+    pins_.assign(faceCount, 0U);
+    previous_.assign(faceCount, kNone);
+    next_.assign(faceCount, kNone);
+    head_ = kNone;
+    tail_ = kNone;
+    residentCount_ = 0;
+}
+
+void TextureResidency::pin(std::size_t face)
+{
+    if (pins_[face]++ == 0U && linked(face))
+    {
+        unlink(face);
+    }
+}
+
+void TextureResidency::unpin(std::size_t face)
+{
+    // Unpinned last is used most recently, so it goes to the tail.
+    if (--pins_[face] == 0U && state_[face] == State::Resident)
+    {
+        link(face);
+    }
+}
+
+void TextureResidency::setAbsent(std::size_t face)
+{
+    state_[face] = State::Absent;
+}
+
+void TextureResidency::setLoading(std::size_t face)
+{
+    state_[face] = State::Loading;
+}
+
+void TextureResidency::setResident(std::size_t face)
+{
+    if (state_[face] == State::Resident)
+    {
+        return;
+    }
+    state_[face] = State::Resident;
+    ++residentCount_;
+    if (pins_[face] == 0U)
+    {
+        link(face);
+    }
+}
+
+void TextureResidency::setFailed(std::size_t face)
+{
+    state_[face] = State::Failed;
+}
+
+std::optional<std::size_t> TextureResidency::evict()
+{
+    if (head_ == kNone)
+    {
+        return std::nullopt;
+    }
+    const std::size_t face = head_;
+    unlink(face);
+    state_[face] = State::Absent;
+    --residentCount_;
+    return face;
+}
+
+void TextureResidency::release(std::size_t face)
+{
+    if (state_[face] != State::Resident)
+    {
+        return;
+    }
+    if (linked(face))
+    {
+        unlink(face);
+    }
+    state_[face] = State::Absent;
+    --residentCount_;
+}
+
+void TextureResidency::link(std::size_t face)
+{
+    previous_[face] = tail_;
+    next_[face] = kNone;
+    if (tail_ != kNone)
+    {
+        next_[tail_] = static_cast<std::uint32_t>(face);
+    }
+    else
+    {
+        head_ = static_cast<std::uint32_t>(face);
+    }
+    tail_ = static_cast<std::uint32_t>(face);
+}
+
+void TextureResidency::unlink(std::size_t face)
+{
+    const std::uint32_t previous = previous_[face];
+    const std::uint32_t next = next_[face];
+    if (previous != kNone)
+    {
+        next_[previous] = next;
+    }
+    else
+    {
+        head_ = next;
+    }
+    if (next != kNone)
+    {
+        previous_[next] = previous;
+    }
+    else
+    {
+        tail_ = previous;
+    }
+    previous_[face] = kNone;
+    next_[face] = kNone;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Bookkeeping for which card faces hold space in the texture atlas. Faces of
+// the decks on screen (or about to be) are pinned; a face that is no longer
+// pinned keeps its space until a new face needs it, and the least recently
+// used one gives it up first. Holds no pixels: the caller owns the atlas and
+// recycles the regions of evicted faces. Every operation is O(1).
+class TextureResidency
+{
+public:
+    enum class State : std::uint8_t
+    {
+        Absent,
+        Loading,
+        Resident,
+        Failed // no art to load; not retried until the next reset()
+    };
+
+    // Forgets everything; every face starts absent and unpinned.
+    void reset(std::size_t faceCount);
+
+    State state(std::size_t face) const { return state_[face]; }
+    bool pinned(std::size_t face) const { return pins_[face] > 0U; }
+    std::size_t residentCount() const { return residentCount_; }
+
+    // Pins nest, one per deck in use that holds the face.
+    void pin(std::size_t face);
+    void unpin(std::size_t face);
+
+    // Load progress of a face that is not resident; only evict() and
+    // release() leave Resident.
+    void setAbsent(std::size_t face);
+    void setLoading(std::size_t face);
+    void setResident(std::size_t face);
+    void setFailed(std::size_t face);
+
+    // Marks the least recently used unpinned resident face absent and returns
+    // it, or std::nullopt when every resident face is pinned.
+    std::optional<std::size_t> evict();
+
+    // Marks a resident face absent whatever its place in the LRU order, e.g.
+    // when reloaded art no longer fits its region.
+    void release(std::size_t face);
+
+private:
+    static constexpr std::uint32_t kNone = 0xFFFFFFFFU;
+
+    void link(std::size_t face);
+    void unlink(std::size_t face);
+    bool linked(std::size_t face) const { return previous_[face] != kNone || head_ == face; }
+
+    std::vector<State> state_;
+    std::vector<std::uint32_t> pins_;
+    // Unpinned resident faces, least recently used at the head.
+    std::vector<std::uint32_t> previous_;
+    std::vector<std::uint32_t> next_;
+    std::uint32_t head_ = kNone;
+    std::uint32_t tail_ = kNone;
+    std::size_t residentCount_ = 0;
+};
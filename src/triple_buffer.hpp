@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Single-producer, single-consumer triple buffer. The producer always owns a
+// slot to write and the consumer a slot to read; handing one over is a single
+// atomic exchange, so neither side ever waits for the other. The consumer
+// only ever sees the newest published value and silently skips older ones.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Producer: the slot being written, and its index (stable until publish()).
+    T& back() { return slots_[back_]; }
+    std::size_t backIndex() const { return back_; }
+
+    // Producer: makes back() the newest value and takes a fresh slot to write.
+    // Returns false when the value it replaces was never acquired.
+    bool publish()
+    {
+        const std::uint8_t previous = middle_.exchange(static_cast<std::uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+        back_ = static_cast<std::uint8_t>(previous & kIndexMask);
+        published_.fetch_add(1U, std::memory_order_release);
+        published_.notify_one();
+        return (previous & kFresh) == 0U;
+    }
+
+    // Consumer: switches front() to the newest value; false when nothing was
+    // published since the last acquire.
+    bool acquire()
+    {
+        if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0U)
+        {
+            return false;
+        }
+        front_ = static_cast<std::uint8_t>(middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask);
+        return true;
+    }
+
+    const T& front() const { return slots_[front_]; }
+
+    // Consumer: read publishCount() before a failed acquire(), then block in
+    // waitForPublish() until the count moves on, so a publish in between is
+    // never missed. wake() releases a waiting consumer without publishing.
+    std::uint64_t publishCount() const { return published_.load(std::memory_order_acquire); }
+    void waitForPublish(std::uint64_t seen) const { published_.wait(seen, std::memory_order_acquire); }
+    void wake()
+    {
+        published_.fetch_add(1U, std::memory_order_release);
+        published_.notify_all();
+    }
+
+private:
+    static constexpr std::uint8_t kIndexMask = 0x3U;
+    static constexpr std::uint8_t kFresh = 0x4U;
+
+    std::array<T, 3> slots_{};
+    std::uint8_t back_ = 0U;
+    std::uint8_t front_ = 1U;
+    std::atomic<std::uint8_t> middle_{2U};
+    std::atomic<std::uint64_t> published_{0U};
+};
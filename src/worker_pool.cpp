@@ -0,0 +1,94 @@
+#include "worker_pool.hpp"
+
+namespace
+{
+constexpr std::uint64_t kIndexMask = 0xFFFFFFFFU;
+
+std::uint64_t makeTicket(std::size_t count, std::size_t index)
+{
+    return (static_cast<std::uint64_t>(count) << 32U) | static_cast<std::uint64_t>(index);
+}
+} // namespace
+
+WorkerPool::WorkerPool(std::size_t threadCount)
+{
+    threads_.reserve(threadCount);
+    for (std::size_t index = 0; index < threadCount; ++index)
+    {
+        threads_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    stopping_.store(true, std::memory_order_release);
+    generation_.fetch_add(1U, std::memory_order_release);
+    generation_.notify_all();
+    for (std::thread& thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+void WorkerPool::dispatch(std::size_t count, Invoke invoke, void* context)
+{
+    if (count == 0U)
+    {
+        return;
+    }
+
+    // The previous run has fully finished, so no worker reads these now; the
+    // release store of the ticket publishes them to whoever claims an index.
+    invoke_ = invoke;
+    context_ = context;
+    remaining_.store(count, std::memory_order_relaxed);
+    ticket_.store(makeTicket(count, 0U), std::memory_order_release);
+    generation_.fetch_add(1U, std::memory_order_release);
+    generation_.notify_all();
+
+    work();
+    for (std::size_t left = remaining_.load(std::memory_order_acquire); left != 0U; left = remaining_.load(std::memory_order_acquire))
+    {
+        remaining_.wait(left, std::memory_order_acquire);
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    std::uint32_t seen = generation_.load(std::memory_order_acquire);
+    for (;;)
+    {
+        generation_.wait(seen, std::memory_order_acquire);
+        seen = generation_.load(std::memory_order_acquire);
+        if (stopping_.load(std::memory_order_acquire))
+        {
+            return;
+        }
+        work();
+    }
+}
+
+void WorkerPool::work()
+{
+    std::uint64_t ticket = ticket_.load(std::memory_order_acquire);
+    for (;;)
+    {
+        const std::size_t count = static_cast<std::size_t>(ticket >> 32U);
+        const std::size_t index = static_cast<std::size_t>(ticket & kIndexMask);
+        if (index >= count)
+        {
+            return;
+        }
+        if (!ticket_.compare_exchange_weak(ticket, ticket + 1U, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            continue;
+        }
+
+        invoke_(context_, index);
+        if (remaining_.fetch_sub(1U, std::memory_order_acq_rel) == 1U)
+        {
+            remaining_.notify_one();
+        }
+        ticket = ticket_.load(std::memory_order_acquire);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// A fixed set of threads that run one indexed job at a time; the kiosk mode
+// spreads its per-board ticks over it. The calling thread works too, and
+// run() returns once every index is done. Indices are claimed from a single
+// atomic ticket, idle workers block in an atomic wait, and nothing is
+// allocated per run, so a tick costs a wake-up rather than a thread start.
+class WorkerPool
+{
+public:
+    explicit WorkerPool(std::size_t threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Calls job(index) once for every index in [0, count), in any order and
+    // on any thread; `job` must outlive the call.
+    template <typename Job>
+    void run(std::size_t count, Job& job)
+    {
+        dispatch(count, [](void* context, std::size_t index) { (*static_cast<Job*>(context))(index); }, &job);
+    }
+
+    std::size_t threadCount() const { return threads_.size(); }
+
+private:
+    using Invoke = void (*)(void*, std::size_t);
+
+    void dispatch(std::size_t count, Invoke invoke, void* context);
+    void workerLoop();
+    void work();
+
+    // Job count in the high half, next unclaimed index in the low half. A
+    // claim is a compare-exchange on both, so a worker still holding an old
+    // ticket can only ever claim an index that is genuinely unclaimed.
+    std::atomic<std::uint64_t> ticket_{0};
+    std::atomic<std::size_t> remaining_{0};
+    Invoke invoke_ = nullptr;
+    void* context_ = nullptr;
+
+    std::atomic<std::uint32_t> generation_{0};
+    std::atomic<bool> stopping_{false};
+    std::vector<std::thread> threads_;
+};